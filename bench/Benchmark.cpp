@@ -0,0 +1,116 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include <cassert>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace NetworkAnalyticalBench;
+
+namespace {
+
+/**
+ * Quote a string as a JSON string literal.
+ * Names and parameters are plain identifiers and numbers, so only quotes and backslashes are escaped.
+ */
+std::string quote(const std::string& value) noexcept {
+    auto quoted = std::string("\"");
+    for (const auto character : value) {
+        if (character == '"' || character == '\\') {
+            quoted += '\\';
+        }
+        quoted += character;
+    }
+    quoted += "\"";
+
+    return quoted;
+}
+
+}  // namespace
+
+BenchmarkSuite::BenchmarkSuite(std::string filter) noexcept : filter(std::move(filter)) {
+    results = {};
+}
+
+void BenchmarkSuite::run(const std::string& name,
+                         const std::map<std::string, std::string>& params,
+                         const std::string& unit,
+                         const BenchmarkBody& body,
+                         const double min_seconds) noexcept {
+    assert(body != nullptr);
+    assert(min_seconds >= 0);
+
+    // skip filtered out benchmarks
+    if (name.find(filter) == std::string::npos) {
+        return;
+    }
+
+    // repeat the body until it takes long enough
+    auto operations_count = static_cast<uint64_t>(0);
+    auto seconds = 0.0;
+    do {
+        const auto start = std::chrono::steady_clock::now();
+        operations_count += body();
+        const auto end = std::chrono::steady_clock::now();
+        seconds += std::chrono::duration<double>(end - start).count();
+    } while (seconds < min_seconds);
+
+    // record the result
+    auto result = BenchmarkResult{name, params, unit, operations_count, seconds, peak_rss_kib()};
+    results.push_back(result);
+
+    // report the progress
+    std::cerr << name;
+    for (const auto& [key, value] : params) {
+        std::cerr << " " << key << "=" << value;
+    }
+    std::cerr << ": " << (seconds * 1e9 / operations_count) << " ns/" << unit << std::endl;
+}
+
+void BenchmarkSuite::write_json(std::ostream& output) const noexcept {
+    output << std::setprecision(6);
+    output << "{\n";
+    output << "  \"benchmarks\": [\n";
+    for (auto i = static_cast<size_t>(0); i < results.size(); i++) {
+        const auto& result = results[i];
+        const auto operations_count = static_cast<double>(result.operations_count);
+
+        output << "    {";
+        output << "\"name\": " << quote(result.name) << ", ";
+        output << "\"params\": {";
+        auto first_param = true;
+        for (const auto& [key, value] : result.params) {
+            output << (first_param ? "" : ", ") << quote(key) << ": " << quote(value);
+            first_param = false;
+        }
+        output << "}, ";
+        output << "\"unit\": " << quote(result.unit) << ", ";
+        output << "\"operations\": " << result.operations_count << ", ";
+        output << "\"seconds\": " << result.seconds << ", ";
+        output << "\"operations_per_sec\": " << (operations_count / result.seconds) << ", ";
+        output << "\"ns_per_operation\": " << (result.seconds * 1e9 / operations_count) << ", ";
+        output << "\"peak_rss_kib\": " << result.peak_rss_kib;
+        output << "}" << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+    output << "  ],\n";
+    output << "  \"peak_rss_kib\": " << peak_rss_kib() << "\n";
+    output << "}" << std::endl;
+}
+
+uint64_t BenchmarkSuite::peak_rss_kib() noexcept {
+    auto usage = rusage();
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    // macOS reports in bytes
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1'024;
+#else
+    // Linux reports in KiB
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace NetworkAnalyticalBench {
+
+/**
+ * BenchmarkResult is the measurement of a single benchmark run.
+ */
+struct BenchmarkResult {
+    /// name of the benchmark, e.g., "event_queue"
+    std::string name;
+
+    /// parameters of the run, e.g., {"engine": "LadderQueue"}
+    std::map<std::string, std::string> params;
+
+    /// what a single operation is, e.g., "event", "hop", "route"
+    std::string unit;
+
+    /// number of operations performed
+    uint64_t operations_count;
+
+    /// wall-clock time of the run in seconds
+    double seconds;
+
+    /// peak resident set size of the process after the run, in KiB
+    uint64_t peak_rss_kib;
+};
+
+/**
+ * BenchmarkSuite times registered benchmarks and reports them as JSON.
+ */
+class BenchmarkSuite {
+  public:
+    /// Runs a benchmark once, returning the number of operations it performed
+    using BenchmarkBody = std::function<uint64_t()>;
+
+    /**
+     * Constructor.
+     *
+     * @param filter only benchmarks whose name contains this string are run
+     */
+    explicit BenchmarkSuite(std::string filter) noexcept;
+
+    /**
+     * Time a benchmark, if it passes the filter.
+     * The body is run repeatedly until it has taken at least min_seconds in total,
+     * so that short benchmarks are still measured accurately.
+     *
+     * @param name name of the benchmark
+     * @param params parameters of the run
+     * @param unit what a single operation is
+     * @param body benchmark body
+     * @param min_seconds minimum total time to run the body for
+     */
+    void run(const std::string& name,
+             const std::map<std::string, std::string>& params,
+             const std::string& unit,
+             const BenchmarkBody& body,
+             double min_seconds = 0.2) noexcept;
+
+    /**
+     * Write every result as a JSON document.
+     *
+     * @param output stream to write to
+     */
+    void write_json(std::ostream& output) const noexcept;
+
+    /**
+     * Get the peak resident set size of the process so far.
+     *
+     * @return peak resident set size in KiB
+     */
+    [[nodiscard]] static uint64_t peak_rss_kib() noexcept;
+
+  private:
+    /// only benchmarks whose name contains this string are run
+    std::string filter;
+
+    /// results of the benchmarks run so far
+    std::vector<BenchmarkResult> results;
+};
+
+}  // namespace NetworkAnalyticalBench
@@ -0,0 +1,546 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_aware/ParallelSimulation.h"
+#include "congestion_unaware/Helper.h"
+#include "congestion_unaware/StaticMultiDimTopology.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalBench;
+
+namespace {
+
+/// chunk size used by the congestion aware benchmarks
+constexpr ChunkSize chunk_size = 1'048'576;  // 1 MB
+
+/**
+ * Build a NetworkParser of the given network, e.g., ("Ring_Switch", "16_8").
+ */
+NetworkParser make_network(const std::vector<std::string>& topologies, const std::vector<int>& npus_counts) noexcept {
+    auto network_config = YAML::Node();
+    for (auto dim = static_cast<size_t>(0); dim < topologies.size(); dim++) {
+        network_config["topology"].push_back(topologies[dim]);
+        network_config["npus_count"].push_back(npus_counts[dim]);
+        network_config["bandwidth"].push_back(50.0);
+        network_config["latency"].push_back(500.0);
+    }
+
+    return NetworkParser(network_config);
+}
+
+/**
+ * Name of an event queue engine.
+ */
+std::string engine_name(const EventQueueEngineType engine_type) noexcept {
+    switch (engine_type) {
+    case EventQueueEngineType::BinaryHeap:
+        return "BinaryHeap";
+    case EventQueueEngineType::QuaternaryHeap:
+        return "QuaternaryHeap";
+    case EventQueueEngineType::CalendarQueue:
+        return "CalendarQueue";
+    case EventQueueEngineType::LadderQueue:
+        return "LadderQueue";
+    default:
+        return "Unknown";
+    }
+}
+
+/// timestamp distributions of the event queue benchmark
+enum class Distribution { Uniform, Exponential, Bimodal, Discrete };
+
+/**
+ * Name of a timestamp distribution.
+ */
+std::string distribution_name(const Distribution distribution) noexcept {
+    switch (distribution) {
+    case Distribution::Uniform:
+        return "uniform";
+    case Distribution::Exponential:
+        return "exponential";
+    case Distribution::Bimodal:
+        return "bimodal";
+    case Distribution::Discrete:
+        return "discrete";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * HoldModel is the classic priority queue benchmark:
+ * every invoked event schedules a new one at a random delay, keeping the number of pending events constant.
+ */
+struct HoldModel {
+    /// event queue to benchmark
+    EventQueue* event_queue;
+
+    /// timestamp distribution
+    Distribution distribution;
+
+    /// random number generator
+    std::mt19937_64 rng;
+
+    /// number of events still to be rescheduled
+    uint64_t remaining_events_count;
+
+    /**
+     * Draw the delay of the next event, with a mean of about 1000 ns.
+     */
+    EventTime next_delay() noexcept {
+        if (distribution == Distribution::Uniform) {
+            return std::uniform_int_distribution<EventTime>(0, 2'000)(rng);
+        }
+        if (distribution == Distribution::Exponential) {
+            return static_cast<EventTime>(std::exponential_distribution<double>(1.0 / 1'000)(rng));
+        }
+        if (distribution == Distribution::Bimodal) {
+            // mostly near-future events, with occasional far-future ones
+            if (std::uniform_int_distribution<int>(0, 9)(rng) == 0) {
+                return std::uniform_int_distribution<EventTime>(9'000, 11'000)(rng);
+            }
+            return std::uniform_int_distribution<EventTime>(0, 100)(rng);
+        }
+
+        // discrete: many events share the same timestamp
+        return std::uniform_int_distribution<EventTime>(0, 4)(rng) * 500;
+    }
+
+    /**
+     * Event callback: reschedule itself.
+     */
+    static void hold(void* const hold_model_ptr) noexcept {
+        auto* const hold_model = static_cast<HoldModel*>(hold_model_ptr);
+        if (hold_model->remaining_events_count == 0) {
+            return;
+        }
+        hold_model->remaining_events_count--;
+
+        auto* const event_queue = hold_model->event_queue;
+        const auto event_time = event_queue->get_current_time() + hold_model->next_delay();
+        event_queue->schedule_event(event_time, hold, hold_model_ptr);
+    }
+};
+
+/**
+ * ChainedFlow sends a series of chunks, each one after the previous one has arrived.
+ *  - all_gather: the ring algorithm, where the chunk of NPU src is forwarded to the next NPU at every step.
+ *  - all_to_all: the pairwise exchange, where NPU src sends to src+1, src+2, ... in turn.
+ */
+struct ChainedFlow {
+    /// topology to send the chunks over
+    NetworkAnalyticalCongestionAware::Topology* topology;
+
+    /// true for all_gather, false for all_to_all
+    bool all_gather;
+
+    /// NPU the flow belongs to
+    int src;
+
+    /// current step of the flow
+    int step;
+
+    /**
+     * Send the chunk of the current step.
+     */
+    void send() noexcept {
+        const auto npus_count = topology->get_npus_count();
+        const auto from = all_gather ? (src + step) % npus_count : src;
+        const auto to = (src + step + 1) % npus_count;
+
+        auto route = topology->shared_route(from, to);
+        topology->send(topology->create_chunk(chunk_size, std::move(route), chunk_arrived, this));
+    }
+
+    /**
+     * Chunk arrival callback: proceed to the next step.
+     */
+    static void chunk_arrived(void* const flow_ptr) noexcept {
+        auto* const flow = static_cast<ChainedFlow*>(flow_ptr);
+        flow->step++;
+        if (flow->step < flow->topology->get_npus_count() - 1) {
+            flow->send();
+        }
+    }
+};
+
+/**
+ * No-op chunk arrival callback.
+ */
+void chunk_arrived(void* const) noexcept {}
+
+/**
+ * EventQueue schedule/proceed throughput per engine and timestamp distribution.
+ */
+void bench_event_queue(BenchmarkSuite& suite) noexcept {
+    for (const auto engine_type : {EventQueueEngineType::BinaryHeap, EventQueueEngineType::QuaternaryHeap,
+                                   EventQueueEngineType::CalendarQueue, EventQueueEngineType::LadderQueue}) {
+        for (const auto distribution :
+             {Distribution::Uniform, Distribution::Exponential, Distribution::Bimodal, Distribution::Discrete}) {
+            for (const auto pending_events_count : {1'000, 100'000}) {
+                const auto params = std::map<std::string, std::string>{
+                    {"engine", engine_name(engine_type)},
+                    {"distribution", distribution_name(distribution)},
+                    {"pending_events", std::to_string(pending_events_count)},
+                };
+
+                suite.run("event_queue", params, "event", [&]() -> uint64_t {
+                    auto event_queue = EventQueue(engine_type);
+                    auto hold_model = HoldModel{&event_queue, distribution, std::mt19937_64(0), 1'000'000};
+
+                    // initial pending events
+                    for (auto i = 0; i < pending_events_count; i++) {
+                        event_queue.schedule_event(hold_model.next_delay(), HoldModel::hold, &hold_model);
+                    }
+
+                    while (!event_queue.finished()) {
+                        event_queue.proceed();
+                    }
+
+                    return event_queue.get_scheduled_events_count();
+                });
+            }
+        }
+    }
+}
+
+/**
+ * Per-hop cost of Link and Device: every NPU of a 64-NPU ring sends chunks halfway around the ring.
+ */
+void bench_link_hop(BenchmarkSuite& suite) noexcept {
+    using namespace NetworkAnalyticalCongestionAware;
+
+    for (const auto link_mode : {LinkMode::LinkFreeEvent, LinkMode::BusyUntil}) {
+        const auto params = std::map<std::string, std::string>{
+            {"topology", "Ring"},
+            {"npus_count", "64"},
+            {"link_mode", (link_mode == LinkMode::BusyUntil) ? "BusyUntil" : "LinkFreeEvent"},
+        };
+
+        suite.run("link_hop", params, "hop", [&]() -> uint64_t {
+            const auto event_queue = std::make_shared<EventQueue>();
+            const auto topology = construct_topology(make_network({"Ring"}, {64}));
+            topology->set_event_queue(event_queue);
+            topology->set_link_mode(link_mode);
+
+            // 32 hops per chunk
+            auto hops_count = static_cast<uint64_t>(0);
+            for (auto round = 0; round < 16; round++) {
+                for (auto src = 0; src < 64; src++) {
+                    auto route = topology->shared_route(src, (src + 32) % 64);
+                    hops_count += route->links.size();
+                    topology->send(topology->create_chunk(chunk_size, std::move(route), chunk_arrived, nullptr));
+                }
+            }
+
+            while (!event_queue->finished()) {
+                event_queue->proceed();
+            }
+
+            return hops_count;
+        });
+    }
+}
+
+/**
+ * route() and shared_route() cost per congestion aware topology.
+ */
+void bench_route(BenchmarkSuite& suite) noexcept {
+    using namespace NetworkAnalyticalCongestionAware;
+
+    for (const auto* const topology_name : {"Ring", "FullyConnected", "Switch"}) {
+        const auto topology = construct_topology(make_network({topology_name}, {1'024}));
+
+        // random pairs
+        auto rng = std::mt19937(0);
+        auto npu = std::uniform_int_distribution<int>(0, 1'023);
+        auto pairs = std::vector<std::pair<int, int>>();
+        while (pairs.size() < 4'096) {
+            const auto src = npu(rng);
+            const auto dest = npu(rng);
+            if (src != dest) {
+                pairs.emplace_back(src, dest);
+            }
+        }
+
+        for (const auto shared : {false, true}) {
+            const auto params = std::map<std::string, std::string>{
+                {"topology", topology_name},
+                {"npus_count", "1024"},
+                {"method", shared ? "shared_route" : "route"},
+            };
+
+            suite.run("route", params, "route", [&]() -> uint64_t {
+                auto devices_count = static_cast<size_t>(0);
+                for (const auto& [src, dest] : pairs) {
+                    if (shared) {
+                        devices_count += topology->shared_route(src, dest)->devices.size();
+                    } else {
+                        devices_count += topology->route(src, dest).size();
+                    }
+                }
+
+                // keep the routes from being optimized away
+                if (devices_count == 0) {
+                    std::abort();
+                }
+                return pairs.size();
+            });
+        }
+    }
+}
+
+/**
+ * Congestion unaware MultiDimTopology::send throughput.
+ */
+void bench_multi_dim_send(BenchmarkSuite& suite) noexcept {
+    using namespace NetworkAnalyticalCongestionUnaware;
+
+    const auto topologies = std::vector<std::string>{"Ring", "FullyConnected", "Switch"};
+    const auto npus_counts = std::vector<int>{16, 16, 16};
+    const auto network_parser = make_network(topologies, npus_counts);
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    const auto params = std::map<std::string, std::string>{
+        {"topology", "Ring_FullyConnected_Switch"},
+        {"npus_count", std::to_string(npus_count)},
+    };
+
+    suite.run("multi_dim_send", params, "send", [&]() -> uint64_t {
+        auto rng = std::mt19937(0);
+        auto npu = std::uniform_int_distribution<int>(0, npus_count - 1);
+
+        auto total_delay = static_cast<EventTime>(0);
+        auto sends_count = static_cast<uint64_t>(0);
+        for (auto i = 0; i < 1'000'000; i++) {
+            const auto src = npu(rng);
+            const auto dest = npu(rng);
+            if (src != dest) {
+                total_delay += topology->send(src, dest, chunk_size);
+                sends_count++;
+            }
+        }
+
+        // keep the sends from being optimized away
+        if (total_delay == 0) {
+            std::abort();
+        }
+        return sends_count;
+    });
+
+    // the same kind of sends, batched
+    auto rng = std::mt19937(0);
+    auto npu = std::uniform_int_distribution<int>(0, npus_count - 1);
+    auto srcs = std::vector<DeviceId>();
+    auto dests = std::vector<DeviceId>();
+    while (srcs.size() < 1'000'000) {
+        const auto src = npu(rng);
+        const auto dest = npu(rng);
+        if (src != dest) {
+            srcs.push_back(src);
+            dests.push_back(dest);
+        }
+    }
+    const auto chunk_sizes = std::vector<ChunkSize>(srcs.size(), chunk_size);
+    auto comm_delays = std::vector<EventTime>(srcs.size());
+
+    suite.run("multi_dim_send_batch", params, "send", [&]() -> uint64_t {
+        topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), comm_delays.data(), srcs.size());
+
+        // keep the sends from being optimized away
+        if (comm_delays.back() == 0) {
+            std::abort();
+        }
+        return srcs.size();
+    });
+
+    // the same batch, sent one by one through the matching StaticMultiDimTopology
+    const auto visited = visit_static_topology(network_parser, [&](const auto& static_topology) {
+        suite.run("multi_dim_send_static", params, "send", [&]() -> uint64_t {
+            for (auto i = static_cast<size_t>(0); i < srcs.size(); i++) {
+                comm_delays[i] = static_topology.send(srcs[i], dests[i], chunk_sizes[i]);
+            }
+
+            // keep the sends from being optimized away
+            if (comm_delays.back() == 0) {
+                std::abort();
+            }
+            return srcs.size();
+        });
+    });
+    if (!visited) {
+        std::abort();
+    }
+}
+
+/**
+ * End-to-end congestion aware collectives.
+ */
+void bench_collectives(BenchmarkSuite& suite, const int max_npus_count) noexcept {
+    using namespace NetworkAnalyticalCongestionAware;
+
+    // (collective, topology)
+    const auto collectives = std::vector<std::pair<std::string, std::string>>{
+        {"all_gather", "Ring"},
+        {"all_to_all", "Switch"},
+        {"all_to_all", "FullyConnected"},
+    };
+
+    for (const auto& [collective, topology_name] : collectives) {
+        for (auto npus_count = 64; npus_count <= max_npus_count; npus_count *= 2) {
+            const auto params = std::map<std::string, std::string>{
+                {"collective", collective},
+                {"topology", topology_name},
+                {"npus_count", std::to_string(npus_count)},
+            };
+
+            suite.run(
+                "collective", params, "event",
+                [&]() -> uint64_t {
+                    const auto event_queue = std::make_shared<EventQueue>();
+                    const auto topology = construct_topology(make_network({topology_name}, {npus_count}));
+                    topology->set_event_queue(event_queue);
+                    topology->set_link_mode(LinkMode::BusyUntil);
+
+                    // every NPU starts its flow
+                    auto flows = std::vector<ChainedFlow>();
+                    for (auto src = 0; src < npus_count; src++) {
+                        flows.push_back(ChainedFlow{topology.get(), collective == "all_gather", src, 0});
+                    }
+                    for (auto& flow : flows) {
+                        flow.send();
+                    }
+
+                    while (!event_queue->finished()) {
+                        event_queue->proceed();
+                    }
+
+                    return event_queue->get_scheduled_events_count();
+                },
+                0.0);
+        }
+    }
+}
+
+/**
+ * Congestion aware All-to-All, sequential (0 partitions) and over each number of partitions up to the cores count.
+ */
+void bench_parallel_simulation(BenchmarkSuite& suite) noexcept {
+    using namespace NetworkAnalyticalCongestionAware;
+
+    const auto npus_count = 256;
+    const auto cores_count = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1U));
+    auto partitions_counts = std::vector<int>{0};
+    for (auto partitions_count = 1; partitions_count <= cores_count; partitions_count *= 2) {
+        partitions_counts.push_back(partitions_count);
+    }
+
+    for (const auto partitions_count : partitions_counts) {
+        const auto params = std::map<std::string, std::string>{
+            {"topology", "FullyConnected"},
+            {"npus_count", std::to_string(npus_count)},
+            {"partitions_count", std::to_string(partitions_count)},
+        };
+
+        suite.run(
+            "parallel_simulation", params, "chunk",
+            [&]() -> uint64_t {
+                const auto topology = construct_topology(make_network({"FullyConnected"}, {npus_count}));
+                const auto event_queue = std::make_shared<EventQueue>();
+                auto parallel_simulation = std::unique_ptr<ParallelSimulation>();
+                if (partitions_count == 0) {
+                    topology->set_event_queue(event_queue);
+                } else {
+                    parallel_simulation = std::make_unique<ParallelSimulation>(topology, partitions_count);
+                }
+
+                // every NPU sends a chunk to every other NPU
+                auto chunks_count = static_cast<uint64_t>(0);
+                for (auto src = 0; src < npus_count; src++) {
+                    for (auto dest = 0; dest < npus_count; dest++) {
+                        if (src != dest) {
+                            topology->send(std::make_unique<Chunk>(chunk_size, topology->shared_route(src, dest),
+                                                                   chunk_arrived, nullptr));
+                            chunks_count++;
+                        }
+                    }
+                }
+
+                if (partitions_count == 0) {
+                    while (!event_queue->finished()) {
+                        event_queue->proceed();
+                    }
+                } else {
+                    parallel_simulation->run();
+                }
+                return chunks_count;
+            },
+            0.0);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    // parse arguments
+    auto filter = std::string();
+    auto max_npus_count = 1'024;
+    auto output_path = std::string();
+    for (auto i = 1; i < argc; i++) {
+        const auto argument = std::string(argv[i]);
+        if (argument == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (argument == "--max-npus" && i + 1 < argc) {
+            max_npus_count = std::atoi(argv[++i]);
+        } else if (argument == "--output" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <name>] [--max-npus <64-8192>] [--output <result.json>]"
+                      << std::endl;
+            return -1;
+        }
+    }
+
+    // run benchmarks
+    auto suite = BenchmarkSuite(filter);
+    bench_event_queue(suite);
+    bench_link_hop(suite);
+    bench_route(suite);
+    bench_multi_dim_send(suite);
+    bench_collectives(suite, max_npus_count);
+    bench_parallel_simulation(suite);
+
+    // report results
+    if (output_path.empty()) {
+        suite.write_json(std::cout);
+        return 0;
+    }
+    auto output = std::ofstream(output_path);
+    if (!output.is_open()) {
+        std::cerr << "[Error] (network/analytical) " << "failed to open " << output_path << std::endl;
+        return -1;
+    }
+    suite.write_json(output);
+
+    // terminate
+    return 0;
+}
@@ -0,0 +1,214 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/CalendarQueueEngine.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// minimum number of buckets of a calendar
+constexpr size_t min_buckets_count = 2;
+
+/// maximum number of earliest events sampled to estimate the bucket width
+constexpr size_t width_samples_count = 25;
+
+}  // namespace
+
+CalendarQueueEngine::CalendarQueueEngine() noexcept
+    : bucket_width(1),
+      current_bucket(0),
+      current_bucket_end(1),
+      events_count(0) {
+    // create an empty calendar
+    buckets = std::vector<Bucket>(min_buckets_count, Bucket{nullptr, nullptr});
+    resize_buffer = std::vector<ScheduledEvent*>();
+}
+
+void CalendarQueueEngine::push(ScheduledEvent* const event) noexcept {
+    assert(event != nullptr);
+
+    // if the event is earlier than the current scan position
+    // (or the calendar was empty), rewind the scan position to the event
+    const auto current_bucket_start = current_bucket_end - bucket_width;
+    if (events_count == 0 || event->event_time < current_bucket_start) {
+        move_to(event->event_time);
+    }
+
+    // insert the event
+    insert(event);
+    events_count++;
+
+    // grow the calendar if it's too crowded
+    if (events_count > 2 * buckets.size()) {
+        resize(2 * buckets.size());
+    }
+}
+
+ScheduledEvent* CalendarQueueEngine::pop() noexcept {
+    // calendar should not be empty
+    assert(!empty());
+
+    // find the earliest event
+    locate_earliest_event();
+
+    // extract it
+    auto& bucket = buckets[current_bucket];
+    auto* const earliest_event = bucket.head;
+    bucket.head = earliest_event->next;
+    if (bucket.head == nullptr) {
+        bucket.tail = nullptr;
+    }
+    events_count--;
+
+    // shrink the calendar if it's too sparse
+    if (buckets.size() > min_buckets_count && events_count < buckets.size() / 2) {
+        resize(buckets.size() / 2);
+    }
+
+    return earliest_event;
+}
+
+EventTime CalendarQueueEngine::next_event_time() noexcept {
+    // calendar should not be empty
+    assert(!empty());
+
+    // find the earliest event
+    locate_earliest_event();
+
+    return buckets[current_bucket].head->event_time;
+}
+
+bool CalendarQueueEngine::empty() const noexcept {
+    return events_count == 0;
+}
+
+size_t CalendarQueueEngine::bucket_index(const EventTime event_time) const noexcept {
+    return static_cast<size_t>((event_time / bucket_width) % buckets.size());
+}
+
+void CalendarQueueEngine::move_to(const EventTime event_time) noexcept {
+    current_bucket = bucket_index(event_time);
+    current_bucket_end = ((event_time / bucket_width) + 1) * bucket_width;
+}
+
+void CalendarQueueEngine::insert(ScheduledEvent* const event) noexcept {
+    auto& bucket = buckets[bucket_index(event->event_time)];
+
+    // empty bucket
+    if (bucket.head == nullptr) {
+        event->next = nullptr;
+        bucket.head = event;
+        bucket.tail = event;
+        return;
+    }
+
+    // newly scheduled events are usually the latest ones: append
+    if (!event->precedes(*bucket.tail)) {
+        event->next = nullptr;
+        bucket.tail->next = event;
+        bucket.tail = event;
+        return;
+    }
+
+    // new earliest event of the bucket
+    if (event->precedes(*bucket.head)) {
+        event->next = bucket.head;
+        bucket.head = event;
+        return;
+    }
+
+    // otherwise, search for the insertion point
+    auto* previous = bucket.head;
+    while (!event->precedes(*previous->next)) {
+        previous = previous->next;
+    }
+    event->next = previous->next;
+    previous->next = event;
+}
+
+void CalendarQueueEngine::locate_earliest_event() noexcept {
+    assert(!empty());
+
+    // scan a year of days from the current one
+    for (auto i = static_cast<size_t>(0); i < buckets.size(); i++) {
+        const auto* const head = buckets[current_bucket].head;
+        if (head != nullptr && head->event_time < current_bucket_end) {
+            // the earliest event is in this day of the current year
+            return;
+        }
+
+        // move to the next day
+        current_bucket = (current_bucket + 1) % buckets.size();
+        current_bucket_end += bucket_width;
+    }
+
+    // every pending event is more than a year ahead:
+    // directly search for the earliest bucket head
+    const ScheduledEvent* earliest_event = nullptr;
+    for (const auto& bucket : buckets) {
+        if (bucket.head != nullptr && (earliest_event == nullptr || bucket.head->precedes(*earliest_event))) {
+            earliest_event = bucket.head;
+        }
+    }
+
+    assert(earliest_event != nullptr);
+    move_to(earliest_event->event_time);
+}
+
+void CalendarQueueEngine::resize(const size_t buckets_count) noexcept {
+    assert(buckets_count >= min_buckets_count);
+
+    // drain every event, in order
+    resize_buffer.clear();
+    for (const auto& bucket : buckets) {
+        for (auto* event = bucket.head; event != nullptr; event = event->next) {
+            resize_buffer.push_back(event);
+        }
+    }
+    std::sort(resize_buffer.begin(), resize_buffer.end(),
+              [](const ScheduledEvent* const a, const ScheduledEvent* const b) { return a->precedes(*b); });
+
+    // estimate the bucket width from the average spacing of the earliest events,
+    // ignoring outlying gaps larger than twice the average
+    const auto samples_count = std::min(resize_buffer.size(), width_samples_count);
+    if (samples_count >= 2) {
+        const auto span = resize_buffer[samples_count - 1]->event_time - resize_buffer[0]->event_time;
+        const auto average_gap = span / (samples_count - 1);
+
+        auto trimmed_span = static_cast<EventTime>(0);
+        auto trimmed_gaps_count = static_cast<EventTime>(0);
+        for (auto i = static_cast<size_t>(1); i < samples_count; i++) {
+            const auto gap = resize_buffer[i]->event_time - resize_buffer[i - 1]->event_time;
+            if (gap <= 2 * average_gap) {
+                trimmed_span += gap;
+                trimmed_gaps_count++;
+            }
+        }
+
+        const auto trimmed_average_gap = (trimmed_gaps_count > 0) ? (trimmed_span / trimmed_gaps_count) : 0;
+        bucket_width = std::max(static_cast<EventTime>(1), 3 * trimmed_average_gap);
+    }
+
+    // rebuild the calendar: events are in order, so appending keeps the buckets sorted
+    buckets.assign(buckets_count, Bucket{nullptr, nullptr});
+    for (auto* const event : resize_buffer) {
+        auto& bucket = buckets[bucket_index(event->event_time)];
+        event->next = nullptr;
+        if (bucket.head == nullptr) {
+            bucket.head = event;
+        } else {
+            bucket.tail->next = event;
+        }
+        bucket.tail = event;
+    }
+
+    // restart the scan from the earliest event
+    if (!resize_buffer.empty()) {
+        move_to(resize_buffer.front()->event_time);
+    }
+}
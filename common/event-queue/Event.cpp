@@ -8,6 +8,8 @@ LICENSE file in the root directory of this source tree.
 
 using namespace NetworkAnalytical;
 
+Event::Event() noexcept : callback(nullptr), callback_arg(nullptr) {}
+
 Event::Event(const Callback callback, const CallbackArg callback_arg) noexcept
     : callback(callback),
       callback_arg(callback_arg) {
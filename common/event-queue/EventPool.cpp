@@ -0,0 +1,54 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventPool.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+EventPool::EventPool() noexcept : free_list(nullptr) {
+    // create empty pool
+    slabs = std::vector<std::unique_ptr<ScheduledEvent[]>>();
+}
+
+ScheduledEvent* EventPool::acquire() noexcept {
+    // grow the pool if there's no free slot
+    if (free_list == nullptr) {
+        allocate_slab();
+    }
+
+    // pop a free slot
+    auto* const event = free_list;
+    free_list = event->next;
+    event->next = nullptr;
+
+    return event;
+}
+
+void EventPool::release(ScheduledEvent* const event) noexcept {
+    assert(event != nullptr);
+
+    // push the slot back to the free list
+    event->next = free_list;
+    free_list = event;
+}
+
+uint64_t EventPool::get_events_allocated_count() const noexcept {
+    return slabs.size() * slab_size;
+}
+
+void EventPool::allocate_slab() noexcept {
+    assert(free_list == nullptr);
+
+    // allocate a slab
+    slabs.push_back(std::make_unique<ScheduledEvent[]>(slab_size));
+    auto* const slab = slabs.back().get();
+
+    // thread the slots onto the free list, in address order
+    for (auto i = slab_size; i > 0; i--) {
+        slab[i - 1].next = free_list;
+        free_list = &slab[i - 1];
+    }
+}
@@ -4,22 +4,52 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/EventQueue.h"
+#include "common/CalendarQueueEngine.h"
+#include "common/HeapEventQueueEngine.h"
+#include "common/LadderQueueEngine.h"
+#include "common/ParallelEventQueue.h"
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 using namespace NetworkAnalytical;
 
-EventQueue::EventQueue() noexcept : current_time(0) {
-    // create empty event queue
-    event_queue = std::list<EventList>();
+EventQueue::EventQueue(const EventQueueEngineType engine_type) noexcept
+    : current_time(0),
+      next_sequence(0),
+      invoked_sequence_bound(0),
+      scheduled_events_count(0) {
+    // create the requested engine
+    switch (engine_type) {
+    case EventQueueEngineType::BinaryHeap:
+        engine = std::make_unique<HeapEventQueueEngine<2>>();
+        break;
+    case EventQueueEngineType::QuaternaryHeap:
+        engine = std::make_unique<HeapEventQueueEngine<4>>();
+        break;
+    case EventQueueEngineType::CalendarQueue:
+        engine = std::make_unique<CalendarQueueEngine>();
+        break;
+    case EventQueueEngineType::LadderQueue:
+        engine = std::make_unique<LadderQueueEngine>();
+        break;
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical) " << "not supported event queue engine" << std::endl;
+        std::exit(-1);
+    }
 }
 
+// default destructor
+EventQueue::~EventQueue() noexcept = default;
+
 EventTime EventQueue::get_current_time() const noexcept {
     return current_time;
 }
 
 bool EventQueue::finished() const noexcept {
     // check whether event queue is empty
-    return event_queue.empty();
+    return engine->empty();
 }
 
 void EventQueue::proceed() noexcept {
@@ -27,17 +57,34 @@ void EventQueue::proceed() noexcept {
     assert(!finished());
 
     // proceed to the next event time
-    auto& current_event_list = event_queue.front();
+    auto* const next_event = engine->pop();
 
     // check the validity and update current time
-    assert(current_event_list.get_event_time() > current_time);
-    current_time = current_event_list.get_event_time();
+    assert(next_event->event_time >= current_time);
+    current_time = next_event->event_time;
 
-    // invoke events
-    current_event_list.invoke_events();
+    // invoke the event
+    // the slot is recycled first, so that the callback can reuse it
+    auto event = next_event->event;
+    invoked_sequence_bound = next_event->sequence + 1;
+    event_pool.release(next_event);
+    if (partition != nullptr) {
+        partition->invoked_event_logged = false;
+    }
+    event.invoke_event();
 
-    // drop processed event list
-    event_queue.pop_front();
+    // invoke all other events registered at the current time,
+    // including the ones newly registered by the invoked events
+    while (!engine->empty() && engine->next_event_time() == current_time) {
+        auto* const same_time_event = engine->pop();
+        event = same_time_event->event;
+        invoked_sequence_bound = same_time_event->sequence + 1;
+        event_pool.release(same_time_event);
+        if (partition != nullptr) {
+            partition->invoked_event_logged = false;
+        }
+        event.invoke_event();
+    }
 }
 
 void EventQueue::schedule_event(const EventTime event_time,
@@ -46,26 +93,109 @@ void EventQueue::schedule_event(const EventTime event_time,
     // time should be at least larger than current time
     assert(event_time >= current_time);
 
-    // find the entry to insert event
-    auto event_list_it = event_queue.begin();
-    while (event_list_it != event_queue.end() && event_list_it->get_event_time() < event_time) {
-        event_list_it++;
+    // register the event, tagging it with its scheduling order
+    schedule_reserved_event(event_time, reserve_sequence(), callback, callback_arg);
+}
+
+void EventQueue::schedule_remote_event(EventQueue& event_queue,
+                                       const EventTime event_time,
+                                       const Callback callback,
+                                       const CallbackArg callback_arg) noexcept {
+    // both event queues should be partitions, and the event should fall in a later window
+    assert(partition != nullptr);
+    assert(event_queue.partition != nullptr);
+    assert(event_time >= partition->window_end);
+
+    // stage the event for the other partition, taking its sequence number from this one
+    const auto sequence = reserve_sequence();
+    auto& outbox = partition->outboxes[event_queue.partition->index];
+    outbox.push_back(EventQueuePartition::StagedEvent{event_time, sequence, Event(callback, callback_arg)});
+    scheduled_events_count++;
+}
+
+uint64_t EventQueue::reserve_sequence() noexcept {
+    // partitions derive sequence numbers from the invoked event
+    if (partition != nullptr) {
+        return reserve_partition_sequence();
+    }
+
+    // take the next sequence number
+    const auto sequence = next_sequence;
+    next_sequence++;
+
+    return sequence;
+}
+
+void EventQueue::schedule_reserved_event(const EventTime event_time,
+                                         const uint64_t sequence,
+                                         const Callback callback,
+                                         const CallbackArg callback_arg) noexcept {
+    // sequence should have been reserved, and the event not passed yet
+    assert(partition != nullptr || sequence < next_sequence);
+    assert(!passed(event_time, sequence));
+
+    // events of a later window wait for the next synchronization
+    if (partition != nullptr && event_time >= partition->window_end) {
+        auto& outbox = partition->outboxes[partition->index];
+        outbox.push_back(EventQueuePartition::StagedEvent{event_time, sequence, Event(callback, callback_arg)});
+        scheduled_events_count++;
+        return;
     }
 
-    // There can be three scenarios:
-    // (1) event list matching with event_time is found
-    // (2) there's no event list matching with event_time
-    //   (2-1) the event_time requested is
-    //   larger than the largest event time scheduled
-    //   (2-2) the event_time requested is
-    //   smaller than the largest event time scheduled
-    // for both (2-1) or (2-2), a new event should be created
-    if (event_list_it == event_queue.end() || event_time < event_list_it->get_event_time()) {
-        // insert new event_list
-        event_list_it = event_queue.insert(event_list_it, EventList(event_time));
+    // register the event
+    auto* const event = event_pool.acquire();
+    event->event_time = event_time;
+    event->sequence = sequence;
+    event->event = Event(callback, callback_arg);
+    engine->push(event);
+    scheduled_events_count++;
+}
+
+bool EventQueue::passed(const EventTime event_time, const uint64_t sequence) const noexcept {
+    // events at the same time are invoked in sequence order
+    if (event_time != current_time) {
+        return event_time < current_time;
+    }
+    return sequence < invoked_sequence_bound;
+}
+
+uint64_t EventQueue::get_scheduled_events_count() const noexcept {
+    return scheduled_events_count;
+}
+
+uint64_t EventQueue::get_allocated_event_slots_count() const noexcept {
+    return event_pool.get_events_allocated_count();
+}
+
+uint64_t EventQueue::reserve_partition_sequence() noexcept {
+    assert(partition != nullptr);
+
+    // events scheduled before the simulation are numbered in order
+    if (!partition->invoking) {
+        const auto sequence = *partition->root_sequence;
+        (*partition->root_sequence)++;
+        return sequence;
+    }
+
+    // log the invoked event on its first child, which gives the event its provisional rank
+    if (!partition->invoked_event_logged) {
+        const auto rank = partition->rank_base + partition->logged_events.size();
+        partition->logged_events.push_back(EventQueuePartition::LoggedEvent{current_time, invoked_sequence_bound - 1});
+        partition->next_child_sequence =
+            ParallelEventQueue::child_sequence_flag | (rank << ParallelEventQueue::child_index_bits);
+        partition->invoked_event_logged = true;
+    }
+
+    // number the child
+    const auto sequence = partition->next_child_sequence;
+    partition->next_child_sequence++;
+
+    // the index among the siblings should not overflow into the rank
+    constexpr auto child_index_mask = (static_cast<uint64_t>(1) << ParallelEventQueue::child_index_bits) - 1;
+    if ((partition->next_child_sequence & child_index_mask) == 0) {
+        std::cerr << "[Error] (network/analytical) " << "too many events scheduled by a single event" << std::endl;
+        std::exit(-1);
     }
 
-    // now, whether (1) or (2), the entry to insert the event is found
-    // add event to event_list
-    event_list_it->add_event(callback, callback_arg);
+    return sequence;
 }
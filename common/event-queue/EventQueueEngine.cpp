@@ -0,0 +1,11 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueueEngine.h"
+
+using namespace NetworkAnalytical;
+
+// default destructor
+EventQueueEngine::~EventQueueEngine() noexcept = default;
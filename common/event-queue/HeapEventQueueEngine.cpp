@@ -0,0 +1,94 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/HeapEventQueueEngine.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+template <int Arity> HeapEventQueueEngine<Arity>::HeapEventQueueEngine() noexcept {
+    // create empty heap
+    heap = std::vector<ScheduledEvent*>();
+}
+
+template <int Arity> void HeapEventQueueEngine<Arity>::push(ScheduledEvent* const event) noexcept {
+    assert(event != nullptr);
+
+    // open a hole at the end of the heap
+    heap.push_back(event);
+    auto hole = heap.size() - 1;
+
+    // sift the hole up until the parent precedes the new event
+    while (hole > 0) {
+        const auto parent = (hole - 1) / Arity;
+        if (!event->precedes(*heap[parent])) {
+            break;
+        }
+        heap[hole] = heap[parent];
+        hole = parent;
+    }
+
+    // place the new event
+    heap[hole] = event;
+}
+
+template <int Arity> ScheduledEvent* HeapEventQueueEngine<Arity>::pop() noexcept {
+    // heap should not be empty
+    assert(!heap.empty());
+
+    // take the earliest event, and the last event to re-insert
+    auto* const earliest_event = heap.front();
+    auto* const last_event = heap.back();
+    heap.pop_back();
+
+    if (heap.empty()) {
+        return earliest_event;
+    }
+
+    // sift the hole at the root down until the last event fits
+    const auto heap_size = heap.size();
+    auto hole = static_cast<size_t>(0);
+    while (true) {
+        const auto first_child = hole * Arity + 1;
+        if (first_child >= heap_size) {
+            break;
+        }
+
+        // find the earliest child
+        const auto last_child = (first_child + Arity < heap_size) ? (first_child + Arity) : heap_size;
+        auto earliest_child = first_child;
+        for (auto child = first_child + 1; child < last_child; child++) {
+            if (heap[child]->precedes(*heap[earliest_child])) {
+                earliest_child = child;
+            }
+        }
+
+        if (!heap[earliest_child]->precedes(*last_event)) {
+            break;
+        }
+        heap[hole] = heap[earliest_child];
+        hole = earliest_child;
+    }
+
+    // place the last event
+    heap[hole] = last_event;
+
+    return earliest_event;
+}
+
+template <int Arity> EventTime HeapEventQueueEngine<Arity>::next_event_time() noexcept {
+    // heap should not be empty
+    assert(!heap.empty());
+
+    return heap.front()->event_time;
+}
+
+template <int Arity> bool HeapEventQueueEngine<Arity>::empty() const noexcept {
+    return heap.empty();
+}
+
+// explicit instantiations of the supported heap arities
+template class NetworkAnalytical::HeapEventQueueEngine<2>;
+template class NetworkAnalytical::HeapEventQueueEngine<4>;
@@ -0,0 +1,221 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/LadderQueueEngine.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// a bucket holding more events than this is refined into a new rung instead of being sorted
+constexpr size_t bucket_sort_threshold = 50;
+
+}  // namespace
+
+LadderQueueEngine::LadderQueueEngine() noexcept
+    : top_min(0),
+      top_max(0),
+      top_start(0),
+      rungs_count(0),
+      bottom(nullptr),
+      events_count(0) {
+    // create empty tiers
+    top = Bucket{nullptr, 0};
+    rungs = std::vector<Rung>();
+    sort_buffer = std::vector<ScheduledEvent*>();
+}
+
+void LadderQueueEngine::push(ScheduledEvent* const event) noexcept {
+    assert(event != nullptr);
+
+    events_count++;
+    const auto event_time = event->event_time;
+
+    // far-future events go to top
+    if (event_time >= top_start) {
+        if (top.head == nullptr) {
+            top_min = event_time;
+            top_max = event_time;
+        } else {
+            top_min = std::min(top_min, event_time);
+            top_max = std::max(top_max, event_time);
+        }
+        event->next = top.head;
+        top.head = event;
+        top.events_count++;
+        return;
+    }
+
+    // otherwise, the coarsest rung whose unconsumed range covers the event takes it
+    for (auto i = static_cast<size_t>(0); i < rungs_count; i++) {
+        auto& rung = rungs[i];
+        if (event_time >= rung.current_bucket_start()) {
+            const auto index = static_cast<size_t>((event_time - rung.start) / rung.bucket_width);
+            assert(index < rung.buckets.size());
+            auto& bucket = rung.buckets[index];
+            event->next = bucket.head;
+            bucket.head = event;
+            bucket.events_count++;
+            return;
+        }
+    }
+
+    // earlier than anything on the ladder: goes to bottom
+    insert_bottom(event);
+}
+
+ScheduledEvent* LadderQueueEngine::pop() noexcept {
+    // queue should not be empty
+    assert(!empty());
+
+    if (bottom == nullptr) {
+        refill_bottom();
+    }
+
+    // take the earliest event
+    auto* const earliest_event = bottom;
+    bottom = earliest_event->next;
+    events_count--;
+
+    return earliest_event;
+}
+
+EventTime LadderQueueEngine::next_event_time() noexcept {
+    // queue should not be empty
+    assert(!empty());
+
+    if (bottom == nullptr) {
+        refill_bottom();
+    }
+
+    return bottom->event_time;
+}
+
+bool LadderQueueEngine::empty() const noexcept {
+    return events_count == 0;
+}
+
+void LadderQueueEngine::insert_bottom(ScheduledEvent* const event) noexcept {
+    // new earliest event
+    if (bottom == nullptr || event->precedes(*bottom)) {
+        event->next = bottom;
+        bottom = event;
+        return;
+    }
+
+    // otherwise, search for the insertion point
+    auto* previous = bottom;
+    while (previous->next != nullptr && !event->precedes(*previous->next)) {
+        previous = previous->next;
+    }
+    event->next = previous->next;
+    previous->next = event;
+}
+
+void LadderQueueEngine::refill_bottom() noexcept {
+    assert(bottom == nullptr);
+    assert(!empty());
+
+    while (bottom == nullptr) {
+        // ladder is empty: move top onto the ladder
+        if (rungs_count == 0) {
+            transfer_top_to_ladder();
+        }
+
+        // find the next non-empty bucket of the finest rung
+        auto& rung = rungs[rungs_count - 1];
+        while (rung.current_bucket < rung.buckets.size() && rung.buckets[rung.current_bucket].head == nullptr) {
+            rung.current_bucket++;
+        }
+
+        // the finest rung is fully consumed: go up the ladder
+        if (rung.current_bucket == rung.buckets.size()) {
+            rungs_count--;
+            continue;
+        }
+
+        // hand the bucket down
+        const auto bucket_start = rung.current_bucket_start();
+        const auto bucket_width = rung.bucket_width;
+        const auto events = rung.buckets[rung.current_bucket];
+        rung.buckets[rung.current_bucket] = Bucket{nullptr, 0};
+        rung.current_bucket++;
+
+        if (events.events_count > bucket_sort_threshold && bucket_width > 1) {
+            // too many events to sort: refine the bucket into a new rung
+            spawn_rung(events, bucket_start, bucket_width, bucket_sort_threshold);
+        } else {
+            // sort the bucket into bottom
+            sort_into_bottom(events);
+        }
+    }
+}
+
+void LadderQueueEngine::transfer_top_to_ladder() noexcept {
+    assert(rungs_count == 0);
+    assert(top.head != nullptr);
+
+    // spread top over a new rung with roughly one event per bucket
+    const auto span = top_max - top_min + 1;
+    spawn_rung(top, top_min, span, top.events_count);
+
+    // from now on, events after the current top_max are inserted into top again
+    top = Bucket{nullptr, 0};
+    top_start = top_max + 1;
+}
+
+void LadderQueueEngine::spawn_rung(const Bucket events,
+                                   const EventTime start,
+                                   const EventTime span,
+                                   const EventTime buckets_count) noexcept {
+    assert(span > 0);
+    assert(buckets_count > 0);
+
+    // reuse a retired rung if there's one
+    if (rungs_count == rungs.size()) {
+        rungs.emplace_back();
+    }
+    auto& rung = rungs[rungs_count];
+    rungs_count++;
+
+    // compute the rung shape, so that the buckets cover the entire span
+    rung.start = start;
+    rung.bucket_width = std::max(static_cast<EventTime>(1), (span + buckets_count - 1) / buckets_count);
+    rung.current_bucket = 0;
+    rung.buckets.assign((span + rung.bucket_width - 1) / rung.bucket_width, Bucket{nullptr, 0});
+
+    // spread the events
+    auto* event = events.head;
+    while (event != nullptr) {
+        auto* const next_event = event->next;
+        const auto index = static_cast<size_t>((event->event_time - start) / rung.bucket_width);
+        assert(index < rung.buckets.size());
+        auto& bucket = rung.buckets[index];
+        event->next = bucket.head;
+        bucket.head = event;
+        bucket.events_count++;
+        event = next_event;
+    }
+}
+
+void LadderQueueEngine::sort_into_bottom(const Bucket events) noexcept {
+    assert(bottom == nullptr);
+
+    // sort the events
+    sort_buffer.clear();
+    for (auto* event = events.head; event != nullptr; event = event->next) {
+        sort_buffer.push_back(event);
+    }
+    std::sort(sort_buffer.begin(), sort_buffer.end(),
+              [](const ScheduledEvent* const a, const ScheduledEvent* const b) { return a->precedes(*b); });
+
+    // link them in order
+    for (auto i = sort_buffer.size(); i > 0; i--) {
+        sort_buffer[i - 1]->next = bottom;
+        bottom = sort_buffer[i - 1];
+    }
+}
@@ -0,0 +1,347 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/ParallelEventQueue.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <thread>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// a window with fewer logged events than this per partition is ranked by fewer partitions
+constexpr uint64_t min_rank_slice_size = 4'096;
+
+/// number of spins before a thread waiting at the barrier yields its core
+constexpr int barrier_spins_count = 1'024;
+
+/// event time of a partition without pending events
+constexpr EventTime no_event_time = std::numeric_limits<EventTime>::max();
+
+}  // namespace
+
+ParallelEventQueue::SpinBarrier::SpinBarrier(const int threads_count) noexcept
+    : threads_count(threads_count),
+      waiting_count(0),
+      generation(0) {
+    assert(threads_count > 0);
+}
+
+void ParallelEventQueue::SpinBarrier::wait() noexcept {
+    const auto current_generation = generation.load(std::memory_order_acquire);
+
+    // the last thread to arrive releases the others
+    if (waiting_count.fetch_add(1, std::memory_order_acq_rel) == threads_count - 1) {
+        waiting_count.store(0, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        return;
+    }
+
+    // spin for a while, then yield the core to the other partitions
+    auto spins_count = 0;
+    while (generation.load(std::memory_order_acquire) == current_generation) {
+        if (spins_count < barrier_spins_count) {
+            spins_count++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ParallelEventQueue::ParallelEventQueue(const int partitions_count,
+                                       const EventTime lookahead,
+                                       const EventQueueEngineType engine_type) noexcept
+    : partitions_count(partitions_count),
+      lookahead(lookahead),
+      root_sequence(0),
+      barrier(partitions_count),
+      windows_count(0),
+      ran(false) {
+    assert(partitions_count > 0);
+    assert(lookahead > 0);
+
+    // create the partitions
+    for (auto i = 0; i < partitions_count; i++) {
+        auto event_queue = std::make_shared<EventQueue>(engine_type);
+
+        auto partition = std::make_unique<EventQueuePartition>();
+        partition->index = i;
+        partition->window_end = 0;  // stage every event scheduled before the simulation
+        partition->rank_base = 0;
+        partition->root_sequence = &root_sequence;
+        partition->invoking = false;
+        partition->invoked_event_logged = false;
+        partition->next_child_sequence = 0;
+        partition->outboxes.resize(partitions_count);
+        event_queue->partition = std::move(partition);
+
+        partitions.push_back(std::move(event_queue));
+    }
+
+    next_event_times = std::vector<EventTime>(partitions_count, no_event_time);
+    logged_events_counts = std::vector<uint64_t>(partitions_count, 0);
+}
+
+ParallelEventQueue::~ParallelEventQueue() noexcept = default;
+
+int ParallelEventQueue::get_partitions_count() const noexcept {
+    return partitions_count;
+}
+
+std::shared_ptr<EventQueue> ParallelEventQueue::get_partition(const int partition) const noexcept {
+    assert(0 <= partition && partition < partitions_count);
+
+    return partitions[partition];
+}
+
+void ParallelEventQueue::run() noexcept {
+    // the sequence numbers of root events can't follow the events of a previous run
+    assert(!ran);
+    ran = true;
+
+    // run every partition on its own thread, including this one
+    auto workers = std::vector<std::thread>();
+    for (auto i = 1; i < partitions_count; i++) {
+        workers.emplace_back([this, i]() { run_partition(i); });
+    }
+    run_partition(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+EventTime ParallelEventQueue::get_current_time() const noexcept {
+    auto current_time = static_cast<EventTime>(0);
+    for (const auto& event_queue : partitions) {
+        current_time = std::max(current_time, event_queue->get_current_time());
+    }
+
+    return current_time;
+}
+
+uint64_t ParallelEventQueue::get_scheduled_events_count() const noexcept {
+    auto scheduled_events_count = static_cast<uint64_t>(0);
+    for (const auto& event_queue : partitions) {
+        scheduled_events_count += event_queue->get_scheduled_events_count();
+    }
+
+    return scheduled_events_count;
+}
+
+uint64_t ParallelEventQueue::get_windows_count() const noexcept {
+    return windows_count;
+}
+
+void ParallelEventQueue::run_partition(const int partition) noexcept {
+    auto& event_queue = *partitions[partition];
+    auto& state = *event_queue.partition;
+
+    while (true) {
+        // receive the events staged in the previous window (or before the simulation)
+        deliver(partition);
+        next_event_times[partition] = event_queue.finished() ? no_event_time : event_queue.engine->next_event_time();
+        barrier.wait();
+
+        // the next window starts at the earliest pending event
+        const auto window_start = *std::min_element(next_event_times.begin(), next_event_times.end());
+        if (window_start == no_event_time) {
+            // every partition has finished
+            return;
+        }
+        if (partition == 0) {
+            windows_count++;
+        }
+
+        // every partition has delivered: the log of the previous window can be dropped
+        state.rank_base += logged_events_counts[partition];
+        state.logged_events.clear();
+        state.window_end = std::max(window_start + lookahead, window_start);
+
+        // invoke the events of the window
+        state.invoking = true;
+        while (!event_queue.finished() && event_queue.engine->next_event_time() < state.window_end) {
+            event_queue.proceed();
+        }
+        state.invoking = false;
+        state.logged_event_ranks.resize(state.logged_events.size());
+        barrier.wait();
+
+        // rank the invoked events
+        rank_logged_events(partition);
+        barrier.wait();
+    }
+}
+
+void ParallelEventQueue::deliver(const int partition) noexcept {
+    auto& event_queue = *partitions[partition];
+    const auto rank_base = event_queue.partition->rank_base;
+    constexpr auto child_index_mask = (static_cast<uint64_t>(1) << child_index_bits) - 1;
+
+    for (const auto& source : partitions) {
+        const auto& source_state = *source->partition;
+        auto& outbox = source->partition->outboxes[partition];
+
+        for (const auto& staged_event : outbox) {
+            auto sequence = staged_event.sequence;
+
+            // replace the provisional rank of the scheduling event
+            if ((sequence & child_sequence_flag) != 0) {
+                const auto provisional_rank = (sequence & ~child_sequence_flag) >> child_index_bits;
+                assert(provisional_rank >= rank_base);
+                const auto rank = source_state.logged_event_ranks[provisional_rank - rank_base];
+                sequence = child_sequence_flag | (rank << child_index_bits) | (sequence & child_index_mask);
+            }
+
+            auto* const event = event_queue.event_pool.acquire();
+            event->event_time = staged_event.event_time;
+            event->sequence = sequence;
+            event->event = staged_event.event;
+            event_queue.engine->push(event);
+        }
+
+        outbox.clear();
+    }
+}
+
+void ParallelEventQueue::rank_logged_events(const int partition) noexcept {
+    // count the logged events, and find the largest log to take the slice boundaries from
+    auto logged_events_count = static_cast<uint64_t>(0);
+    auto largest_partition = 0;
+    for (auto i = 0; i < partitions_count; i++) {
+        const auto logged_count = partitions[i]->partition->logged_events.size();
+        logged_events_count += logged_count;
+        if (logged_count > partitions[largest_partition]->partition->logged_events.size()) {
+            largest_partition = i;
+        }
+    }
+    logged_events_counts[partition] = logged_events_count;
+
+    // ranks should fit in the sequence numbers
+    const auto rank_base = partitions[partition]->partition->rank_base;
+    if (rank_base + logged_events_count >= (child_sequence_flag >> child_index_bits)) {
+        std::cerr << "[Error] (network/analytical) " << "too many events for a parallel simulation" << std::endl;
+        std::exit(-1);
+    }
+
+    // small windows are ranked by fewer partitions
+    const auto slices_count =
+        static_cast<int>(std::clamp(logged_events_count / min_rank_slice_size, static_cast<uint64_t>(1),
+                                    static_cast<uint64_t>(partitions_count)));
+    if (logged_events_count == 0 || partition >= slices_count) {
+        return;
+    }
+
+    // find the first logged event of a slice in each partition's log
+    const auto splitters_count = partitions[largest_partition]->partition->logged_events.size();
+    const auto slice_bounds = [&](const int slice) -> std::vector<size_t> {
+        auto bounds = std::vector<size_t>(partitions_count, 0);
+        if (slice == 0) {
+            return bounds;
+        }
+
+        const auto splitter = (slice == slices_count) ? splitters_count : (slice * splitters_count / slices_count);
+        for (auto i = 0; i < partitions_count; i++) {
+            const auto& logged_events = partitions[i]->partition->logged_events;
+            if (splitter == splitters_count) {
+                bounds[i] = logged_events.size();
+                continue;
+            }
+
+            // lower bound of the splitter
+            auto low = static_cast<size_t>(0);
+            auto high = logged_events.size();
+            while (low < high) {
+                const auto middle = low + (high - low) / 2;
+                if (logged_event_precedes(i, middle, largest_partition, splitter)) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            bounds[i] = low;
+        }
+
+        return bounds;
+    };
+    auto heads = slice_bounds(partition);
+    const auto ends = slice_bounds(partition + 1);
+
+    // the slice starts after every event before its first events
+    auto rank = rank_base;
+    for (const auto head : heads) {
+        rank += head;
+    }
+
+    // merge the slice of every log in invocation order
+    const auto follows = [&](const int a, const int b) { return logged_event_precedes(b, heads[b], a, heads[a]); };
+    auto merge_queue = std::priority_queue<int, std::vector<int>, decltype(follows)>(follows);
+    for (auto i = 0; i < partitions_count; i++) {
+        if (heads[i] < ends[i]) {
+            merge_queue.push(i);
+        }
+    }
+    while (!merge_queue.empty()) {
+        const auto i = merge_queue.top();
+        merge_queue.pop();
+
+        partitions[i]->partition->logged_event_ranks[heads[i]] = rank;
+        rank++;
+
+        heads[i]++;
+        if (heads[i] < ends[i]) {
+            merge_queue.push(i);
+        }
+    }
+}
+
+bool ParallelEventQueue::logged_event_precedes(int partition,
+                                               size_t index,
+                                               int other_partition,
+                                               size_t other_index) const noexcept {
+    const auto rank_base = partitions[partition]->partition->rank_base;
+
+    while (true) {
+        const auto& event = partitions[partition]->partition->logged_events[index];
+        const auto& other_event = partitions[other_partition]->partition->logged_events[other_index];
+
+        // earlier events precede
+        if (event.event_time != other_event.event_time) {
+            return event.event_time < other_event.event_time;
+        }
+
+        // root events precede, in the order they were scheduled
+        const auto is_root = (event.sequence & child_sequence_flag) == 0;
+        const auto other_is_root = (other_event.sequence & child_sequence_flag) == 0;
+        if (is_root || other_is_root) {
+            return (is_root && other_is_root) ? (event.sequence < other_event.sequence) : is_root;
+        }
+
+        // events scheduled in an earlier window precede, in the order of their (actual) sequence numbers
+        const auto parent_rank = (event.sequence & ~child_sequence_flag) >> child_index_bits;
+        const auto other_parent_rank = (other_event.sequence & ~child_sequence_flag) >> child_index_bits;
+        const auto parent_in_window = parent_rank >= rank_base;
+        const auto other_parent_in_window = other_parent_rank >= rank_base;
+        if (!parent_in_window || !other_parent_in_window) {
+            return (parent_in_window == other_parent_in_window) ? (event.sequence < other_event.sequence)
+                                                                : other_parent_in_window;
+        }
+
+        // both were scheduled in this window by an event of their own partition:
+        // siblings follow the order they were scheduled in, others the order of their parents
+        const auto parent_index = static_cast<size_t>(parent_rank - rank_base);
+        const auto other_parent_index = static_cast<size_t>(other_parent_rank - rank_base);
+        if (partition == other_partition && parent_index == other_parent_index) {
+            return event.sequence < other_event.sequence;
+        }
+        index = parent_index;
+        other_index = other_parent_index;
+    }
+}
@@ -29,6 +29,17 @@ NetworkParser::NetworkParser(const std::string& path) noexcept : dims_count(-1)
     }
 }
 
+NetworkParser::NetworkParser(const YAML::Node& network_config) noexcept : dims_count(-1) {
+    // initialize values
+    npus_count_per_dim = {};
+    bandwidth_per_dim = {};
+    latency_per_dim = {};
+    topology_per_dim = {};
+
+    // parse network configs
+    parse_network_config_yml(network_config);
+}
+
 int NetworkParser::get_dims_count() const noexcept {
     assert(dims_count > 0);
 
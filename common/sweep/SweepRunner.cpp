@@ -0,0 +1,96 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/SweepRunner.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Join per-dimension values with '_', e.g., [Ring, Switch] -> "Ring_Switch".
+ */
+std::string join_dims(const std::vector<std::string>& values) noexcept {
+    auto joined = std::string();
+    for (const auto& value : values) {
+        if (!joined.empty()) {
+            joined += "_";
+        }
+        joined += value;
+    }
+
+    return joined;
+}
+
+}  // namespace
+
+SweepRunner::SweepRunner(SweepSpec sweep_spec, const int threads_count) noexcept
+    : sweep_spec(std::move(sweep_spec)),
+      thread_pool(threads_count) {
+    evaluators = {};
+}
+
+void SweepRunner::register_backend(const std::string& backend, SweepEvaluator evaluator) noexcept {
+    assert(evaluator != nullptr);
+
+    evaluators[backend] = std::move(evaluator);
+}
+
+std::vector<SweepResult> SweepRunner::run() noexcept {
+    // every backend should have been registered
+    const auto backends = sweep_spec.get_backends();
+    for (const auto& backend : backends) {
+        if (evaluators.find(backend) == evaluators.end()) {
+            std::cerr << "[Error] (network/analytical) " << "backend " << backend << " not supported" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // one task per (sweep point, backend) pair
+    const auto chunk_size = sweep_spec.get_chunk_size();
+    const auto tasks_count = sweep_spec.get_points_count() * backends.size();
+    auto results = std::vector<SweepResult>(tasks_count);
+
+    thread_pool.parallel_for(tasks_count, [&](const size_t task) {
+        auto& result = results[task];
+        result.point = task / backends.size();
+        result.backend = backends[task % backends.size()];
+        result.network_config = sweep_spec.get_point_config(result.point);
+
+        // parse the point and evaluate it
+        const auto network_parser = NetworkParser(SweepSpec::to_yaml(result.network_config));
+        result.comm_time = evaluators.at(result.backend)(network_parser, chunk_size);
+    });
+
+    return results;
+}
+
+void SweepRunner::write_csv(const std::vector<SweepResult>& results,
+                            const ChunkSize chunk_size,
+                            std::ostream& output) noexcept {
+    // header
+    output << "point,backend,topology,npus_count,bandwidth,latency,npus,chunk_size,comm_time_ns\n";
+
+    // one row per result
+    for (const auto& result : results) {
+        const auto& network_config = result.network_config;
+
+        auto npus = 1;
+        for (const auto& npus_count : network_config.at("npus_count")) {
+            npus *= std::atoi(npus_count.c_str());
+        }
+
+        output << result.point << "," << result.backend << "," << join_dims(network_config.at("topology")) << ","
+               << join_dims(network_config.at("npus_count")) << "," << join_dims(network_config.at("bandwidth"))
+               << "," << join_dims(network_config.at("latency")) << "," << npus << "," << chunk_size << ",";
+        if (result.comm_time.has_value()) {
+            output << result.comm_time.value();
+        }
+        output << "\n";
+    }
+}
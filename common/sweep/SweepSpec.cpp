@@ -0,0 +1,205 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/SweepSpec.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// network configuration keys which can be swept
+const std::vector<std::string> network_config_keys = {"topology", "npus_count", "bandwidth", "latency"};
+
+}  // namespace
+
+SweepSpec::SweepSpec(const std::string& path) noexcept : chunk_size(0) {
+    try {
+        // load sweep spec file
+        const auto sweep_config = YAML::LoadFile(path);
+
+        // the base network path is relative to the sweep spec file
+        const auto base_directory = std::filesystem::path(path).parent_path().string();
+
+        // parse sweep spec
+        parse_sweep_config_yml(sweep_config, base_directory);
+    } catch (const YAML::Exception& e) {
+        // loading sweep spec file failed
+        std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
+        std::exit(-1);
+    }
+}
+
+SweepSpec::SweepSpec(const YAML::Node& sweep_config, const std::string& base_directory) noexcept : chunk_size(0) {
+    try {
+        // parse sweep spec
+        parse_sweep_config_yml(sweep_config, base_directory);
+    } catch (const YAML::Exception& e) {
+        // loading base network file failed
+        std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
+        std::exit(-1);
+    }
+}
+
+size_t SweepSpec::get_points_count() const noexcept {
+    // product of the candidate counts of every axis
+    auto points_count = static_cast<size_t>(1);
+    for (const auto& axis : axes) {
+        points_count *= axis.values.size();
+    }
+
+    return points_count;
+}
+
+SweepSpec::NetworkConfig SweepSpec::get_point_config(size_t point) const noexcept {
+    assert(point < get_points_count());
+
+    // start from the base network
+    auto network_config = base_config;
+
+    // decode the point index in mixed radix, where the last axis varies the fastest
+    for (auto it = axes.rbegin(); it != axes.rend(); it++) {
+        const auto& axis = *it;
+        const auto& value = axis.values[point % axis.values.size()];
+        point /= axis.values.size();
+
+        // sweep the whole key
+        if (axis.dim < 0) {
+            network_config[axis.key] = value;
+            continue;
+        }
+
+        // sweep a single dimension of the key
+        auto& key_value = network_config[axis.key];
+        assert(axis.dim >= 0);
+        if (static_cast<size_t>(axis.dim) >= key_value.size()) {
+            std::cerr << "[Error] (network/analytical) " << "swept dimension " << axis.key << "[" << axis.dim
+                      << "] doesn't exist in a " << key_value.size() << "-dim network" << std::endl;
+            std::exit(-1);
+        }
+        key_value[axis.dim] = value[0];
+    }
+
+    return network_config;
+}
+
+YAML::Node SweepSpec::to_yaml(const NetworkConfig& network_config) noexcept {
+    auto node = YAML::Node();
+    for (const auto& [key, value] : network_config) {
+        for (const auto& dim_value : value) {
+            node[key].push_back(dim_value);
+        }
+    }
+
+    return node;
+}
+
+std::vector<std::string> SweepSpec::get_backends() const noexcept {
+    return backends;
+}
+
+ChunkSize SweepSpec::get_chunk_size() const noexcept {
+    assert(chunk_size > 0);
+
+    return chunk_size;
+}
+
+void SweepSpec::parse_sweep_config_yml(const YAML::Node& sweep_config, const std::string& base_directory) {
+    // parse base network
+    if (!sweep_config["network"]) {
+        std::cerr << "[Error] (network/analytical) " << "sweep spec should specify the base network" << std::endl;
+        std::exit(-1);
+    }
+    const auto network_path = std::filesystem::path(base_directory) / sweep_config["network"].as<std::string>();
+    const auto network_config = YAML::LoadFile(network_path.string());
+    for (const auto& key : network_config_keys) {
+        base_config[key] = parse_scalars(network_config[key]);
+    }
+
+    // parse backends, evaluating both backends by default
+    backends = {"congestion_unaware", "congestion_aware"};
+    if (sweep_config["backends"]) {
+        backends = parse_scalars(sweep_config["backends"]);
+    }
+
+    // parse chunk size, 1 MB by default
+    chunk_size = 1'048'576;
+    if (sweep_config["chunk_size"]) {
+        chunk_size = sweep_config["chunk_size"].as<ChunkSize>();
+    }
+    if (chunk_size == 0) {
+        std::cerr << "[Error] (network/analytical) " << "chunk_size should be larger than 0" << std::endl;
+        std::exit(-1);
+    }
+
+    // parse swept axes
+    for (const auto& entry : sweep_config["sweep"]) {
+        axes.push_back(parse_axis(entry.first.as<std::string>(), entry.second));
+    }
+}
+
+SweepSpec::SweepAxis SweepSpec::parse_axis(const std::string& swept_key, const YAML::Node& values) {
+    auto axis = SweepAxis();
+    axis.key = swept_key;
+    axis.dim = -1;
+
+    // split "key[dim]"
+    const auto bracket = swept_key.find('[');
+    if (bracket != std::string::npos) {
+        axis.key = swept_key.substr(0, bracket);
+        axis.dim = std::atoi(swept_key.c_str() + bracket + 1);
+        if (axis.dim < 0) {
+            std::cerr << "[Error] (network/analytical) " << "swept dimension of " << swept_key
+                      << " should be non-negative" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // key should be a network configuration key
+    if (std::find(network_config_keys.begin(), network_config_keys.end(), axis.key) == network_config_keys.end()) {
+        std::cerr << "[Error] (network/analytical) " << "key " << swept_key << " cannot be swept" << std::endl;
+        std::exit(-1);
+    }
+
+    // parse candidate values
+    for (const auto& value : values) {
+        auto parsed_value = parse_scalars(value);
+        if (axis.dim >= 0 && parsed_value.size() != 1) {
+            std::cerr << "[Error] (network/analytical) " << "values of " << swept_key << " should be scalars"
+                      << std::endl;
+            std::exit(-1);
+        }
+        axis.values.push_back(std::move(parsed_value));
+    }
+
+    // there should be at least one candidate
+    if (axis.values.empty()) {
+        std::cerr << "[Error] (network/analytical) " << "key " << swept_key << " has no value to sweep" << std::endl;
+        std::exit(-1);
+    }
+
+    return axis;
+}
+
+std::vector<std::string> SweepSpec::parse_scalars(const YAML::Node& node) {
+    auto scalars = std::vector<std::string>();
+
+    // single scalar
+    if (node.IsScalar()) {
+        scalars.push_back(node.as<std::string>());
+        return scalars;
+    }
+
+    // sequence of scalars
+    for (const auto& element : node) {
+        scalars.push_back(element.as<std::string>());
+    }
+
+    return scalars;
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+ThreadPool::ThreadPool(int threads_count) noexcept
+    : current_task(nullptr),
+      remaining_tasks_count(0),
+      active_workers_count(0),
+      batch_id(0),
+      stopping(false) {
+    assert(threads_count >= 0);
+
+    // use every hardware thread by default
+    if (threads_count == 0) {
+        threads_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // create task deques and spawn workers
+    for (auto i = 0; i < threads_count; i++) {
+        work_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (auto i = 0; i < threads_count; i++) {
+        workers.emplace_back(&ThreadPool::run_worker, this, static_cast<size_t>(i));
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    // wake up and join every worker
+    {
+        const auto lock = std::lock_guard<std::mutex>(mutex);
+        stopping = true;
+    }
+    batch_submitted.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::get_threads_count() const noexcept {
+    return static_cast<int>(workers.size());
+}
+
+void ThreadPool::parallel_for(const size_t tasks_count, const std::function<void(size_t)>& task) noexcept {
+    if (tasks_count == 0) {
+        return;
+    }
+
+    // wait until no worker is still draining the deques of a previous batch
+    auto lock = std::unique_lock<std::mutex>(mutex);
+    batch_finished.wait(lock, [this]() { return active_workers_count == 0; });
+
+    // seed each worker's deque with a contiguous block of tasks
+    const auto workers_count = work_queues.size();
+    for (auto worker_id = static_cast<size_t>(0); worker_id < workers_count; worker_id++) {
+        const auto begin = tasks_count * worker_id / workers_count;
+        const auto end = tasks_count * (worker_id + 1) / workers_count;
+
+        const auto queue_lock = std::lock_guard<std::mutex>(work_queues[worker_id]->mutex);
+        for (auto i = begin; i < end; i++) {
+            work_queues[worker_id]->tasks.push_back(i);
+        }
+    }
+
+    // submit the batch
+    current_task = &task;
+    remaining_tasks_count = tasks_count;
+    batch_id++;
+    batch_submitted.notify_all();
+
+    // wait for every task to finish and every worker to leave the batch
+    batch_finished.wait(lock, [this]() { return remaining_tasks_count == 0 && active_workers_count == 0; });
+    current_task = nullptr;
+}
+
+void ThreadPool::run_worker(const size_t worker_id) noexcept {
+    auto last_batch_id = static_cast<uint64_t>(0);
+
+    while (true) {
+        // wait for a new batch
+        const std::function<void(size_t)>* task_function;
+        {
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            batch_submitted.wait(lock, [this, last_batch_id]() { return stopping || batch_id != last_batch_id; });
+            if (stopping) {
+                return;
+            }
+            last_batch_id = batch_id;
+            task_function = current_task;
+            active_workers_count++;
+        }
+
+        // run tasks until every deque is drained
+        auto task = static_cast<size_t>(0);
+        while (task_function != nullptr && take_task(worker_id, task)) {
+            (*task_function)(task);
+            remaining_tasks_count--;
+        }
+
+        // leave the batch
+        {
+            const auto lock = std::lock_guard<std::mutex>(mutex);
+            active_workers_count--;
+        }
+        batch_finished.notify_all();
+    }
+}
+
+bool ThreadPool::take_task(const size_t worker_id, size_t& task) noexcept {
+    // take from the back of its own deque
+    {
+        auto& own_queue = *work_queues[worker_id];
+        const auto lock = std::lock_guard<std::mutex>(own_queue.mutex);
+        if (!own_queue.tasks.empty()) {
+            task = own_queue.tasks.back();
+            own_queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal from the front of the other deques
+    const auto workers_count = work_queues.size();
+    for (auto offset = static_cast<size_t>(1); offset < workers_count; offset++) {
+        auto& victim_queue = *work_queues[(worker_id + offset) % workers_count];
+        const auto lock = std::lock_guard<std::mutex>(victim_queue.mutex);
+        if (!victim_queue.tasks.empty()) {
+            task = victim_queue.tasks.front();
+            victim_queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // nothing left
+    return false;
+}
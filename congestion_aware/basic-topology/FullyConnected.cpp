@@ -8,7 +8,10 @@ LICENSE file in the root directory of this source tree.
 
 using namespace NetworkAnalyticalCongestionAware;
 
-FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
+FullyConnected::FullyConnected(const int npus_count,
+                               const Bandwidth bandwidth,
+                               const Latency latency,
+                               const bool lazy_links) noexcept
     : BasicTopology(npus_count, npus_count, bandwidth, latency) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
@@ -17,6 +20,14 @@ FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth,
     // set topology type
     basic_topology_type = TopologyBuildingBlock::FullyConnected;
 
+    // fully-connect every src-dest pairs lazily:
+    // there's no adjacency link, and every link is instantiated on its first use
+    if (lazy_links) {
+        build_links();
+        connect_lazily(bandwidth, latency);
+        return;
+    }
+
     // fully-connect every src-dest pairs
     for (auto src = 0; src < npus_count; src++) {
         for (auto dest = 0; dest < npus_count; dest++) {
@@ -25,6 +36,9 @@ FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth,
             }
         }
     }
+
+    // instantiate links
+    build_links();
 }
 
 Route FullyConnected::route(const DeviceId src, const DeviceId dest) const noexcept {
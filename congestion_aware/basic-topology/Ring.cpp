@@ -20,6 +20,9 @@ Ring::Ring(const int npus_count, const Bandwidth bandwidth, const Latency latenc
         connect(i, i + 1, bandwidth, latency, bidirectional);
     }
     connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+
+    // instantiate links
+    build_links();
 }
 
 Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
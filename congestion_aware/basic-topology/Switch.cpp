@@ -23,6 +23,9 @@ Switch::Switch(const int npus_count, const Bandwidth bandwidth, const Latency la
     for (auto i = 0; i < npus_count; i++) {
         connect(i, switch_id, bandwidth, latency, true);
     }
+
+    // instantiate links
+    build_links();
 }
 
 Route Switch::route(DeviceId src, DeviceId dest) const noexcept {
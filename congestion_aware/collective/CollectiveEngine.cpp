@@ -0,0 +1,338 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CollectiveEngine.h"
+#include "congestion_aware/Chunk.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+CollectiveEngine::CollectiveEngine(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)),
+      collective_type(CollectiveType::AllReduce),
+      algorithm(CollectiveAlgorithm::Ring),
+      chunk_size(0),
+      shard_size(0),
+      chunks_count(0),
+      slots_count(0),
+      started_chunks_count(0),
+      finished_chunks_count(0),
+      stages_count(0),
+      counters_count(0),
+      log2_npus_count(-1),
+      start_time(0),
+      finish_time(0),
+      sent_messages_count(0) {
+    assert(this->topology != nullptr);
+    assert(this->topology->get_event_queue() != nullptr);
+
+    npus_count = this->topology->get_npus_count();
+    assert(npus_count > 0);
+
+    // log2(p), if p is a power of 2
+    if ((npus_count & (npus_count - 1)) == 0) {
+        log2_npus_count = 0;
+        while ((1 << log2_npus_count) < npus_count) {
+            log2_npus_count++;
+        }
+    }
+}
+
+EventTime CollectiveEngine::run(const CollectiveType collective_type,
+                                const CollectiveAlgorithm algorithm,
+                                const ChunkSize collective_size,
+                                const int chunks_count,
+                                const int pipeline_depth) noexcept {
+    assert(collective_size > 0);
+    assert(chunks_count > 0);
+    assert(pipeline_depth > 0);
+
+    const auto is_all_reduce = (collective_type == CollectiveType::AllReduce);
+
+    // set the stages of the algorithm
+    switch (algorithm) {
+    case CollectiveAlgorithm::Ring:
+        // p - 1 steps, twice for All-Reduce
+        stages_count = (is_all_reduce ? 2 * (npus_count - 1) : (npus_count - 1)) + 1;
+        counters_count = 1;
+        break;
+    case CollectiveAlgorithm::Direct:
+        stages_count = is_all_reduce ? 3 : 2;
+        counters_count = stages_count;
+        break;
+    case CollectiveAlgorithm::HalvingDoubling:
+        if (log2_npus_count < 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "HalvingDoubling needs a power of 2 NPUs, but the topology has " << npus_count << std::endl;
+            std::exit(-1);
+        }
+        stages_count = (is_all_reduce ? 2 * log2_npus_count : log2_npus_count) + 1;
+        counters_count = stages_count;
+        break;
+    case CollectiveAlgorithm::BinaryTree:
+        if (collective_type == CollectiveType::AllToAll) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "BinaryTree doesn't support All-to-All" << std::endl;
+            std::exit(-1);
+        }
+        // up to the root, then back down
+        stages_count = 2;
+        counters_count = stages_count;
+        break;
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Not supported collective algorithm"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // set the collective
+    this->collective_type = collective_type;
+    this->algorithm = algorithm;
+    this->chunks_count = chunks_count;
+    chunk_size = (collective_size + chunks_count - 1) / chunks_count;
+    shard_size = (chunk_size + npus_count - 1) / npus_count;
+    slots_count = std::min(pipeline_depth, chunks_count);
+    started_chunks_count = 0;
+    finished_chunks_count = 0;
+    sent_messages_count = 0;
+
+    // preallocate the bookkeeping of the chunks in flight
+    stage_per_npu.assign(static_cast<size_t>(slots_count) * npus_count, 0);
+    arrivals_count.assign(static_cast<size_t>(slots_count) * npus_count * counters_count, 0);
+    finished_npus_count.assign(slots_count, 0);
+
+    // start the first chunks, and run until every chunk finishes
+    const auto event_queue = topology->get_event_queue();
+    start_time = event_queue->get_current_time();
+    finish_time = start_time;
+    for (auto slot = 0; slot < slots_count; slot++) {
+        start_chunk(slot);
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    assert(finished_chunks_count == chunks_count);
+
+    return finish_time - start_time;
+}
+
+uint64_t CollectiveEngine::get_sent_messages_count() const noexcept {
+    return sent_messages_count;
+}
+
+void CollectiveEngine::message_arrived(void* const message_ptr) noexcept {
+    assert(message_ptr != nullptr);
+
+    // recycle the message
+    auto* const message = static_cast<Message*>(message_ptr);
+    auto* const engine = message->engine;
+    const auto slot = message->slot;
+    const auto dest = message->dest;
+    const auto stage = message->stage;
+    engine->message_pool.release(message);
+
+    // count the arrival, and advance the dest NPU
+    const auto npu_index = (static_cast<size_t>(slot) * engine->npus_count) + dest;
+    engine->arrivals_count[(npu_index * engine->counters_count) + (stage % engine->counters_count)]++;
+    engine->advance(slot, dest);
+}
+
+void CollectiveEngine::start_chunk(const int slot) noexcept {
+    assert(0 <= slot && slot < slots_count);
+    assert(started_chunks_count < chunks_count);
+
+    started_chunks_count++;
+
+    // every message of the previous chunk of the slot has arrived, so its bookkeeping can be reused
+    const auto first_npu_index = static_cast<size_t>(slot) * npus_count;
+    std::fill_n(stage_per_npu.begin() + first_npu_index, npus_count, 0);
+    std::fill_n(arrivals_count.begin() + (first_npu_index * counters_count), npus_count * counters_count, 0);
+    finished_npus_count[slot] = 0;
+
+    for (auto npu = 0; npu < npus_count; npu++) {
+        advance(slot, npu);
+    }
+}
+
+void CollectiveEngine::advance(const int slot, const DeviceId npu) noexcept {
+    assert(0 <= slot && slot < slots_count);
+    assert(0 <= npu && npu < npus_count);
+
+    const auto npu_index = (static_cast<size_t>(slot) * npus_count) + npu;
+    auto& stage = stage_per_npu[npu_index];
+    auto* const counters = &arrivals_count[npu_index * counters_count];
+
+    // go through every stage whose messages have all arrived
+    while (stage < stages_count) {
+        const auto expected_arrivals_count = get_expected_arrivals_count(npu, stage);
+        auto& counter = counters[stage % counters_count];
+        if (counter < expected_arrivals_count) {
+            return;
+        }
+        counter -= expected_arrivals_count;
+        send_stage(slot, npu, stage);
+        stage++;
+    }
+
+    // the NPU has finished the chunk
+    finished_npus_count[slot]++;
+    if (finished_npus_count[slot] < npus_count) {
+        return;
+    }
+
+    // the chunk has finished on every NPU
+    finished_chunks_count++;
+    if (finished_chunks_count == chunks_count) {
+        finish_time = topology->get_event_queue()->get_current_time();
+    }
+    if (started_chunks_count < chunks_count) {
+        start_chunk(slot);
+    }
+}
+
+uint32_t CollectiveEngine::get_expected_arrivals_count(const DeviceId npu, const int stage) const noexcept {
+    assert(0 <= npu && npu < npus_count);
+    assert(0 <= stage && stage < stages_count);
+
+    switch (algorithm) {
+    case CollectiveAlgorithm::Ring:
+    case CollectiveAlgorithm::HalvingDoubling:
+        // a message from the previous NPU or the partner of each step
+        return (stage == 0) ? 0 : 1;
+    case CollectiveAlgorithm::Direct:
+        // a message from every other NPU of each step
+        return (stage == 0) ? 0 : (npus_count - 1);
+    case CollectiveAlgorithm::BinaryTree: {
+        if (stage == 1) {
+            // a message from the parent
+            return (npu == 0) ? 0 : 1;
+        }
+
+        // a message from each child
+        const auto first_child = (2 * npu) + 1;
+        return std::clamp(npus_count - first_child, 0, 2);
+    }
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Not supported collective algorithm"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+void CollectiveEngine::send_stage(const int slot, const DeviceId npu, const int stage) noexcept {
+    assert(0 <= slot && slot < slots_count);
+    assert(0 <= npu && npu < npus_count);
+    assert(0 <= stage && stage < stages_count);
+
+    // the last stage sends nothing
+    const auto steps_count = stages_count - 1;
+    if (algorithm != CollectiveAlgorithm::BinaryTree && stage == steps_count) {
+        return;
+    }
+
+    switch (algorithm) {
+    case CollectiveAlgorithm::Ring: {
+        // All-to-All forwards the shards not yet delivered, the others a shard per step
+        const auto dest = (npu + 1 == npus_count) ? 0 : (npu + 1);
+        const auto message_size =
+            (collective_type == CollectiveType::AllToAll) ? (shard_size * (npus_count - 1 - stage)) : shard_size;
+        send_message(slot, npu, dest, stage + 1, message_size);
+        return;
+    }
+    case CollectiveAlgorithm::Direct: {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (dest != npu) {
+                send_message(slot, npu, dest, stage + 1, shard_size);
+            }
+        }
+        return;
+    }
+    case CollectiveAlgorithm::HalvingDoubling: {
+        // Reduce-Scatter halves the distance and the size every step, All-Gather doubles them
+        auto distance = 0;
+        auto message_size = ChunkSize(0);
+        if (collective_type == CollectiveType::AllToAll) {
+            distance = 1 << stage;
+            message_size = shard_size << (log2_npus_count - 1);
+        } else if (collective_type == CollectiveType::AllGather || stage >= log2_npus_count) {
+            const auto step = stage % log2_npus_count;
+            distance = 1 << step;
+            message_size = shard_size << step;
+        } else {
+            distance = npus_count >> (stage + 1);
+            message_size = shard_size << (log2_npus_count - stage - 1);
+        }
+        send_message(slot, npu, npu ^ distance, stage + 1, message_size);
+        return;
+    }
+    case CollectiveAlgorithm::BinaryTree: {
+        const auto gathers = (collective_type == CollectiveType::AllGather);
+        const auto scatters = (collective_type == CollectiveType::ReduceScatter);
+        if (stage == 0) {
+            // up to the parent: the gathered shards of the subtree, or the reduced chunk
+            if (npu != 0) {
+                const auto message_size = gathers ? (shard_size * get_subtree_npus_count(npu)) : chunk_size;
+                send_message(slot, npu, (npu - 1) / 2, 0, message_size);
+            }
+            return;
+        }
+
+        // down to the children: the shards of their subtrees, or the whole chunk
+        for (auto child = (2 * npu) + 1; child <= (2 * npu) + 2 && child < npus_count; child++) {
+            const auto message_size = scatters ? (shard_size * get_subtree_npus_count(child))
+                                               : (gathers ? (shard_size * npus_count) : chunk_size);
+            send_message(slot, npu, child, 1, message_size);
+        }
+        return;
+    }
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Not supported collective algorithm"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+void CollectiveEngine::send_message(const int slot,
+                                    const DeviceId src,
+                                    const DeviceId dest,
+                                    const int stage,
+                                    const ChunkSize message_size) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    auto* const message = message_pool.acquire();
+    message->engine = this;
+    message->slot = slot;
+    message->dest = dest;
+    message->stage = stage;
+
+    // send the message as a chunk
+    auto chunk = topology->create_chunk(message_size, topology->shared_route(src, dest), message_arrived, message);
+    topology->send(std::move(chunk));
+    sent_messages_count++;
+}
+
+int CollectiveEngine::get_subtree_npus_count(const DeviceId npu) const noexcept {
+    assert(0 <= npu && npu < npus_count);
+
+    // count the NPUs level by level: [first, last] holds the subtree's NPUs of each level
+    auto subtree_npus_count = 0;
+    auto first = static_cast<int64_t>(npu);
+    auto last = static_cast<int64_t>(npu);
+    while (first < npus_count) {
+        subtree_npus_count += static_cast<int>(std::min<int64_t>(last, npus_count - 1) - first + 1);
+        first = (2 * first) + 1;
+        last = (2 * last) + 2;
+    }
+    return subtree_npus_count;
+}
@@ -0,0 +1,239 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CollectiveSchedule.h"
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Parse the next unsigned integer field of a text line.
+ *
+ * @param cursor position to parse from, advanced past the field
+ * @param value output: parsed value
+ * @return true if a field has been parsed, false at the end of the line
+ */
+bool parse_field(const char*& cursor, uint64_t& value) noexcept {
+    while (std::isspace(static_cast<unsigned char>(*cursor))) {
+        cursor++;
+    }
+    if (*cursor == '\0' || *cursor == '#') {
+        return false;
+    }
+
+    // only digits make a field
+    if (!std::isdigit(static_cast<unsigned char>(*cursor))) {
+        value = UINT64_MAX;
+        cursor += std::strlen(cursor);
+        return true;
+    }
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(cursor, &end, 10);
+    if (errno != 0 || (*end != '\0' && !std::isspace(static_cast<unsigned char>(*end)) && *end != '#')) {
+        value = UINT64_MAX;
+    }
+    cursor = end;
+    return true;
+}
+
+}  // namespace
+
+CollectiveScheduleReader::CollectiveScheduleReader(const std::string& schedule_path) noexcept
+    : schedule_path(schedule_path),
+      format(ScheduleFormat::Text),
+      file_size(0),
+      line_number(0) {
+    input.open(schedule_path, std::ios::binary | std::ios::ate);
+    if (!input.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to open " << schedule_path
+                  << std::endl;
+        std::exit(-1);
+    }
+    file_size = static_cast<uint64_t>(input.tellg());
+    input.seekg(0);
+
+    // a binary file starts with the magic, a text file can't
+    auto header = CollectiveScheduleHeader();
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (input.gcount() == sizeof(header) &&
+        std::memcmp(header.magic, collective_schedule_magic, sizeof(header.magic)) == 0) {
+        if (header.version != collective_schedule_version) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ": version "
+                      << header.version << " not supported" << std::endl;
+            std::exit(-1);
+        }
+        format = ScheduleFormat::Binary;
+        return;
+    }
+
+    // rewind a text file
+    input.clear();
+    input.seekg(0);
+}
+
+bool CollectiveScheduleReader::read(ScheduledSend& send) noexcept {
+    return (format == ScheduleFormat::Binary) ? read_binary(send) : read_text(send);
+}
+
+ScheduleFormat CollectiveScheduleReader::get_format() const noexcept {
+    return format;
+}
+
+bool CollectiveScheduleReader::read_text(ScheduledSend& send) noexcept {
+    while (std::getline(input, line)) {
+        line_number++;
+
+        // parse step, src, dest, and size, skipping blank and comment lines
+        const auto* cursor = line.c_str();
+        uint64_t fields[4];
+        auto fields_count = 0;
+        while (fields_count < 4 && parse_field(cursor, fields[fields_count])) {
+            fields_count++;
+        }
+        if (fields_count == 0) {
+            continue;
+        }
+
+        if (fields_count < 4 || fields[0] > UINT32_MAX || fields[1] > INT32_MAX || fields[2] > INT32_MAX ||
+            fields[3] == UINT64_MAX) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ":" << line_number
+                      << ": expected \"step src dest size [dependency ...]\"" << std::endl;
+            std::exit(-1);
+        }
+        if (fields[3] == 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ":" << line_number
+                      << ": send size should be positive" << std::endl;
+            std::exit(-1);
+        }
+        send.step = static_cast<uint32_t>(fields[0]);
+        send.src = static_cast<DeviceId>(fields[1]);
+        send.dest = static_cast<DeviceId>(fields[2]);
+        send.size = fields[3];
+
+        // the rest are dependencies
+        send.dependencies.clear();
+        auto dependency = uint64_t(0);
+        while (parse_field(cursor, dependency)) {
+            if (dependency == UINT64_MAX) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ":"
+                          << line_number << ": invalid dependency" << std::endl;
+                std::exit(-1);
+            }
+            send.dependencies.push_back(dependency);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool CollectiveScheduleReader::read_binary(ScheduledSend& send) noexcept {
+    uint32_t fields[4];
+    input.read(reinterpret_cast<char*>(fields), sizeof(fields));
+    if (input.gcount() == 0) {
+        return false;
+    }
+
+    if (!input) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ": truncated send record"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // src and dest should be device ids, whose range the runner checks against the NPUs count
+    const auto record_offset = static_cast<uint64_t>(input.tellg()) - sizeof(fields);
+    if (fields[1] > INT32_MAX || fields[2] > INT32_MAX) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ": send record at byte "
+                  << record_offset << " from " << fields[1] << " to " << fields[2] << " is not between two devices"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // the dependencies should fit in the rest of the file, before anything is allocated for them
+    const auto remaining_size = file_size - static_cast<uint64_t>(input.tellg());
+    if (remaining_size < sizeof(send.size) || (remaining_size - sizeof(send.size)) / sizeof(uint64_t) < fields[3]) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ": send record at byte "
+                  << record_offset << " has " << fields[3] << " dependencies, more than the file holds" << std::endl;
+        std::exit(-1);
+    }
+
+    send.step = fields[0];
+    send.src = static_cast<DeviceId>(fields[1]);
+    send.dest = static_cast<DeviceId>(fields[2]);
+    send.dependencies.resize(fields[3]);
+    input.read(reinterpret_cast<char*>(&send.size), sizeof(send.size));
+    input.read(reinterpret_cast<char*>(send.dependencies.data()),
+               static_cast<std::streamsize>(send.dependencies.size() * sizeof(uint64_t)));
+    if (!input) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ": truncated send record"
+                  << std::endl;
+        std::exit(-1);
+    }
+    if (send.size == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << schedule_path << ": send record at byte "
+                  << record_offset << " has a zero size" << std::endl;
+        std::exit(-1);
+    }
+    return true;
+}
+
+CollectiveScheduleWriter::CollectiveScheduleWriter(const std::string& schedule_path,
+                                                   const ScheduleFormat format) noexcept
+    : schedule_path(schedule_path),
+      format(format) {
+    output.open(schedule_path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to open " << schedule_path
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    if (format == ScheduleFormat::Binary) {
+        auto header = CollectiveScheduleHeader();
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, collective_schedule_magic, sizeof(header.magic));
+        header.version = collective_schedule_version;
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+}
+
+void CollectiveScheduleWriter::write(const ScheduledSend& send) noexcept {
+    assert(send.src >= 0 && send.dest >= 0);
+
+    if (format == ScheduleFormat::Text) {
+        output << send.step << ' ' << send.src << ' ' << send.dest << ' ' << send.size;
+        for (const auto dependency : send.dependencies) {
+            output << ' ' << dependency;
+        }
+        output << '\n';
+        return;
+    }
+
+    const uint32_t fields[4] = {send.step, static_cast<uint32_t>(send.src), static_cast<uint32_t>(send.dest),
+                                static_cast<uint32_t>(send.dependencies.size())};
+    output.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    output.write(reinterpret_cast<const char*>(&send.size), sizeof(send.size));
+    output.write(reinterpret_cast<const char*>(send.dependencies.data()),
+                 static_cast<std::streamsize>(send.dependencies.size() * sizeof(uint64_t)));
+}
+
+void CollectiveScheduleWriter::close() noexcept {
+    // check every write went through
+    output.close();
+    if (output.fail()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to write " << schedule_path
+                  << std::endl;
+        std::exit(-1);
+    }
+}
@@ -0,0 +1,213 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CollectiveScheduleRunner.h"
+#include "congestion_aware/Chunk.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+CollectiveScheduleRunner::CollectiveScheduleRunner(std::shared_ptr<Topology> topology,
+                                                   const int lookahead_steps) noexcept
+    : topology(std::move(topology)),
+      lookahead_steps(lookahead_steps),
+      has_next_send(false),
+      next_send_id(0),
+      loaded_sends_count(0),
+      peak_loaded_sends_count(0),
+      sent_count(0),
+      start_time(0),
+      finish_time(0) {
+    assert(this->topology != nullptr);
+    assert(this->topology->get_event_queue() != nullptr);
+    assert(lookahead_steps >= 1);
+}
+
+EventTime CollectiveScheduleRunner::run(const std::string& schedule_path) noexcept {
+    // open the schedule, and read ahead its first send
+    reader = std::make_unique<CollectiveScheduleReader>(schedule_path);
+    has_next_send = reader->read(next_send);
+    next_send_id = 0;
+    loaded_sends_count = 0;
+    peak_loaded_sends_count = 0;
+    sent_count = 0;
+
+    // load the first steps, and run until every send arrives
+    const auto event_queue = topology->get_event_queue();
+    start_time = event_queue->get_current_time();
+    finish_time = start_time;
+    load_steps();
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    assert(loaded_steps.empty() && !has_next_send);
+
+    reader.reset();
+    return finish_time - start_time;
+}
+
+uint64_t CollectiveScheduleRunner::get_sent_count() const noexcept {
+    return sent_count;
+}
+
+uint64_t CollectiveScheduleRunner::get_peak_loaded_sends_count() const noexcept {
+    return peak_loaded_sends_count;
+}
+
+void CollectiveScheduleRunner::message_arrived(void* const message_ptr) noexcept {
+    assert(message_ptr != nullptr);
+
+    // recycle the message
+    auto* const message = static_cast<Message*>(message_ptr);
+    auto* const runner = message->runner;
+    const auto send_id = message->send_id;
+    runner->message_pool.release(message);
+
+    runner->complete(send_id);
+}
+
+void CollectiveScheduleRunner::load_steps() noexcept {
+    while (has_next_send && loaded_steps.size() < static_cast<size_t>(lookahead_steps)) {
+        load_step();
+    }
+}
+
+void CollectiveScheduleRunner::load_step() noexcept {
+    assert(has_next_send);
+
+    // reuse the storage of a released step
+    if (spare_steps.empty()) {
+        loaded_steps.emplace_back();
+    } else {
+        loaded_steps.push_back(std::move(spare_steps.back()));
+        spare_steps.pop_back();
+    }
+    auto& loaded_step = loaded_steps.back();
+    loaded_step.step = next_send.step;
+    loaded_step.first_send_id = next_send_id;
+    loaded_step.remaining_sends_count = 0;
+    loaded_step.sends.clear();
+    loaded_step.dependents.clear();
+
+    // load every send of the step
+    const auto npus_count = topology->get_npus_count();
+    do {
+        const auto send_id = next_send_id;
+        if (next_send.src < 0 || next_send.src >= npus_count || next_send.dest < 0 || next_send.dest >= npus_count ||
+            next_send.src == next_send.dest) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "send " << send_id << " from "
+                      << next_send.src << " to " << next_send.dest << " is not between two NPUs" << std::endl;
+            std::exit(-1);
+        }
+
+        auto send = SendState{next_send.src, next_send.dest, next_send.size, 0, -1, false};
+        for (const auto dependency : next_send.dependencies) {
+            if (dependency >= loaded_step.first_send_id) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) " << "send " << send_id
+                          << " should only depend on sends of earlier steps, but depends on " << dependency
+                          << std::endl;
+                std::exit(-1);
+            }
+
+            // sends of released steps have arrived
+            if (dependency < loaded_steps.front().first_send_id) {
+                continue;
+            }
+            auto& dependency_step = find_step(dependency);
+            auto& dependency_send = dependency_step.sends[dependency - dependency_step.first_send_id];
+            if (dependency_send.arrived) {
+                continue;
+            }
+            dependency_step.dependents.push_back({send_id, dependency_send.first_dependent});
+            dependency_send.first_dependent = static_cast<int64_t>(dependency_step.dependents.size()) - 1;
+            send.pending_dependencies_count++;
+        }
+
+        loaded_step.sends.push_back(send);
+        loaded_step.remaining_sends_count++;
+        loaded_sends_count++;
+        next_send_id++;
+        has_next_send = reader->read(next_send);
+    } while (has_next_send && next_send.step == loaded_step.step);
+
+    if (has_next_send && next_send.step < loaded_step.step) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "send " << next_send_id << " of step "
+                  << next_send.step << " comes after step " << loaded_step.step
+                  << ", but sends should be sorted by step" << std::endl;
+        std::exit(-1);
+    }
+    peak_loaded_sends_count = std::max(peak_loaded_sends_count, loaded_sends_count);
+
+    // issue the sends with no pending dependencies
+    for (auto i = size_t(0); i < loaded_step.sends.size(); i++) {
+        if (loaded_step.sends[i].pending_dependencies_count == 0) {
+            issue(loaded_step.first_send_id + i, loaded_step.sends[i]);
+        }
+    }
+}
+
+CollectiveScheduleRunner::LoadedStep& CollectiveScheduleRunner::find_step(const uint64_t send_id) noexcept {
+    assert(!loaded_steps.empty());
+    assert(loaded_steps.front().first_send_id <= send_id);
+
+    // the last step starting at or before the send
+    const auto step = std::upper_bound(
+        loaded_steps.begin(), loaded_steps.end(), send_id,
+        [](const uint64_t id, const LoadedStep& loaded_step) { return id < loaded_step.first_send_id; });
+    assert(send_id - std::prev(step)->first_send_id < std::prev(step)->sends.size());
+    return *std::prev(step);
+}
+
+void CollectiveScheduleRunner::issue(const uint64_t send_id, const SendState& send) noexcept {
+    auto* const message = message_pool.acquire();
+    message->runner = this;
+    message->send_id = send_id;
+
+    // send the message as a chunk
+    auto chunk = topology->create_chunk(send.size, topology->shared_route(send.src, send.dest), message_arrived,
+                                        message);
+    topology->send(std::move(chunk));
+    sent_count++;
+}
+
+void CollectiveScheduleRunner::complete(const uint64_t send_id) noexcept {
+    auto& step = find_step(send_id);
+    auto& send = step.sends[send_id - step.first_send_id];
+    assert(!send.arrived);
+    send.arrived = true;
+    step.remaining_sends_count--;
+
+    // issue the dependent sends whose dependencies have all arrived
+    for (auto edge = send.first_dependent; edge >= 0; edge = step.dependents[edge].next) {
+        const auto dependent_id = step.dependents[edge].dependent_id;
+        auto& dependent_step = find_step(dependent_id);
+        auto& dependent_send = dependent_step.sends[dependent_id - dependent_step.first_send_id];
+        assert(dependent_send.pending_dependencies_count > 0);
+        dependent_send.pending_dependencies_count--;
+        if (dependent_send.pending_dependencies_count == 0) {
+            issue(dependent_id, dependent_send);
+        }
+    }
+
+    // release the finished steps, and load the next ones
+    auto released = false;
+    while (!loaded_steps.empty() && loaded_steps.front().remaining_sends_count == 0) {
+        loaded_sends_count -= loaded_steps.front().sends.size();
+        spare_steps.push_back(std::move(loaded_steps.front()));
+        loaded_steps.pop_front();
+        released = true;
+    }
+    if (released) {
+        load_steps();
+    }
+
+    if (loaded_steps.empty() && !has_next_send) {
+        finish_time = topology->get_event_queue()->get_current_time();
+    }
+}
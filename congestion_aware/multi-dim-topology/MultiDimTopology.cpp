@@ -0,0 +1,186 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/MultiDimTopology.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+MultiDimTopology::MultiDimTopology(const std::vector<TopologyBuildingBlock>& topology_per_dim,
+                                   const std::vector<int>& npus_count_per_dim,
+                                   const std::vector<Bandwidth>& bandwidth_per_dim,
+                                   const std::vector<Latency>& latency_per_dim) noexcept
+    : Topology(),
+      topology_per_dim(topology_per_dim) {
+    assert(!topology_per_dim.empty());
+    assert(npus_count_per_dim.size() == topology_per_dim.size());
+    assert(bandwidth_per_dim.size() == topology_per_dim.size());
+    assert(latency_per_dim.size() == topology_per_dim.size());
+
+    // setup topology shape
+    dims_count = static_cast<int>(topology_per_dim.size());
+    this->npus_count_per_dim = npus_count_per_dim;
+    this->bandwidth_per_dim = bandwidth_per_dim;
+
+    npus_count = 1;
+    for (const auto npus_count_of_dim : npus_count_per_dim) {
+        assert(npus_count_of_dim > 0);
+        stride_per_dim.push_back(npus_count);
+        npus_count *= npus_count_of_dim;
+    }
+
+    // switches are placed after the NPUs:
+    // each Switch dimension has one switch per group of NPUs differing only in that dimension
+    devices_count = npus_count;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (topology_per_dim[dim] != TopologyBuildingBlock::Switch) {
+            first_switch_id_per_dim.push_back(-1);
+            continue;
+        }
+
+        first_switch_id_per_dim.push_back(devices_count);
+        devices_count += npus_count / npus_count_per_dim[dim];
+    }
+
+    // instantiate devices
+    instantiate_devices();
+
+    // connect each dimension
+    for (auto dim = 0; dim < dims_count; dim++) {
+        assert(bandwidth_per_dim[dim] > 0);
+        assert(latency_per_dim[dim] >= 0);
+        connect_dimension(dim, bandwidth_per_dim[dim], latency_per_dim[dim]);
+    }
+
+    // instantiate links
+    build_links();
+}
+
+Route MultiDimTopology::route(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // start at source
+    auto route = Route();
+    route.push_back(devices[src]);
+
+    // move along each dimension in order
+    auto current = src;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto dest_address = address_of(dest, dim);
+        if (address_of(current, dim) != dest_address) {
+            current = route_dimension(route, current, dim, dest_address);
+        }
+    }
+
+    // arrives at dest
+    assert(current == dest);
+    return route;
+}
+
+int MultiDimTopology::address_of(const DeviceId npu_id, const int dim) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+    assert(0 <= dim && dim < dims_count);
+
+    return (npu_id / stride_per_dim[dim]) % npus_count_per_dim[dim];
+}
+
+DeviceId MultiDimTopology::switch_of(const DeviceId npu_id, const int dim) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+    assert(topology_per_dim[dim] == TopologyBuildingBlock::Switch);
+
+    // index the group by the NPU id without its address in the dimension
+    const auto stride = stride_per_dim[dim];
+    const auto group = (npu_id / (stride * npus_count_per_dim[dim])) * stride + (npu_id % stride);
+
+    return first_switch_id_per_dim[dim] + group;
+}
+
+void MultiDimTopology::connect_dimension(const int dim, const Bandwidth bandwidth, const Latency latency) noexcept {
+    const auto dim_size = npus_count_per_dim[dim];
+    const auto stride = stride_per_dim[dim];
+
+    for (auto npu = 0; npu < npus_count; npu++) {
+        const auto address = address_of(npu, dim);
+        const auto base = npu - (address * stride);
+
+        switch (topology_per_dim[dim]) {
+        case TopologyBuildingBlock::Ring:
+            // connect each NPU to its next neighbor, bidirectionally
+            // a ring of 2 NPUs has a single pair of links
+            if (dim_size > 2 || (dim_size == 2 && address == 0)) {
+                connect(npu, base + ((address + 1) % dim_size) * stride, bandwidth, latency, true);
+            }
+            break;
+        case TopologyBuildingBlock::FullyConnected:
+            // connect each NPU to every other NPU of the dimension
+            for (auto other = 0; other < dim_size; other++) {
+                if (other != address) {
+                    connect(npu, base + other * stride, bandwidth, latency, false);
+                }
+            }
+            break;
+        case TopologyBuildingBlock::Switch:
+            // connect each NPU to the switch of its group
+            connect(npu, switch_of(npu, dim), bandwidth, latency, true);
+            break;
+        default:
+            // shouldn't reach here
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported basic-topology"
+                      << std::endl;
+            std::exit(-1);
+        }
+    }
+}
+
+DeviceId MultiDimTopology::route_dimension(Route& route,
+                                           const DeviceId current,
+                                           const int dim,
+                                           const int dest_address) const noexcept {
+    const auto dim_size = npus_count_per_dim[dim];
+    const auto stride = stride_per_dim[dim];
+    const auto address = address_of(current, dim);
+    const auto base = current - (address * stride);
+    const auto dest = base + dest_address * stride;
+
+    switch (topology_per_dim[dim]) {
+    case TopologyBuildingBlock::Ring: {
+        // check whether going anticlockwise is shorter
+        auto clockwise_dist = dest_address - address;
+        if (clockwise_dist < 0) {
+            clockwise_dist += dim_size;
+        }
+        const auto anticlockwise_dist = dim_size - clockwise_dist;
+        const auto step = (anticlockwise_dist < clockwise_dist) ? -1 : 1;
+
+        // traverse the ring until reaches dest
+        auto hop_address = address;
+        while (hop_address != dest_address) {
+            hop_address = (hop_address + step + dim_size) % dim_size;
+            route.push_back(devices[base + hop_address * stride]);
+        }
+        break;
+    }
+    case TopologyBuildingBlock::FullyConnected:
+        // directly connected
+        route.push_back(devices[dest]);
+        break;
+    case TopologyBuildingBlock::Switch:
+        // go to the switch, then go to destination
+        route.push_back(devices[switch_of(current, dim)]);
+        route.push_back(devices[dest]);
+        break;
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported basic-topology" << std::endl;
+        std::exit(-1);
+    }
+
+    return dest;
+}
@@ -4,12 +4,33 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/ChunkPool.h"
 #include "congestion_aware/Device.h"
 #include "congestion_aware/Link.h"
 #include <cassert>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+namespace {
+
+/**
+ * Resolve a list route into a RoutePath of its own.
+ */
+SharedRoute resolve_route(const Route& route) noexcept {
+    assert(!route.empty());
+
+    auto route_path = std::make_shared<RoutePath>();
+    route_path->devices.assign(route.begin(), route.end());
+    for (auto i = static_cast<size_t>(1); i < route_path->devices.size(); i++) {
+        const auto& device = route_path->devices[i - 1];
+        route_path->links.push_back(device->link_to(route_path->devices[i]->get_id()));
+    }
+
+    return route_path;
+}
+
+}  // namespace
+
 void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     assert(chunk_ptr != nullptr);
 
@@ -25,36 +46,91 @@ void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
         chunk->invoke_callback();
     } else {
         // send this chunk to next dest
-        const auto current_node = chunk->current_device();
-        current_node->send(std::move(chunk));  // send chunk to next des
+        auto* const next_link = chunk->next_link();
+        next_link->send(std::move(chunk));  // send chunk to next des
     }
 }
 
-Chunk::Chunk(const ChunkSize chunk_size, Route route, const Callback callback, const CallbackArg callback_arg) noexcept
+void* Chunk::operator new([[maybe_unused]] const size_t size) {
+    assert(size == sizeof(Chunk));
+
+    return ChunkPool::allocate_unpooled();
+}
+
+void* Chunk::operator new([[maybe_unused]] const size_t size, ChunkPool& chunk_pool) {
+    assert(size == sizeof(Chunk));
+
+    return chunk_pool.acquire();
+}
+
+void Chunk::operator delete(void* const chunk_storage) noexcept {
+    if (chunk_storage == nullptr) {
+        return;
+    }
+
+    ChunkPool::release(chunk_storage);
+}
+
+void Chunk::operator delete(void* const chunk_storage, ChunkPool&) noexcept {
+    ChunkPool::release(chunk_storage);
+}
+
+Chunk::Chunk(const ChunkSize chunk_size,
+             const Route& route,
+             const Callback callback,
+             const CallbackArg callback_arg) noexcept
+    : Chunk(chunk_size, resolve_route(route), callback, callback_arg) {}
+
+Chunk::Chunk(const ChunkSize chunk_size,
+             SharedRoute route,
+             const Callback callback,
+             const CallbackArg callback_arg) noexcept
+    : Chunk(chunk_size, 1, std::move(route), callback, callback_arg) {}
+
+Chunk::Chunk(const ChunkSize chunk_size,
+             const int items_count,
+             SharedRoute route,
+             const Callback callback,
+             const CallbackArg callback_arg) noexcept
     : chunk_size(chunk_size),
+      items_count(items_count),
       route(std::move(route)),
+      route_cursor(0),
+      tail_arrival_time(0),
+      item_spacing(0),
       callback(callback),
-      callback_arg(callback_arg) {
+      callback_arg(callback_arg),
+      next_queued(nullptr) {
     assert(chunk_size > 0);
-    assert(!this->route.empty());
+    assert(items_count > 0);
+    assert(this->route != nullptr);
+    assert(!this->route->devices.empty());
+    assert(this->route->links.size() + 1 == this->route->devices.size());
     assert(callback != nullptr);
 }
 
-std::shared_ptr<Device> Chunk::current_device() const noexcept {
-    // assert the route is not empty
-    assert(!route.empty());
+const std::shared_ptr<Device>& Chunk::current_device() const noexcept {
+    // assert the cursor is within the route
+    assert(route_cursor < route->devices.size());
 
-    // return the first npu in route
-    return route.front();
+    // return the device at the cursor
+    return route->devices[route_cursor];
 }
 
-std::shared_ptr<Device> Chunk::next_device() const noexcept {
+const std::shared_ptr<Device>& Chunk::next_device() const noexcept {
     // assert the chunk has next dest
     assert(!arrived_dest());
 
     // return next dest
-    const auto next_dest = std::next(route.begin(), 1);
-    return *next_dest;
+    return route->devices[route_cursor + 1];
+}
+
+Link* Chunk::next_link() const noexcept {
+    // assert the chunk has next dest
+    assert(!arrived_dest());
+
+    // return the link to next dest
+    return route->links[route_cursor];
 }
 
 void Chunk::mark_arrived_next_device() noexcept {
@@ -62,15 +138,39 @@ void Chunk::mark_arrived_next_device() noexcept {
     // it means the chunk hasn't arrived its final dest yet
     assert(!arrived_dest());
 
-    // pop previous node from the route
+    // advance the cursor
     // marking the current node has been changed
-    route.pop_front();
+    route_cursor++;
 }
 
 bool Chunk::arrived_dest() const noexcept {
-    // if a chunk arrived dest, route length should be 1
-    // i.e., only containing the dest node
-    return route.size() == 1;
+    // if a chunk arrived dest, the cursor should point to the last device
+    // i.e., the dest node
+    return route_cursor == route->links.size();
+}
+
+bool Chunk::next_device_is_dest() const noexcept {
+    // assert the chunk has next dest
+    assert(!arrived_dest());
+
+    // the next device is the last one of the route
+    return route_cursor + 1 == route->links.size();
+}
+
+EventTime Chunk::get_tail_arrival_time() const noexcept {
+    return tail_arrival_time;
+}
+
+void Chunk::set_tail_arrival_time(const EventTime tail_arrival_time) noexcept {
+    this->tail_arrival_time = tail_arrival_time;
+}
+
+EventTime Chunk::get_item_spacing() const noexcept {
+    return item_spacing;
+}
+
+void Chunk::set_item_spacing(const EventTime item_spacing) noexcept {
+    this->item_spacing = item_spacing;
 }
 
 ChunkSize Chunk::get_size() const noexcept {
@@ -80,6 +180,21 @@ ChunkSize Chunk::get_size() const noexcept {
     return chunk_size;
 }
 
+int Chunk::get_items_count() const noexcept {
+    assert(items_count > 0);
+
+    // return items count
+    return items_count;
+}
+
+Callback Chunk::get_callback() const noexcept {
+    return callback;
+}
+
+CallbackArg Chunk::get_callback_arg() const noexcept {
+    return callback_arg;
+}
+
 void Chunk::invoke_callback() noexcept {
     // invoke callback
     (*callback)(callback_arg);
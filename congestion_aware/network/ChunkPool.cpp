@@ -0,0 +1,100 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkPool.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+ChunkPool::ChunkPool() noexcept
+    : free_list(nullptr),
+      concurrent_release(false),
+      released_list(nullptr) {
+    // create empty pool
+    slabs = std::vector<std::unique_ptr<Slot[]>>();
+}
+
+void* ChunkPool::acquire() noexcept {
+    // take over the slots released concurrently, then grow the pool if there's still no free slot
+    if (free_list == nullptr) {
+        free_list = released_list.exchange(nullptr, std::memory_order_acquire);
+    }
+    if (free_list == nullptr) {
+        allocate_slab();
+    }
+
+    // pop a free slot
+    auto* const slot = free_list;
+    free_list = slot->next;
+    slot->next = nullptr;
+
+    return slot->storage;
+}
+
+void* ChunkPool::allocate_unpooled() noexcept {
+    // allocate a slot belonging to no pool
+    auto* const slot = new Slot();
+    slot->pool = nullptr;
+    slot->next = nullptr;
+
+    return slot->storage;
+}
+
+void ChunkPool::release(void* const chunk_storage) noexcept {
+    assert(chunk_storage != nullptr);
+
+    auto* const slot = slot_of(chunk_storage);
+    auto* const pool = slot->pool;
+
+    // return an unpooled slot to the heap
+    if (pool == nullptr) {
+        delete slot;
+        return;
+    }
+
+    // push the slot onto the released list, which any thread may do
+    if (pool->concurrent_release) {
+        slot->next = pool->released_list.load(std::memory_order_relaxed);
+        while (!pool->released_list.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                                          std::memory_order_relaxed)) {
+        }
+        return;
+    }
+
+    // push the slot back to the free list of its pool
+    slot->next = pool->free_list;
+    pool->free_list = slot;
+}
+
+void ChunkPool::set_concurrent_release(const bool concurrent_release) noexcept {
+    this->concurrent_release = concurrent_release;
+}
+
+uint64_t ChunkPool::get_chunks_allocated_count() const noexcept {
+    return slabs.size() * slab_size;
+}
+
+ChunkPool::Slot* ChunkPool::slot_of(void* const chunk_storage) noexcept {
+    assert(chunk_storage != nullptr);
+
+    // storage is at a fixed offset of the slot
+    auto* const slot_address = static_cast<unsigned char*>(chunk_storage) - offsetof(Slot, storage);
+    return reinterpret_cast<Slot*>(slot_address);
+}
+
+void ChunkPool::allocate_slab() noexcept {
+    assert(free_list == nullptr);
+
+    // allocate a slab
+    slabs.push_back(std::make_unique<Slot[]>(slab_size));
+    auto* const slab = slabs.back().get();
+
+    // thread the slots onto the free list, in address order
+    for (auto i = slab_size; i > 0; i--) {
+        slab[i - 1].pool = this;
+        slab[i - 1].next = free_list;
+        free_list = &slab[i - 1];
+    }
+}
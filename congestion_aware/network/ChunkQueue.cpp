@@ -0,0 +1,58 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkQueue.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+ChunkQueue::ChunkQueue() noexcept : head(nullptr), tail(nullptr) {}
+
+ChunkQueue::ChunkQueue(ChunkQueue&& other) noexcept : head(other.head), tail(other.tail) {
+    other.head = nullptr;
+    other.tail = nullptr;
+}
+
+ChunkQueue::~ChunkQueue() noexcept {
+    // destroy the chunks left
+    while (!empty()) {
+        (void)pop();
+    }
+}
+
+void ChunkQueue::push(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // the queue takes the ownership
+    auto* const chunk_ptr = chunk.release();
+    chunk_ptr->next_queued = nullptr;
+
+    // append to the back
+    if (tail == nullptr) {
+        head = chunk_ptr;
+    } else {
+        tail->next_queued = chunk_ptr;
+    }
+    tail = chunk_ptr;
+}
+
+std::unique_ptr<Chunk> ChunkQueue::pop() noexcept {
+    // queue should not be empty
+    assert(!empty());
+
+    // detach the front chunk
+    auto* const chunk_ptr = head;
+    head = chunk_ptr->next_queued;
+    if (head == nullptr) {
+        tail = nullptr;
+    }
+    chunk_ptr->next_queued = nullptr;
+
+    return std::unique_ptr<Chunk>(chunk_ptr);
+}
+
+bool ChunkQueue::empty() const noexcept {
+    return head == nullptr;
+}
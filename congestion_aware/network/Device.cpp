@@ -5,12 +5,19 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Device.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/LazyLinkTable.h"
 #include "congestion_aware/Link.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalyticalCongestionAware;
 
-Device::Device(const DeviceId id) noexcept : device_id(id) {
+Device::Device(const DeviceId id) noexcept
+    : device_id(id),
+      links(nullptr),
+      link_dests(nullptr),
+      links_count(0),
+      lazy_link_table(nullptr) {
     assert(id >= 0);
 }
 
@@ -30,33 +37,72 @@ void Device::send(std::unique_ptr<Chunk> chunk) noexcept {
     // assert the chunk hasn't arrived its final destination yet
     assert(!chunk->arrived_dest());
 
-    // get next dest
-    const auto next_dest = chunk->next_device();
-    const auto next_dest_id = next_dest->get_id();
-
-    // assert the next dest is connected to this node
-    assert(connected(next_dest_id));
+    // assert the route takes a link of this device, which the route has instantiated already
+    assert(chunk->next_link() == instantiated_link_to(chunk->next_device()->get_id()));
 
     // send the chunk to the next dest
     // delegate this task to the link
-    links[next_dest_id]->send(std::move(chunk));
+    auto* const link = chunk->next_link();
+    link->send(std::move(chunk));
 }
 
-void Device::connect(const DeviceId id, const Bandwidth bandwidth, const Latency latency) noexcept {
-    assert(id >= 0);
-    assert(bandwidth > 0);
-    assert(latency >= 0);
+void Device::set_links(Link* const links, const DeviceId* const link_dests, const int links_count) noexcept {
+    assert(links_count >= 0);
+    assert(links_count == 0 || (links != nullptr && link_dests != nullptr));
+
+    // dest device ids should be sorted
+    assert(std::is_sorted(link_dests, link_dests + links_count));
+
+    this->links = links;
+    this->link_dests = link_dests;
+    this->links_count = links_count;
+}
 
-    // assert there's no existing connection
-    assert(!connected(id));
+void Device::set_lazy_link_table(LazyLinkTable* const lazy_link_table) noexcept {
+    assert(lazy_link_table != nullptr);
 
-    // create link
-    links[id] = std::make_shared<Link>(bandwidth, latency);
+    this->lazy_link_table = lazy_link_table;
 }
 
-bool Device::connected(const DeviceId dest) const noexcept {
+Link* Device::link_to(const DeviceId dest) const noexcept {
     assert(dest >= 0);
 
-    // check whether the connection exists
-    return links.find(dest) != links.end();
+    // adjacency link
+    const auto index = find_link(dest);
+    if (index >= 0) {
+        return links + index;
+    }
+
+    // otherwise, the connection should be lazily instantiated
+    assert(lazy_link_table != nullptr);
+    return lazy_link_table->link(device_id, dest);
+}
+
+const Link* Device::instantiated_link_to(const DeviceId dest) const noexcept {
+    assert(dest >= 0);
+
+    // adjacency link
+    const auto index = find_link(dest);
+    if (index >= 0) {
+        return links + index;
+    }
+
+    // lazy link, if already instantiated
+    if (lazy_link_table == nullptr) {
+        return nullptr;
+    }
+    return lazy_link_table->find_link(device_id, dest);
+}
+
+int Device::find_link(const DeviceId dest) const noexcept {
+    assert(dest >= 0);
+
+    // binary search the sorted dest device ids
+    const auto* const link_dests_end = link_dests + links_count;
+    const auto* const found = std::lower_bound(link_dests, link_dests_end, dest);
+    if (found == link_dests_end || *found != dest) {
+        return -1;
+    }
+
+    return static_cast<int>(found - link_dests);
 }
@@ -0,0 +1,122 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LazyLinkTable.h"
+#include "congestion_aware/Chunk.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+LazyLinkTable::LazyLinkTable(const int devices_count, const Bandwidth bandwidth, const Latency latency) noexcept
+    : devices_count(devices_count),
+      bandwidth(bandwidth),
+      latency(latency),
+      event_queue(nullptr),
+      link_mode(LinkMode::LinkFreeEvent),
+      mtu(0) {
+    assert(devices_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    device_event_queues = {};
+    links = std::deque<Link>();
+    links_index = {};
+}
+
+Link* LazyLinkTable::link(const DeviceId src, const DeviceId dest) noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+    assert(src != dest);
+
+    // look up the instantiated links
+    const auto key = static_cast<int64_t>(src) * devices_count + dest;
+    auto& link_ptr = links_index[key];
+
+    // instantiate the link on its first use
+    if (link_ptr == nullptr) {
+        auto& new_link = links.emplace_back(bandwidth, latency);
+        if (!device_event_queues.empty()) {
+            new_link.set_event_queue(device_event_queues[src]);
+            new_link.set_arrival_event_queue(device_event_queues[dest]);
+        } else if (event_queue != nullptr) {
+            new_link.set_event_queue(event_queue);
+        }
+        new_link.set_link_mode(link_mode);
+        new_link.set_mtu(mtu);
+        link_ptr = &new_link;
+    }
+
+    return link_ptr;
+}
+
+const Link* LazyLinkTable::find_link(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+    assert(src != dest);
+
+    // look up the instantiated links only
+    const auto key = static_cast<int64_t>(src) * devices_count + dest;
+    const auto link_ptr = links_index.find(key);
+    return (link_ptr != links_index.end()) ? link_ptr->second : nullptr;
+}
+
+void LazyLinkTable::set_event_queue(EventQueue* const event_queue) noexcept {
+    assert(event_queue != nullptr);
+
+    // pass the given event_queue to all instantiated links
+    for (auto& link : links) {
+        link.set_event_queue(event_queue);
+    }
+
+    // hold the event queue for the future links
+    this->event_queue = event_queue;
+    device_event_queues.clear();
+}
+
+void LazyLinkTable::set_device_event_queues(std::vector<EventQueue*> device_event_queues) noexcept {
+    assert(device_event_queues.size() == devices_count);
+
+    // pass the event queues of the src and dest devices to all instantiated links
+    for (const auto& [key, link] : links_index) {
+        const auto src = static_cast<DeviceId>(key / devices_count);
+        const auto dest = static_cast<DeviceId>(key % devices_count);
+        link->set_event_queue(device_event_queues[src]);
+        link->set_arrival_event_queue(device_event_queues[dest]);
+    }
+
+    // hold the event queues for the future links
+    this->device_event_queues = std::move(device_event_queues);
+}
+
+void LazyLinkTable::set_link_mode(const LinkMode link_mode) noexcept {
+    // pass the given link_mode to all instantiated links
+    for (auto& link : links) {
+        link.set_link_mode(link_mode);
+    }
+
+    // hold the link mode for the future links
+    this->link_mode = link_mode;
+}
+
+void LazyLinkTable::set_mtu(const ChunkSize mtu) noexcept {
+    // pass the given mtu to all instantiated links
+    for (auto& link : links) {
+        link.set_mtu(mtu);
+    }
+
+    // hold the mtu for the future links
+    this->mtu = mtu;
+}
+
+Latency LazyLinkTable::get_latency() const noexcept {
+    return latency;
+}
+
+int LazyLinkTable::get_links_count() const noexcept {
+    return static_cast<int>(links.size());
+}
@@ -7,14 +7,12 @@ LICENSE file in the root directory of this source tree.
 #include "common/NetworkFunction.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Device.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-// declaring static event_queue
-std::shared_ptr<EventQueue> Link::event_queue;
-
 void Link::link_become_free(void* const link_ptr) noexcept {
     assert(link_ptr != nullptr);
 
@@ -22,6 +20,7 @@ void Link::link_become_free(void* const link_ptr) noexcept {
     auto* const link = static_cast<Link*>(link_ptr);
 
     // set link free
+    link->link_free_scheduled = false;
     link->set_free();
 
     // process pending chunks if one exist
@@ -30,18 +29,18 @@ void Link::link_become_free(void* const link_ptr) noexcept {
     }
 }
 
-void Link::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
-    assert(event_queue_ptr != nullptr);
-
-    // set the event queue
-    Link::event_queue = std::move(event_queue_ptr);
-}
-
 Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
-    : bandwidth(bandwidth),
+    : event_queue(nullptr),
+      arrival_event_queue(nullptr),
+      bandwidth(bandwidth),
       latency(latency),
       pending_chunks(),
-      busy(false) {
+      busy(false),
+      link_mode(LinkMode::LinkFreeEvent),
+      mtu(0),
+      busy_until(0),
+      link_free_sequence(0),
+      link_free_scheduled(false) {
     assert(bandwidth > 0);
     assert(latency >= 0);
 
@@ -49,12 +48,61 @@ Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
     bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
 }
 
+void Link::set_event_queue(EventQueue* const event_queue_ptr) noexcept {
+    assert(event_queue_ptr != nullptr);
+
+    // set the event queue
+    event_queue = event_queue_ptr;
+    arrival_event_queue = event_queue_ptr;
+}
+
+void Link::set_arrival_event_queue(EventQueue* const event_queue_ptr) noexcept {
+    assert(event_queue_ptr != nullptr);
+
+    // set the event queue of the dest device
+    arrival_event_queue = event_queue_ptr;
+}
+
+Latency Link::get_latency() const noexcept {
+    return latency;
+}
+
+Bandwidth Link::get_bandwidth_Bpns() const noexcept {
+    return bandwidth_Bpns;
+}
+
+void Link::set_link_mode(const LinkMode link_mode) noexcept {
+    // link should be idle
+    assert(!busy);
+    assert(!pending_chunk_exists());
+
+    this->link_mode = link_mode;
+}
+
+void Link::set_mtu(const ChunkSize mtu) noexcept {
+    // link should be idle
+    assert(!busy);
+    assert(!pending_chunk_exists());
+
+    this->mtu = mtu;
+}
+
 void Link::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
+    // the link may have become free without a link-free event
+    if (link_mode == LinkMode::BusyUntil) {
+        update_busy();
+    }
+
     if (busy) {
         // link is busy, add to pending chunks
-        pending_chunks.push_back(std::move(chunk));
+        pending_chunks.push(std::move(chunk));
+
+        // the pending chunk now waits for the link-free event
+        if (link_mode == LinkMode::BusyUntil && !link_free_scheduled) {
+            schedule_link_free();
+        }
     } else {
         // service this chunk immediately
         schedule_chunk_transmission(std::move(chunk));
@@ -66,8 +114,7 @@ void Link::process_pending_transmission() noexcept {
     assert(pending_chunk_exists());
 
     // get chunk to process
-    auto chunk = std::move(pending_chunks.front());
-    pending_chunks.pop_front();
+    auto chunk = pending_chunks.pop();
 
     // service this chunk
     schedule_chunk_transmission(std::move(chunk));
@@ -114,22 +161,122 @@ void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
     // link should be free
     assert(!busy);
 
+    // event queue should be set
+    assert(event_queue != nullptr);
+
     // set link busy
     set_busy();
 
     // get metadata
     const auto chunk_size = chunk->get_size();
-    const auto current_time = Link::event_queue->get_current_time();
+    const auto current_time = event_queue->get_current_time();
 
-    // schedule chunk arrival event
-    const auto communication_time = communication_delay(chunk_size);
-    const auto chunk_arrival_time = current_time + communication_time;
-    auto* const chunk_ptr = static_cast<void*>(chunk.release());
-    Link::event_queue->schedule_event(chunk_arrival_time, Chunk::chunk_arrived_next_device, chunk_ptr);
+    auto link_free_time = current_time;
+    if (chunk->get_items_count() > 1 || (mtu > 0 && chunk_size > mtu)) {
+        // forward the batch or the packetized chunk as a packet train
+        link_free_time = schedule_packet_train_transmission(std::move(chunk), current_time);
+    } else {
+        // schedule chunk arrival event
+        const auto communication_time = communication_delay(chunk_size);
+        schedule_arrival(current_time + communication_time, Chunk::chunk_arrived_next_device, chunk.release());
+
+        // schedule link free time
+        const auto serialization_time = serialization_delay(chunk_size);
+        link_free_time = current_time + serialization_time;
+    }
+
+    // schedule the link-free event
+    if (link_mode == LinkMode::LinkFreeEvent) {
+        auto* const link_ptr = static_cast<void*>(this);
+        event_queue->schedule_event(link_free_time, link_become_free, link_ptr);
+        return;
+    }
+
+    // BusyUntil mode: only reserve the link-free event's place in the event order,
+    // and schedule it once a chunk has to wait for it
+    busy_until = link_free_time;
+    link_free_sequence = event_queue->reserve_sequence();
+    if (pending_chunk_exists()) {
+        schedule_link_free();
+    }
+}
 
-    // schedule link free time
-    const auto serialization_time = serialization_delay(chunk_size);
-    const auto link_free_time = current_time + serialization_time;
+EventTime Link::schedule_packet_train_transmission(std::unique_ptr<Chunk> chunk,
+                                                   const EventTime current_time) noexcept {
+    assert(chunk != nullptr);
+
+    // split each item into packets of up to the MTU, the last one possibly smaller
+    const auto chunk_size = chunk->get_size();
+    const auto items_count = chunk->get_items_count();
+    const auto packet_size = (mtu > 0 && chunk_size > mtu) ? mtu : chunk_size;
+    const auto last_packet_size = chunk_size - (((chunk_size - 1) / packet_size) * packet_size);
+
+    // the link serializes the items back-to-back, but can't serialize the last packet before it has arrived
+    const auto tail_arrival_time = chunk->get_tail_arrival_time();
+    const auto tail_wait_time = (tail_arrival_time > current_time) ? (tail_arrival_time - current_time) : 0;
+    const auto item_serialization_time = serialization_delay(chunk_size);
+    const auto last_packet_serialization_time = serialization_delay(last_packet_size);
+    const auto busy_time =
+        std::max(items_count * item_serialization_time, tail_wait_time + last_packet_serialization_time);
+    const auto link_free_time = current_time + busy_time;
+
+    // the last packet starts its serialization last
+    const auto next_tail_arrival_time =
+        link_free_time - last_packet_serialization_time + communication_delay(last_packet_size);
+    chunk->set_tail_arrival_time(next_tail_arrival_time);
+
+    // the items leave this link no closer than they arrived at it, nor than it serializes them
+    const auto item_spacing = std::max(chunk->get_item_spacing(), item_serialization_time);
+    chunk->set_item_spacing(item_spacing);
+
+    // the next link can forward the train once its first packet has arrived
+    if (!chunk->next_device_is_dest()) {
+        const auto head_arrival_time = current_time + communication_delay(packet_size);
+        schedule_arrival(head_arrival_time, Chunk::chunk_arrived_next_device, chunk.release());
+        return link_free_time;
+    }
+
+    // the destination receives the items one spacing apart, the last one with the chunk itself
+    for (auto item = 1; item < items_count; item++) {
+        const auto item_arrival_time = next_tail_arrival_time - (item * item_spacing);
+        schedule_arrival(item_arrival_time, chunk->get_callback(), chunk->get_callback_arg());
+    }
+    schedule_arrival(next_tail_arrival_time, Chunk::chunk_arrived_next_device, chunk.release());
+    return link_free_time;
+}
+
+void Link::schedule_arrival(const EventTime arrival_time,
+                            const Callback callback,
+                            const CallbackArg callback_arg) noexcept {
+    if (arrival_event_queue == event_queue) {
+        event_queue->schedule_event(arrival_time, callback, callback_arg);
+    } else {
+        // the next device belongs to another partition of a parallel simulation
+        event_queue->schedule_remote_event(*arrival_event_queue, arrival_time, callback, callback_arg);
+    }
+}
+
+void Link::schedule_link_free() noexcept {
+    assert(link_mode == LinkMode::BusyUntil);
+    assert(busy);
+    assert(!link_free_scheduled);
+
+    // schedule the link-free event in its reserved place
     auto* const link_ptr = static_cast<void*>(this);
-    Link::event_queue->schedule_event(link_free_time, link_become_free, link_ptr);
+    event_queue->schedule_reserved_event(busy_until, link_free_sequence, link_become_free, link_ptr);
+    link_free_scheduled = true;
+}
+
+void Link::update_busy() noexcept {
+    assert(link_mode == LinkMode::BusyUntil);
+
+    // a scheduled link-free event sets the link free by itself
+    if (!busy || link_free_scheduled) {
+        return;
+    }
+
+    // the link-free event would have been invoked already
+    if (event_queue->passed(busy_until, link_free_sequence)) {
+        set_free();
+    }
 }
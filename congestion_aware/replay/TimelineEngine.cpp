@@ -0,0 +1,290 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/TimelineEngine.h"
+#include "congestion_aware/Link.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+TimelineEngine::TimelineEngine(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)),
+      next_sequence(0),
+      current_time(0),
+      current_sequence(0) {
+    assert(this->topology != nullptr);
+
+    npus_count = this->topology->get_npus_count();
+    check_store_and_forward();
+}
+
+TraceReplayReport TimelineEngine::run(const TraceRecord* const records,
+                                      const uint64_t records_count,
+                                      EventTime* const arrival_times) noexcept {
+    assert(records_count == 0 || records != nullptr);
+
+    // the MTU may have been set after construction
+    check_store_and_forward();
+
+    auto report = TraceReplayReport();
+    auto total_send_delay = 0.0;
+    auto in_flight_sends_count = static_cast<uint64_t>(0);
+    auto next_record = static_cast<uint64_t>(0);
+    next_sequence = 0;
+    current_time = 0;
+    current_sequence = 0;
+
+    // every link starts free, whatever the previous run left it busy until
+    for (auto& link : links) {
+        link.busy = false;
+        link.free_scheduled = false;
+        link.pending_head = -1;
+        link.pending_tail = -1;
+    }
+
+    // the first injection, which reschedules itself at the next record, as TraceReplay::inject does
+    if (records_count > 0) {
+        push_step(records[0].time, StepType::Inject, 0);
+    }
+
+    // sweep the steps in (time, sequence number) order
+    while (!steps.empty()) {
+        const auto step = steps.top();
+        steps.pop();
+        current_time = step.time;
+        current_sequence = step.sequence;
+
+        switch (step.type) {
+        case StepType::Inject: {
+            // send every record due now
+            while (next_record < records_count) {
+                const auto& record = records[next_record];
+                if (record.time > current_time) {
+                    break;
+                }
+                if (record.time < current_time) {
+                    std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace record " << next_record
+                              << " at " << record.time << " ns is out of order" << std::endl;
+                    std::exit(-1);
+                }
+                if (record.src >= static_cast<uint32_t>(npus_count) ||
+                    record.dest >= static_cast<uint32_t>(npus_count) || record.src == record.dest) {
+                    std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace record " << next_record
+                              << " from " << record.src << " to " << record.dest << " is not between two NPUs"
+                              << std::endl;
+                    std::exit(-1);
+                }
+                if (record.size == 0) {
+                    std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace record " << next_record
+                              << " has a size of 0 B" << std::endl;
+                    std::exit(-1);
+                }
+
+                // take a send id
+                auto send_id = 0;
+                if (free_sends.empty()) {
+                    send_id = static_cast<int>(sends.size());
+                    sends.emplace_back();
+                } else {
+                    send_id = free_sends.back();
+                    free_sends.pop_back();
+                }
+                auto& send = sends[send_id];
+                send.route = acquire_route(static_cast<DeviceId>(record.src), static_cast<DeviceId>(record.dest));
+                send.hop = 0;
+                send.size = record.size;
+                send.record = next_record;
+                send.injection_time = current_time;
+                send.next_pending = -1;
+                send_to_link(send_id);
+
+                next_record++;
+                report.sends_count++;
+                in_flight_sends_count++;
+            }
+            report.peak_in_flight_sends_count = std::max(report.peak_in_flight_sends_count, in_flight_sends_count);
+
+            // reschedule itself at the next record
+            if (next_record < records_count) {
+                push_step(records[next_record].time, StepType::Inject, 0);
+            }
+            break;
+        }
+        case StepType::Arrival: {
+            auto& send = sends[step.target];
+            send.hop++;
+            if (send.hop < send.route->links.size()) {
+                // forward the send over its next link
+                send_to_link(static_cast<int>(step.target));
+                break;
+            }
+
+            // the send arrived at its dest
+            const auto send_delay = current_time - send.injection_time;
+            if (arrival_times != nullptr) {
+                arrival_times[send.record] = current_time;
+            }
+            total_send_delay += static_cast<double>(send_delay);
+            report.max_send_delay = std::max(report.max_send_delay, send_delay);
+            report.finish_time = current_time;
+            in_flight_sends_count--;
+            release_route(send.route);
+            free_sends.push_back(static_cast<int>(step.target));
+            break;
+        }
+        case StepType::LinkFree:
+            free_link(static_cast<int>(step.target));
+            break;
+        }
+    }
+    assert(next_record == records_count && in_flight_sends_count == 0);
+    assert(routes.empty());
+
+    // summarize the timeline
+    if (report.sends_count > 0) {
+        report.mean_send_delay = total_send_delay / static_cast<double>(report.sends_count);
+    }
+    report.peak_resident_memory_KB = get_peak_resident_memory_KB();
+
+    return report;
+}
+
+TraceReplayReport TimelineEngine::run(const std::string& trace_path, EventTime* const arrival_times) noexcept {
+    const auto records = read_trace(trace_path);
+    return run(records.data(), records.size(), arrival_times);
+}
+
+void TimelineEngine::check_store_and_forward() const noexcept {
+    if (topology->get_mtu() > 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "TimelineEngine doesn't model packet trains, "
+                  << "but the topology has an MTU of " << topology->get_mtu() << " B: use TraceReplay instead"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+TimelineEngine::TimelineRoute* TimelineEngine::acquire_route(const DeviceId src, const DeviceId dest) noexcept {
+    // find the route of the sends in flight
+    const auto key = (static_cast<int64_t>(src) * npus_count) + dest;
+    const auto active_route = routes.find(key);
+    if (active_route != routes.end()) {
+        active_route->second->sends_count++;
+        return active_route->second.get();
+    }
+
+    // resolve the links of the route, indexing the links seen for the first time
+    const auto route_path = topology->shared_route(src, dest);
+    auto route = std::make_unique<TimelineRoute>();
+    route->key = key;
+    route->sends_count = 1;
+    for (const auto* const link : route_path->links) {
+        auto [link_index, inserted] = link_indices.try_emplace(link, static_cast<int>(links.size()));
+        if (inserted) {
+            links.push_back({link->get_bandwidth_Bpns(), link->get_latency(), 0, 0, -1, -1, false, false});
+        }
+        route->links.push_back(link_index->second);
+    }
+
+    auto* const resolved_route = route.get();
+    routes.emplace(key, std::move(route));
+    return resolved_route;
+}
+
+void TimelineEngine::release_route(TimelineRoute* const route) noexcept {
+    assert(route != nullptr);
+    assert(route->sends_count > 0);
+
+    route->sends_count--;
+    if (route->sends_count == 0) {
+        routes.erase(route->key);
+    }
+}
+
+void TimelineEngine::push_step(const EventTime time, const StepType type, const uint32_t target) noexcept {
+    steps.push({time, next_sequence, type, target});
+    next_sequence++;
+}
+
+void TimelineEngine::send_to_link(const int send_id) noexcept {
+    auto& send = sends[send_id];
+    const auto link_id = send.route->links[send.hop];
+    auto& link = links[link_id];
+
+    // the link became free without a LinkFree step if its reserved place in the order has passed
+    if (link.busy && !link.free_scheduled) {
+        const auto passed = (link.busy_until != current_time) ? (link.busy_until < current_time)
+                                                              : (link.free_sequence < current_sequence);
+        if (passed) {
+            link.busy = false;
+        }
+    }
+
+    if (!link.busy) {
+        // serve the send immediately
+        transmit(link_id, send_id);
+        return;
+    }
+
+    // wait for the link, in FIFO order
+    send.next_pending = -1;
+    if (link.pending_tail < 0) {
+        link.pending_head = send_id;
+    } else {
+        sends[link.pending_tail].next_pending = send_id;
+    }
+    link.pending_tail = send_id;
+    if (!link.free_scheduled) {
+        schedule_link_free(link_id);
+    }
+}
+
+void TimelineEngine::transmit(const int link_id, const int send_id) noexcept {
+    auto& link = links[link_id];
+    assert(!link.busy);
+
+    // same delays as Link::communication_delay and Link::serialization_delay
+    const auto size = static_cast<Bandwidth>(sends[send_id].size);
+    const auto communication_time = static_cast<EventTime>(link.latency + (size / link.bandwidth_Bpns));
+    const auto serialization_time = static_cast<EventTime>(size / link.bandwidth_Bpns);
+
+    // the send arrives at the next device, and the link becomes free in the place reserved after it
+    link.busy = true;
+    push_step(current_time + communication_time, StepType::Arrival, static_cast<uint32_t>(send_id));
+    link.busy_until = current_time + serialization_time;
+    link.free_sequence = next_sequence;
+    next_sequence++;
+    if (link.pending_head >= 0) {
+        schedule_link_free(link_id);
+    }
+}
+
+void TimelineEngine::schedule_link_free(const int link_id) noexcept {
+    auto& link = links[link_id];
+    assert(link.busy && !link.free_scheduled);
+
+    steps.push({link.busy_until, link.free_sequence, StepType::LinkFree, static_cast<uint32_t>(link_id)});
+    link.free_scheduled = true;
+}
+
+void TimelineEngine::free_link(const int link_id) noexcept {
+    auto& link = links[link_id];
+    link.free_scheduled = false;
+    link.busy = false;
+
+    // serve the first send waiting for the link
+    const auto send_id = link.pending_head;
+    if (send_id < 0) {
+        return;
+    }
+    link.pending_head = sends[send_id].next_pending;
+    if (link.pending_head < 0) {
+        link.pending_tail = -1;
+    }
+    transmit(link_id, send_id);
+}
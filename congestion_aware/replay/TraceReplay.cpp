@@ -0,0 +1,309 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/TraceReplay.h"
+#include "congestion_aware/Chunk.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Check the header of a trace file, or exit.
+ *
+ * @param header header of the trace file
+ * @param records_capacity number of records the file has room for after the header
+ * @param trace_path path of the trace file
+ */
+void check_trace_header(const TraceHeader& header, const uint64_t records_capacity, const std::string& trace_path) {
+    if (std::memcmp(header.magic, trace_magic, sizeof(header.magic)) != 0 || header.version != trace_version ||
+        header.records_count > records_capacity) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << trace_path << " is not a version "
+                  << trace_version << " trace file, or is truncated" << std::endl;
+        std::exit(-1);
+    }
+}
+
+}  // namespace
+
+uint64_t NetworkAnalyticalCongestionAware::get_peak_resident_memory_KB() noexcept {
+    auto usage = rusage();
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    // macOS reports in bytes
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1'024;
+#else
+    // Linux reports in KB
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+}
+
+std::vector<TraceRecord> NetworkAnalyticalCongestionAware::read_trace(const std::string& trace_path) noexcept {
+    // open the file
+    auto input = std::ifstream(trace_path, std::ios::binary | std::ios::ate);
+    if (!input.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to open " << trace_path << std::endl;
+        std::exit(-1);
+    }
+    const auto file_size = static_cast<uint64_t>(input.tellg());
+    if (file_size < sizeof(TraceHeader)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << trace_path << " is not a trace file"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // check the header, then read the records
+    auto header = TraceHeader();
+    input.seekg(0);
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    check_trace_header(header, (file_size - sizeof(TraceHeader)) / sizeof(TraceRecord), trace_path);
+    auto records = std::vector<TraceRecord>(header.records_count);
+    input.read(reinterpret_cast<char*>(records.data()),
+               static_cast<std::streamsize>(header.records_count * sizeof(TraceRecord)));
+    if (input.fail()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to read " << trace_path << std::endl;
+        std::exit(-1);
+    }
+
+    return records;
+}
+
+TraceWriter::TraceWriter(const std::string& trace_path) noexcept
+    : trace_path(trace_path),
+      records_count(0),
+      last_time(0) {
+    output.open(trace_path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to open " << trace_path << std::endl;
+        std::exit(-1);
+    }
+
+    // the number of records is filled in by close
+    auto header = TraceHeader();
+    std::memset(&header, 0, sizeof(header));
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void TraceWriter::write(const TraceRecord& record) noexcept {
+    assert(record.time >= last_time);
+    assert(record.src != record.dest);
+    assert(record.size > 0);
+
+    output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    records_count++;
+    last_time = record.time;
+}
+
+void TraceWriter::close() noexcept {
+    // write the header
+    auto header = TraceHeader();
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, trace_magic, sizeof(header.magic));
+    header.version = trace_version;
+    header.records_count = records_count;
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // check every write went through
+    output.close();
+    if (output.fail()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to write " << trace_path << std::endl;
+        std::exit(-1);
+    }
+}
+
+TraceReplay::TraceReplay(std::shared_ptr<Topology> topology, const size_t release_window_size) noexcept
+    : topology(std::move(topology)),
+      release_window_size(release_window_size),
+      mapped_trace(nullptr),
+      mapped_size(0),
+      records(nullptr),
+      records_count(0),
+      next_record(0),
+      released_offset(0),
+      start_time(0),
+      arrival_times(nullptr),
+      report(),
+      total_send_delay(0),
+      in_flight_sends_count(0) {
+    assert(this->topology != nullptr);
+    assert(this->topology->get_event_queue() != nullptr);
+    assert(release_window_size > 0);
+}
+
+TraceReplayReport TraceReplay::run(const std::string& trace_path, EventTime* const arrival_times) noexcept {
+    map_trace(trace_path);
+    this->arrival_times = arrival_times;
+    next_record = 0;
+    released_offset = 0;
+    report = TraceReplayReport();
+    total_send_delay = 0;
+    in_flight_sends_count = 0;
+
+    // schedule the first injection, and run until every send arrives
+    const auto event_queue = topology->get_event_queue();
+    start_time = event_queue->get_current_time();
+    if (records_count > 0) {
+        event_queue->schedule_event(start_time + records[0].time, inject, this);
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    assert(next_record == records_count && in_flight_sends_count == 0);
+    unmap_trace();
+
+    // summarize the replay
+    if (report.sends_count > 0) {
+        report.mean_send_delay = total_send_delay / static_cast<double>(report.sends_count);
+    }
+    report.peak_resident_memory_KB = get_peak_resident_memory_KB();
+
+    return report;
+}
+
+void TraceReplay::inject(void* const replay_ptr) noexcept {
+    assert(replay_ptr != nullptr);
+
+    auto* const replay = static_cast<TraceReplay*>(replay_ptr);
+    const auto& topology = replay->topology;
+    const auto event_queue = topology->get_event_queue();
+    const auto current_time = event_queue->get_current_time();
+    const auto npus_count = static_cast<uint32_t>(topology->get_npus_count());
+
+    // send every record due now
+    while (replay->next_record < replay->records_count) {
+        const auto& record = replay->records[replay->next_record];
+        const auto record_time = replay->start_time + record.time;
+        if (record_time > current_time) {
+            break;
+        }
+        if (record_time < current_time) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace record " << replay->next_record
+                      << " at " << record.time << " ns is out of order" << std::endl;
+            std::exit(-1);
+        }
+        if (record.src >= npus_count || record.dest >= npus_count || record.src == record.dest) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace record " << replay->next_record
+                      << " from " << record.src << " to " << record.dest << " is not between two NPUs" << std::endl;
+            std::exit(-1);
+        }
+        if (record.size == 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace record " << replay->next_record
+                      << " has a size of 0 B" << std::endl;
+            std::exit(-1);
+        }
+
+        auto* const message = replay->message_pool.acquire();
+        message->replay = replay;
+        message->injection_time = current_time;
+        message->record = replay->next_record;
+        const auto src = static_cast<DeviceId>(record.src);
+        const auto dest = static_cast<DeviceId>(record.dest);
+        auto chunk = topology->create_chunk(record.size, topology->shared_route(src, dest), message_arrived, message);
+        topology->send(std::move(chunk));
+
+        replay->next_record++;
+        replay->report.sends_count++;
+        replay->in_flight_sends_count++;
+    }
+    replay->report.peak_in_flight_sends_count =
+        std::max(replay->report.peak_in_flight_sends_count, replay->in_flight_sends_count);
+    replay->release_consumed_pages();
+
+    // reschedule itself at the next record
+    if (replay->next_record < replay->records_count) {
+        const auto next_time = replay->start_time + replay->records[replay->next_record].time;
+        event_queue->schedule_event(next_time, inject, replay);
+    }
+}
+
+void TraceReplay::message_arrived(void* const message_ptr) noexcept {
+    assert(message_ptr != nullptr);
+
+    // recycle the message
+    auto* const message = static_cast<Message*>(message_ptr);
+    auto* const replay = message->replay;
+    const auto injection_time = message->injection_time;
+    const auto record = message->record;
+    replay->message_pool.release(message);
+
+    // account the send
+    const auto current_time = replay->topology->get_event_queue()->get_current_time();
+    const auto send_delay = current_time - injection_time;
+    if (replay->arrival_times != nullptr) {
+        replay->arrival_times[record] = current_time - replay->start_time;
+    }
+    replay->total_send_delay += static_cast<double>(send_delay);
+    replay->report.max_send_delay = std::max(replay->report.max_send_delay, send_delay);
+    replay->report.finish_time = current_time - replay->start_time;
+    replay->in_flight_sends_count--;
+}
+
+void TraceReplay::map_trace(const std::string& trace_path) noexcept {
+    // open the file
+    const auto file = open(trace_path.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to open " << trace_path << std::endl;
+        std::exit(-1);
+    }
+    struct stat file_stat {};
+    if (fstat(file, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(TraceHeader)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << trace_path << " is not a trace file"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // map the file, which is read front to back
+    mapped_size = static_cast<size_t>(file_stat.st_size);
+    auto* const mapping = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "failed to map " << trace_path << std::endl;
+        std::exit(-1);
+    }
+    madvise(mapping, mapped_size, MADV_SEQUENTIAL);
+    mapped_trace = static_cast<const char*>(mapping);
+
+    // check the header
+    auto header = TraceHeader();
+    std::memcpy(&header, mapped_trace, sizeof(header));
+    check_trace_header(header, (mapped_size - sizeof(TraceHeader)) / sizeof(TraceRecord), trace_path);
+    records = reinterpret_cast<const TraceRecord*>(mapped_trace + sizeof(TraceHeader));
+    records_count = header.records_count;
+}
+
+void TraceReplay::unmap_trace() noexcept {
+    munmap(const_cast<char*>(mapped_trace), mapped_size);
+    mapped_trace = nullptr;
+    mapped_size = 0;
+    records = nullptr;
+    records_count = 0;
+}
+
+void TraceReplay::release_consumed_pages() noexcept {
+    // release whole pages only, once a window has been consumed
+    const auto consumed_offset = sizeof(TraceHeader) + (next_record * sizeof(TraceRecord));
+    if (consumed_offset - released_offset < release_window_size) {
+        return;
+    }
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto release_end = consumed_offset / page_size * page_size;
+    if (release_end > released_offset) {
+        madvise(const_cast<char*>(mapped_trace) + released_offset, release_end - released_offset, MADV_DONTNEED);
+        released_offset = release_end;
+    }
+}
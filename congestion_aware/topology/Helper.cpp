@@ -5,16 +5,27 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Helper.h"
 #include "congestion_aware/FullyConnected.h"
+#include "congestion_aware/MultiDimTopology.h"
 #include "congestion_aware/Ring.h"
 #include "congestion_aware/Switch.h"
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
-    const NetworkParser& network_parser) noexcept {
+namespace {
+
+/**
+ * Chunk arrival callback of simulate_all_to_all, which has nothing to do.
+ */
+void chunk_arrived(void* const) noexcept {}
+
+}  // namespace
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(const NetworkParser& network_parser,
+                                                                              const bool lazy_links) noexcept {
     // get network_parser info
     const auto dims_count = network_parser.get_dims_count();
     const auto topologies_per_dim = network_parser.get_topologies_per_dim();
@@ -22,10 +33,10 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
     const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
     const auto latencies_per_dim = network_parser.get_latencies_per_dim();
 
-    // for now, congestion_aware backend supports 1-dim topology only
-    if (dims_count != 1) {
-        std::cerr << "[Error] (network/analytical/congestion_aware) " << "only support 1-dim topology" << std::endl;
-        std::exit(-1);
+    // multi-dim topology
+    if (dims_count > 1) {
+        return std::make_shared<MultiDimTopology>(topologies_per_dim, npus_counts_per_dim, bandwidths_per_dim,
+                                                  latencies_per_dim);
     }
 
     // retrieve basic basic-topology info
@@ -40,10 +51,42 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
     case TopologyBuildingBlock::Switch:
         return std::make_shared<Switch>(npus_count, bandwidth, latency);
     case TopologyBuildingBlock::FullyConnected:
-        return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+        return std::make_shared<FullyConnected>(npus_count, bandwidth, latency, lazy_links);
     default:
         // shouldn't reaach here
         std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported basic-topology" << std::endl;
         std::exit(-1);
     }
 }
+
+EventTime NetworkAnalyticalCongestionAware::simulate_all_to_all(const NetworkParser& network_parser,
+                                                                const ChunkSize chunk_size) noexcept {
+    assert(chunk_size > 0);
+
+    // create topology with its own event queue
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    topology->set_link_mode(LinkMode::BusyUntil);
+    const auto npus_count = topology->get_npus_count();
+
+    // every NPU sends a chunk to every other NPU
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src == dest) {
+                continue;
+            }
+
+            auto route = topology->shared_route(src, dest);
+            auto chunk = topology->create_chunk(chunk_size, std::move(route), chunk_arrived, nullptr);
+            topology->send(std::move(chunk));
+        }
+    }
+
+    // run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    return event_queue->get_current_time();
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ParallelSimulation.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+ParallelSimulation::ParallelSimulation(std::shared_ptr<Topology> topology,
+                                       const int partitions_count,
+                                       const EventQueueEngineType engine_type) noexcept
+    : topology(std::move(topology)) {
+    assert(this->topology != nullptr);
+    assert(partitions_count > 0);
+
+    // chunk arrivals are delayed by at least the minimum link latency, which gives the lookahead
+    const auto lookahead = static_cast<EventTime>(this->topology->get_min_link_latency());
+    if (lookahead < 1) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "parallel simulation requires link latencies of at least 1 ns" << std::endl;
+        std::exit(-1);
+    }
+    parallel_event_queue = std::make_unique<ParallelEventQueue>(partitions_count, lookahead, engine_type);
+
+    // split NPUs and other devices (switches) into contiguous blocks
+    const auto npus_count = this->topology->get_npus_count();
+    const auto devices_count = this->topology->get_devices_count();
+    const auto switches_count = devices_count - npus_count;
+    auto device_event_queues = std::vector<std::shared_ptr<EventQueue>>();
+    for (auto device = 0; device < devices_count; device++) {
+        const auto partition = (device < npus_count)
+                                   ? static_cast<int>(static_cast<int64_t>(device) * partitions_count / npus_count)
+                                   : static_cast<int>(static_cast<int64_t>(device - npus_count) * partitions_count /
+                                                      switches_count);
+        partition_per_device.push_back(partition);
+        device_event_queues.push_back(parallel_event_queue->get_partition(partition));
+    }
+
+    // distribute the links over the partitions
+    this->topology->set_link_mode(LinkMode::LinkFreeEvent);
+    this->topology->set_device_event_queues(device_event_queues);
+}
+
+int ParallelSimulation::get_partition(const DeviceId device) const noexcept {
+    assert(0 <= device && device < partition_per_device.size());
+
+    return partition_per_device[device];
+}
+
+std::shared_ptr<EventQueue> ParallelSimulation::get_event_queue(const DeviceId device) const noexcept {
+    return parallel_event_queue->get_partition(get_partition(device));
+}
+
+void ParallelSimulation::run() noexcept {
+    parallel_event_queue->run();
+}
+
+EventTime ParallelSimulation::get_current_time() const noexcept {
+    return parallel_event_queue->get_current_time();
+}
+
+uint64_t ParallelSimulation::get_scheduled_events_count() const noexcept {
+    return parallel_event_queue->get_scheduled_events_count();
+}
+
+uint64_t ParallelSimulation::get_windows_count() const noexcept {
+    return parallel_event_queue->get_windows_count();
+}
@@ -5,19 +5,86 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Topology.h"
 #include "congestion_aware/Link.h"
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+Topology::Topology() noexcept
+    : npus_count(-1),
+      devices_count(-1),
+      dims_count(-1),
+      event_queue(nullptr),
+      link_mode(LinkMode::LinkFreeEvent),
+      mtu(0),
+      route_cache_capacity(default_route_cache_capacity) {
+    npus_count_per_dim = {};
+    device_storage = std::make_shared<std::vector<Device>>();
+    shared_routes = {};
+    shared_route_positions = {};
+}
+
 void Topology::set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept {
     assert(event_queue != nullptr);
 
-    // pass the given event_queue to Link
-    Link::set_event_queue(std::move(event_queue));
+    // pass the given event_queue to all links
+    for (auto& link : links) {
+        link.set_event_queue(event_queue.get());
+    }
+    if (lazy_link_table != nullptr) {
+        lazy_link_table->set_event_queue(event_queue.get());
+    }
+
+    // hold the event queue
+    this->event_queue = std::move(event_queue);
+    device_event_queues.clear();
+    chunk_pool.set_concurrent_release(false);
 }
 
-Topology::Topology() noexcept : npus_count(-1), devices_count(-1), dims_count(-1) {
-    npus_count_per_dim = {};
+void Topology::set_device_event_queues(const std::vector<std::shared_ptr<EventQueue>>& device_event_queues) noexcept {
+    assert(device_event_queues.size() == devices_count);
+
+    // each link uses the event queues of its src and dest devices
+    for (auto src = 0; src < devices_count; src++) {
+        for (auto i = link_offsets[src]; i < link_offsets[src + 1]; i++) {
+            links[i].set_event_queue(device_event_queues[src].get());
+            links[i].set_arrival_event_queue(device_event_queues[link_dests[i]].get());
+        }
+    }
+    if (lazy_link_table != nullptr) {
+        auto device_event_queue_ptrs = std::vector<EventQueue*>();
+        for (const auto& device_event_queue : device_event_queues) {
+            device_event_queue_ptrs.push_back(device_event_queue.get());
+        }
+        lazy_link_table->set_device_event_queues(std::move(device_event_queue_ptrs));
+    }
+
+    // chunks arriving at their dest are destroyed by the dest device's event queue
+    chunk_pool.set_concurrent_release(true);
+
+    // hold the event queues
+    this->device_event_queues = device_event_queues;
+    event_queue = nullptr;
+}
+
+std::shared_ptr<EventQueue> Topology::get_event_queue() const noexcept {
+    assert(event_queue != nullptr);
+
+    return event_queue;
+}
+
+void Topology::set_link_mode(const LinkMode link_mode) noexcept {
+    // pass the given link_mode to all links
+    for (auto& link : links) {
+        link.set_link_mode(link_mode);
+    }
+    if (lazy_link_table != nullptr) {
+        lazy_link_table->set_link_mode(link_mode);
+    }
+
+    // hold the link mode
+    this->link_mode = link_mode;
 }
 
 int Topology::get_devices_count() const noexcept {
@@ -36,6 +103,34 @@ int Topology::get_npus_count() const noexcept {
     return npus_count;
 }
 
+int Topology::get_links_count() const noexcept {
+    // adjacency links
+    auto links_count = static_cast<int>(links.size());
+
+    // lazily instantiated links
+    if (lazy_link_table != nullptr) {
+        links_count += lazy_link_table->get_links_count();
+    }
+
+    return links_count;
+}
+
+Latency Topology::get_min_link_latency() const noexcept {
+    auto min_latency = std::numeric_limits<Latency>::infinity();
+
+    // adjacency links
+    for (const auto& link : links) {
+        min_latency = std::min(min_latency, link.get_latency());
+    }
+
+    // lazily instantiated links
+    if (lazy_link_table != nullptr) {
+        min_latency = std::min(min_latency, lazy_link_table->get_latency());
+    }
+
+    return min_latency;
+}
+
 int Topology::get_dims_count() const noexcept {
     assert(dims_count > 0);
 
@@ -54,6 +149,108 @@ std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
     return bandwidth_per_dim;
 }
 
+SharedRoute Topology::shared_route(const DeviceId src, const DeviceId dest) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // look up the cache, and mark the route most recently requested
+    const auto key = static_cast<int64_t>(src) * npus_count + dest;
+    const auto position = shared_route_positions.find(key);
+    if (position != shared_route_positions.end()) {
+        shared_routes.splice(shared_routes.begin(), shared_routes, position->second);
+        return position->second->second;
+    }
+
+    // construct the route on its first request, or after its eviction
+    const auto list_route = route(src, dest);
+    auto route_path = std::make_shared<RoutePath>();
+    route_path->devices.assign(list_route.begin(), list_route.end());
+
+    // resolve the links to traverse
+    for (auto i = static_cast<size_t>(1); i < route_path->devices.size(); i++) {
+        const auto& device = route_path->devices[i - 1];
+        route_path->links.push_back(device->link_to(route_path->devices[i]->get_id()));
+    }
+
+    // evict the least recently requested route if the cache is full
+    if (shared_routes.size() >= route_cache_capacity) {
+        shared_route_positions.erase(shared_routes.back().first);
+        shared_routes.pop_back();
+    }
+    shared_routes.emplace_front(key, std::move(route_path));
+    shared_route_positions.emplace(key, shared_routes.begin());
+
+    return shared_routes.front().second;
+}
+
+void Topology::set_route_cache_capacity(const size_t route_cache_capacity) noexcept {
+    assert(route_cache_capacity > 0);
+
+    // evict the least recently requested routes beyond the new capacity
+    this->route_cache_capacity = route_cache_capacity;
+    while (shared_routes.size() > route_cache_capacity) {
+        shared_route_positions.erase(shared_routes.back().first);
+        shared_routes.pop_back();
+    }
+}
+
+size_t Topology::get_route_cache_capacity() const noexcept {
+    return route_cache_capacity;
+}
+
+size_t Topology::get_cached_routes_count() const noexcept {
+    return shared_routes.size();
+}
+
+std::unique_ptr<Chunk> Topology::create_chunk(const ChunkSize chunk_size,
+                                              SharedRoute route,
+                                              const Callback callback,
+                                              const CallbackArg callback_arg) noexcept {
+    assert(chunk_size > 0);
+    assert(route != nullptr);
+    assert(callback != nullptr);
+
+    // construct the chunk in a pooled storage
+    auto* const chunk = new (chunk_pool) Chunk(chunk_size, std::move(route), callback, callback_arg);
+    return std::unique_ptr<Chunk>(chunk);
+}
+
+std::unique_ptr<Chunk> Topology::create_chunk_batch(const ChunkSize chunk_size,
+                                                    const int items_count,
+                                                    SharedRoute route,
+                                                    const Callback callback,
+                                                    const CallbackArg callback_arg) noexcept {
+    assert(chunk_size > 0);
+    assert(items_count > 0);
+    assert(route != nullptr);
+    assert(callback != nullptr);
+
+    // construct the batch in a pooled storage
+    auto* const chunk = new (chunk_pool) Chunk(chunk_size, items_count, std::move(route), callback, callback_arg);
+    return std::unique_ptr<Chunk>(chunk);
+}
+
+uint64_t Topology::get_allocated_chunk_slots_count() const noexcept {
+    return chunk_pool.get_chunks_allocated_count();
+}
+
+void Topology::set_mtu(const ChunkSize mtu) noexcept {
+    // pass the given mtu to all links
+    for (auto& link : links) {
+        link.set_mtu(mtu);
+    }
+    if (lazy_link_table != nullptr) {
+        lazy_link_table->set_mtu(mtu);
+    }
+
+    // hold the mtu
+    this->mtu = mtu;
+}
+
+ChunkSize Topology::get_mtu() const noexcept {
+    return mtu;
+}
+
 void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
@@ -80,18 +277,96 @@ void Topology::connect(const DeviceId src,
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // links should not have been built yet
+    assert(links.empty());
+
     // connect src -> dest
-    devices[src]->connect(dest, bandwidth, latency);
+    link_specs.push_back(LinkSpec{src, dest, bandwidth, latency});
 
     // if bidirectional, connect dest -> src
     if (bidirectional) {
-        devices[dest]->connect(src, bandwidth, latency);
+        link_specs.push_back(LinkSpec{dest, src, bandwidth, latency});
+    }
+}
+
+void Topology::build_links() noexcept {
+    // links should be built once
+    assert(links.empty());
+    assert(devices.size() == devices_count);
+
+    // sort connections in CSR order
+    std::sort(link_specs.begin(), link_specs.end(), [](const LinkSpec& a, const LinkSpec& b) {
+        return (a.src != b.src) ? (a.src < b.src) : (a.dest < b.dest);
+    });
+
+    // instantiate links, counting the links of each device
+    // links never reallocate from now on, as devices and events point to them
+    link_offsets.assign(devices_count + 1, 0);
+    links.reserve(link_specs.size());
+    link_dests.reserve(link_specs.size());
+    for (auto i = static_cast<size_t>(0); i < link_specs.size(); i++) {
+        const auto& link_spec = link_specs[i];
+
+        // assert there's no duplicated connection
+        assert(i == 0 || link_spec.src != link_specs[i - 1].src || link_spec.dest != link_specs[i - 1].dest);
+
+        links.emplace_back(link_spec.bandwidth, link_spec.latency);
+        link_dests.push_back(link_spec.dest);
+        link_offsets[link_spec.src + 1]++;
+
+        // pass the event queue, link mode and mtu
+        if (event_queue != nullptr) {
+            links.back().set_event_queue(event_queue.get());
+        }
+        links.back().set_link_mode(link_mode);
+        links.back().set_mtu(mtu);
+    }
+    link_specs.clear();
+    link_specs.shrink_to_fit();
+
+    // accumulate the offsets
+    for (auto i = 0; i < devices_count; i++) {
+        link_offsets[i + 1] += link_offsets[i];
+    }
+
+    // attach each device to its outgoing links
+    for (auto i = 0; i < devices_count; i++) {
+        const auto offset = link_offsets[i];
+        const auto links_count = link_offsets[i + 1] - offset;
+        devices[i]->set_links(links.data() + offset, link_dests.data() + offset, links_count);
+    }
+}
+
+void Topology::connect_lazily(const Bandwidth bandwidth, const Latency latency) noexcept {
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // full mesh should be connected once
+    assert(lazy_link_table == nullptr);
+
+    // create the lazy link table
+    lazy_link_table = std::make_unique<LazyLinkTable>(devices_count, bandwidth, latency);
+    if (event_queue != nullptr) {
+        lazy_link_table->set_event_queue(event_queue.get());
+    }
+    lazy_link_table->set_link_mode(link_mode);
+    lazy_link_table->set_mtu(mtu);
+
+    // every device instantiates its links through the table
+    for (const auto& device : devices) {
+        device->set_lazy_link_table(lazy_link_table.get());
     }
 }
 
 void Topology::instantiate_devices() noexcept {
-    // instantiate all devices
+    // instantiate all devices contiguously
+    device_storage->reserve(devices_count);
     for (auto i = 0; i < devices_count; i++) {
-        devices.push_back(std::make_shared<Device>(i));
+        device_storage->emplace_back(i);
+    }
+
+    // create handles sharing the ownership of the storage
+    for (auto& device : *device_storage) {
+        devices.push_back(std::shared_ptr<Device>(device_storage, &device));
     }
 }
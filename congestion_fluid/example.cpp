@@ -0,0 +1,57 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_fluid/FlowNetwork.h"
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionFluid;
+
+void flow_arrived(void* const arg) {
+    // count the arrived flow
+    auto* const arrived_flows_count = static_cast<int*>(arg);
+    (*arrived_flows_count)++;
+}
+
+int main() {
+    // Instantiate shared resources
+    const auto event_queue = std::make_shared<EventQueue>();
+
+    // Parse network config and create topology
+    const auto network_parser = NetworkParser("../input/Ring.yml");
+    const auto topology = NetworkAnalyticalCongestionAware::construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+    const auto devices_count = topology->get_devices_count();
+
+    // message settings
+    const auto flow_size = 1'048'576;  // 1 MB
+
+    // Run All-Gather: every NPU streams a flow to every other NPU
+    auto flow_network = FlowNetwork(topology);
+    auto arrived_flows_count = 0;
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                flow_network.send(src, dest, flow_size, flow_arrived, &arrived_flows_count);
+            }
+        }
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    // Print simulation result
+    std::cout << "Total NPUs Count: " << npus_count << std::endl;
+    std::cout << "Total devices Count: " << devices_count << std::endl;
+    std::cout << "Arrived flows Count: " << arrived_flows_count << std::endl;
+    std::cout << "Rate recomputations Count: " << flow_network.get_recomputations_count() << std::endl;
+    std::cout << "Simulation finished at time: " << event_queue->get_current_time() << " ns" << std::endl;
+
+    return 0;
+}
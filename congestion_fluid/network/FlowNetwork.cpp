@@ -0,0 +1,299 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_fluid/FlowNetwork.h"
+#include "congestion_aware/Link.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionFluid;
+
+namespace {
+
+/// outdated completions are purged once they outnumber the flows in flight by this factor
+constexpr uint64_t completions_purge_factor = 4;
+
+/// completions are never purged below this many
+constexpr uint64_t min_completions_to_purge = 1'024;
+
+}  // namespace
+
+FlowNetwork::FlowNetwork(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)),
+      active_flows_count(0),
+      scheduled_completion_time(std::numeric_limits<EventTime>::max()),
+      recomputation_scheduled(false),
+      recomputations_count(0),
+      mark(0) {
+    assert(this->topology != nullptr);
+
+    event_queue = this->topology->get_event_queue();
+    assert(event_queue != nullptr);
+    npus_count = this->topology->get_npus_count();
+}
+
+void FlowNetwork::send(const DeviceId src,
+                       const DeviceId dest,
+                       const ChunkSize flow_size,
+                       const Callback callback,
+                       const CallbackArg callback_arg) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // take a flow id
+    auto flow_id = 0;
+    if (free_flows.empty()) {
+        flow_id = static_cast<int>(flows.size());
+        flows.emplace_back();
+        flows.back().version = 0;
+        flow_marks.push_back(0);
+    } else {
+        flow_id = free_flows.back();
+        free_flows.pop_back();
+    }
+
+    // set up the flow, whose rate is assigned by the next recomputation
+    auto& flow = flows[flow_id];
+    resolve_route(flow, src, dest);
+    flow.positions.resize(flow.links.size());
+    flow.remaining_size = static_cast<double>(flow_size);
+    flow.rate = 0;
+    flow.last_update_time = event_queue->get_current_time();
+    flow.version++;
+    flow.callback = callback;
+    flow.callback_arg = callback_arg;
+    flow.active = true;
+    active_flows_count++;
+
+    // join the links of the route
+    for (auto hop = 0; hop < static_cast<int>(flow.links.size()); hop++) {
+        const auto link = flow.links[hop];
+        flow.positions[hop] = static_cast<int>(link_flows[link].size());
+        link_flows[link].push_back({flow_id, hop});
+        mark_dirty(link);
+    }
+}
+
+std::shared_ptr<EventQueue> FlowNetwork::get_event_queue() const noexcept {
+    return event_queue;
+}
+
+uint64_t FlowNetwork::get_active_flows_count() const noexcept {
+    return active_flows_count;
+}
+
+uint64_t FlowNetwork::get_recomputations_count() const noexcept {
+    return recomputations_count;
+}
+
+void FlowNetwork::recompute_rates(void* const network_ptr) noexcept {
+    assert(network_ptr != nullptr);
+
+    auto* const network = static_cast<FlowNetwork*>(network_ptr);
+    network->recompute();
+}
+
+void FlowNetwork::complete_flows(void* const network_ptr) noexcept {
+    assert(network_ptr != nullptr);
+
+    auto* const network = static_cast<FlowNetwork*>(network_ptr);
+    const auto current_time = network->event_queue->get_current_time();
+    if (network->scheduled_completion_time == current_time) {
+        network->scheduled_completion_time = std::numeric_limits<EventTime>::max();
+    }
+
+    // finish every flow due by now, skipping the outdated completions
+    auto& completions = network->completions;
+    while (!completions.empty() && completions.top().time <= current_time) {
+        const auto completion = completions.top();
+        completions.pop();
+        const auto& flow = network->flows[completion.flow];
+        if (flow.active && flow.version == completion.version) {
+            network->finish_flow(completion.flow);
+        }
+    }
+
+    network->schedule_next_completion();
+}
+
+void FlowNetwork::resolve_route(Flow& flow, const DeviceId src, const DeviceId dest) noexcept {
+    // take the route from the bounded route cache of the topology, indexing the links seen for the first time
+    flow.route = topology->shared_route(src, dest);
+    flow.links.clear();
+    auto latency = 0.0;
+    for (const auto* const link : flow.route->links) {
+        auto [link_index, inserted] = link_indices.try_emplace(link, static_cast<int>(link_capacities.size()));
+        if (inserted) {
+            link_capacities.push_back(link->get_bandwidth_Bpns());
+            link_flows.emplace_back();
+            link_dirty.push_back(false);
+            link_marks.push_back(0);
+            residual_capacities.push_back(0);
+            unassigned_flows_counts.push_back(0);
+        }
+        flow.links.push_back(link_index->second);
+        latency += link->get_latency();
+    }
+    flow.latency = static_cast<EventTime>(latency);
+}
+
+void FlowNetwork::mark_dirty(const int link) noexcept {
+    if (!link_dirty[link]) {
+        link_dirty[link] = true;
+        dirty_links.push_back(link);
+    }
+
+    // recompute once every flow starting or finishing at the current time has been accounted for
+    if (!recomputation_scheduled) {
+        recomputation_scheduled = true;
+        event_queue->schedule_event(event_queue->get_current_time(), recompute_rates, this);
+    }
+}
+
+void FlowNetwork::recompute() noexcept {
+    recomputation_scheduled = false;
+    recomputations_count++;
+    mark++;
+    const auto current_time = event_queue->get_current_time();
+
+    // collect the links and flows connected to the dirty links
+    for (const auto link : dirty_links) {
+        link_dirty[link] = false;
+        link_marks[link] = mark;
+        component_links.push_back(link);
+    }
+    dirty_links.clear();
+    for (auto i = size_t(0); i < component_links.size(); i++) {
+        for (const auto& entry : link_flows[component_links[i]]) {
+            if (flow_marks[entry.flow] == mark) {
+                continue;
+            }
+            flow_marks[entry.flow] = mark;
+            component_flows.push_back(entry.flow);
+            for (const auto link : flows[entry.flow].links) {
+                if (link_marks[link] != mark) {
+                    link_marks[link] = mark;
+                    component_links.push_back(link);
+                }
+            }
+        }
+    }
+
+    // stream the flows up to now at their old rates
+    for (const auto flow_id : component_flows) {
+        auto& flow = flows[flow_id];
+        flow.remaining_size -= flow.rate * static_cast<double>(current_time - flow.last_update_time);
+        flow.last_update_time = current_time;
+        flow.rate = -1;
+    }
+
+    // progressive filling: repeatedly saturate the link with the smallest fair share
+    for (const auto link : component_links) {
+        residual_capacities[link] = link_capacities[link];
+        unassigned_flows_counts[link] = static_cast<int>(link_flows[link].size());
+    }
+    while (true) {
+        auto bottleneck = -1;
+        auto fair_share = std::numeric_limits<double>::infinity();
+        for (const auto link : component_links) {
+            if (unassigned_flows_counts[link] > 0) {
+                const auto share = residual_capacities[link] / unassigned_flows_counts[link];
+                if (share < fair_share) {
+                    fair_share = share;
+                    bottleneck = link;
+                }
+            }
+        }
+        if (bottleneck < 0) {
+            break;
+        }
+
+        fair_share = std::max(fair_share, 0.0);
+        for (const auto& entry : link_flows[bottleneck]) {
+            auto& flow = flows[entry.flow];
+            if (flow.rate >= 0) {
+                continue;
+            }
+            flow.rate = fair_share;
+            for (const auto link : flow.links) {
+                residual_capacities[link] -= fair_share;
+                unassigned_flows_counts[link]--;
+            }
+        }
+    }
+
+    // purge the outdated completions, if they pile up
+    if (completions.size() > std::max(min_completions_to_purge, completions_purge_factor * active_flows_count)) {
+        auto valid_completions = std::vector<Completion>();
+        while (!completions.empty()) {
+            const auto& completion = completions.top();
+            const auto& flow = flows[completion.flow];
+            if (flow.active && flow.version == completion.version) {
+                valid_completions.push_back(completion);
+            }
+            completions.pop();
+        }
+        completions = decltype(completions)(std::greater<>(), std::move(valid_completions));
+    }
+
+    // expect the flows to finish at their new rates
+    for (const auto flow_id : component_flows) {
+        auto& flow = flows[flow_id];
+        flow.version++;
+        if (flow.rate <= 0) {
+            continue;
+        }
+        const auto duration = std::ceil(std::max(flow.remaining_size, 0.0) / flow.rate);
+        completions.push({current_time + static_cast<EventTime>(duration), flow_id, flow.version});
+    }
+    component_links.clear();
+    component_flows.clear();
+
+    schedule_next_completion();
+}
+
+void FlowNetwork::finish_flow(const int flow_id) noexcept {
+    auto& flow = flows[flow_id];
+    assert(flow.active);
+
+    // leave the links of the route
+    for (auto hop = 0; hop < static_cast<int>(flow.links.size()); hop++) {
+        const auto link = flow.links[hop];
+        auto& link_flow_list = link_flows[link];
+        const auto position = flow.positions[hop];
+        const auto moved_entry = link_flow_list.back();
+        link_flow_list[position] = moved_entry;
+        flows[moved_entry.flow].positions[moved_entry.hop] = position;
+        link_flow_list.pop_back();
+        mark_dirty(link);
+    }
+
+    // the last byte arrives after the latency of the route
+    flow.route.reset();
+    flow.active = false;
+    active_flows_count--;
+    free_flows.push_back(flow_id);
+    event_queue->schedule_event(event_queue->get_current_time() + flow.latency, flow.callback, flow.callback_arg);
+}
+
+void FlowNetwork::schedule_next_completion() noexcept {
+    // drop the outdated completions on top
+    while (!completions.empty()) {
+        const auto& completion = completions.top();
+        const auto& flow = flows[completion.flow];
+        if (flow.active && flow.version == completion.version) {
+            break;
+        }
+        completions.pop();
+    }
+
+    if (!completions.empty() && completions.top().time < scheduled_completion_time) {
+        scheduled_completion_time = completions.top().time;
+        event_queue->schedule_event(scheduled_completion_time, complete_flows, this);
+    }
+}
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_unaware/BasicTopology.h"
 #include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
@@ -45,6 +46,71 @@ EventTime BasicTopology::send(const DeviceId src, const DeviceId dest, const Chu
     return compute_communication_delay(hops_count, chunk_size);
 }
 
+void BasicTopology::send_batch(const DeviceId* const srcs,
+                               const DeviceId* const dests,
+                               const ChunkSize* const chunk_sizes,
+                               EventTime* const comm_delays,
+                               const size_t chunks_count) const noexcept {
+    assert(chunks_count == 0 || (srcs != nullptr && dests != nullptr));
+    assert(chunks_count == 0 || (chunk_sizes != nullptr && comm_delays != nullptr));
+
+    // resolve the hops count once for the whole batch
+    const auto model = get_hops_count_model();
+
+    for (auto i = static_cast<size_t>(0); i < chunks_count; i++) {
+        assert(0 <= srcs[i] && srcs[i] < npus_count);
+        assert(0 <= dests[i] && dests[i] < npus_count);
+        assert(srcs[i] != dests[i]);
+        assert(chunk_sizes[i] > 0);
+
+        // compute hops count
+        auto clockwise_distance = dests[i] - srcs[i];
+        clockwise_distance += (clockwise_distance < 0) ? npus_count : 0;
+        const auto ring_distance = std::min(clockwise_distance, model.ring_length - clockwise_distance);
+        const auto hops_count = model.constant_hops_count + (model.ring_weight * ring_distance);
+
+        // same as compute_communication_delay
+        const auto link_delay = hops_count * latency;
+        const auto serialization_delay = static_cast<double>(chunk_sizes[i]) / bandwidth_Bpns;
+        comm_delays[i] = static_cast<EventTime>(link_delay + serialization_delay);
+    }
+}
+
+int BasicTopology::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    return compute_hops_count(src, dest);
+}
+
+void BasicTopology::send_row(const DeviceId src,
+                             const ChunkSize chunk_size,
+                             uint32_t* const hops_counts,
+                             EventTime* const comm_delays) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(hops_counts != nullptr && comm_delays != nullptr);
+    assert(chunk_size > 0);
+
+    // resolve the hops count once for the whole row
+    const auto model = get_hops_count_model();
+    const auto serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bpns;
+
+    for (auto dest = 0; dest < npus_count; dest++) {
+        // compute hops count, 0 to src itself
+        auto clockwise_distance = dest - src;
+        clockwise_distance += (clockwise_distance < 0) ? npus_count : 0;
+        const auto ring_distance = std::min(clockwise_distance, model.ring_length - clockwise_distance);
+        const auto hops_count = (dest == src) ? 0 : (model.constant_hops_count + (model.ring_weight * ring_distance));
+
+        // same as compute_communication_delay
+        const auto link_delay = hops_count * latency;
+        const auto comm_delay = static_cast<EventTime>(link_delay + serialization_delay);
+        hops_counts[dest] = static_cast<uint32_t>(hops_count);
+        comm_delays[dest] = (dest == src) ? 0 : comm_delay;
+    }
+}
+
 EventTime BasicTopology::compute_communication_delay(const int hops_count, const ChunkSize chunk_size) const noexcept {
     assert(hops_count > 0);
     assert(chunk_size > 0);
@@ -60,6 +126,10 @@ EventTime BasicTopology::compute_communication_delay(const int hops_count, const
     return static_cast<EventTime>(comms_delay);
 }
 
+Latency BasicTopology::get_latency() const noexcept {
+    return latency;
+}
+
 TopologyBuildingBlock BasicTopology::get_basic_topology_type() const noexcept {
     assert(basic_topology_type != TopologyBuildingBlock::Undefined);
 
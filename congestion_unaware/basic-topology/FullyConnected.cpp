@@ -27,3 +27,8 @@ int FullyConnected::compute_hops_count(const DeviceId src, const DeviceId dest)
     // for FullyConnected, hops_count is always 1 (src -> dest)
     return 1;
 }
+
+HopsCountModel FullyConnected::get_hops_count_model() const noexcept {
+    // always 1 hop (src -> dest)
+    return HopsCountModel{1, 0, npus_count};
+}
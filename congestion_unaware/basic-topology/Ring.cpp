@@ -47,3 +47,10 @@ int Ring::compute_hops_count(const DeviceId src, const DeviceId dest) const noex
     // bidirectional: return shorter distance
     return (clockwise_distance < anticlockwise_distance) ? clockwise_distance : anticlockwise_distance;
 }
+
+HopsCountModel Ring::get_hops_count_model() const noexcept {
+    // the anticlockwise direction is never shorter if the ring is unidirectional
+    const auto ring_length = bidirectional ? npus_count : (2 * npus_count);
+
+    return HopsCountModel{0, 1, ring_length};
+}
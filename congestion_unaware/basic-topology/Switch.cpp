@@ -27,3 +27,8 @@ int Switch::compute_hops_count(const DeviceId src, const DeviceId dest) const no
     // for switch, hops_count is always 2 (src -> switch -> dest)
     return 2;
 }
+
+HopsCountModel Switch::get_hops_count_model() const noexcept {
+    // always 2 hops (src -> switch -> dest)
+    return HopsCountModel{2, 0, npus_count};
+}
@@ -0,0 +1,192 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/CollectiveCostModel.h"
+#include "common/NetworkFunction.h"
+#include "congestion_unaware/Helper.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/**
+ * Compute the hops count between two NPUs some distance apart.
+ *
+ * @param model hops count model of the dimension
+ * @param distance clockwise distance between the NPUs, positive
+ * @return hops count between the NPUs
+ */
+int compute_hops_count(const HopsCountModel& model, const int distance) noexcept {
+    assert(distance > 0);
+
+    return model.constant_hops_count + (model.ring_weight * std::min(distance, model.ring_length - distance));
+}
+
+}  // namespace
+
+CollectiveCostModel::CollectiveCostModel(const BasicTopology& topology) noexcept : dims_count(0) {
+    append_dimension(topology);
+}
+
+CollectiveCostModel::CollectiveCostModel(const MultiDimTopology& topology) noexcept : dims_count(0) {
+    for (auto dim = 0; dim < topology.get_dims_count(); dim++) {
+        append_dimension(topology.get_basic_topology(dim));
+    }
+}
+
+CollectiveCostModel::CollectiveCostModel(const NetworkParser& network_parser) noexcept : dims_count(0) {
+    // construct_topology creates a BasicTopology for a single dimension, a MultiDimTopology otherwise
+    const auto topology = construct_topology(network_parser);
+    if (network_parser.get_dims_count() == 1) {
+        append_dimension(*std::static_pointer_cast<BasicTopology>(topology));
+        return;
+    }
+
+    const auto multi_dim_topology = std::static_pointer_cast<MultiDimTopology>(topology);
+    for (auto dim = 0; dim < multi_dim_topology->get_dims_count(); dim++) {
+        append_dimension(multi_dim_topology->get_basic_topology(dim));
+    }
+}
+
+EventTime CollectiveCostModel::get_collective_time(const CollectiveType collective_type,
+                                                   const std::vector<CollectiveAlgorithm>& algorithm_per_dim,
+                                                   const ChunkSize collective_size) const noexcept {
+    assert(algorithm_per_dim.size() == dims_count);
+    assert(collective_size > 0);
+
+    // compose the dimensions hierarchically, from the lowest one
+    auto collective_delay = 0.0;
+    auto dim_collective_size = static_cast<double>(collective_size);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        collective_delay +=
+            compute_dim_collective_delay(dim, collective_type, algorithm_per_dim[dim], dim_collective_size);
+
+        // each NPU of the higher dimensions only handles its share of the buffer, except for All-to-All
+        if (collective_type != CollectiveType::AllToAll) {
+            dim_collective_size /= npus_count_per_dim[dim];
+        }
+    }
+
+    return static_cast<EventTime>(collective_delay);
+}
+
+EventTime CollectiveCostModel::get_collective_time(const CollectiveType collective_type,
+                                                   const CollectiveAlgorithm algorithm,
+                                                   const ChunkSize collective_size) const noexcept {
+    return get_collective_time(collective_type, std::vector<CollectiveAlgorithm>(dims_count, algorithm),
+                               collective_size);
+}
+
+EventTime CollectiveCostModel::get_dim_collective_time(const int dim,
+                                                       const CollectiveType collective_type,
+                                                       const CollectiveAlgorithm algorithm,
+                                                       const ChunkSize collective_size) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(collective_size > 0);
+
+    const auto collective_delay =
+        compute_dim_collective_delay(dim, collective_type, algorithm, static_cast<double>(collective_size));
+    return static_cast<EventTime>(collective_delay);
+}
+
+int CollectiveCostModel::get_dims_count() const noexcept {
+    assert(dims_count > 0);
+
+    return dims_count;
+}
+
+void CollectiveCostModel::append_dimension(const BasicTopology& topology) noexcept {
+    const auto npus_count = topology.get_npus_count();
+    const auto model = topology.get_hops_count_model();
+
+    dims_count++;
+    npus_count_per_dim.push_back(npus_count);
+    bandwidth_Bpns_per_dim.push_back(bw_GBps_to_Bpns(topology.get_bandwidth_per_dim()[0]));
+    latency_per_dim.push_back(topology.get_latency());
+
+    // hops count to the next and the farthest NPUs
+    next_hops_count_per_dim.push_back((npus_count > 1) ? compute_hops_count(model, 1) : 0);
+    const auto max_ring_distance = std::min(npus_count - 1, model.ring_length / 2);
+    max_hops_count_per_dim.push_back((npus_count > 1) ? compute_hops_count(model, max_ring_distance) : 0);
+
+    // hops count to the NPUs 1, 2, 4, ..., p / 2 apart, if p is a power of 2
+    if ((npus_count & (npus_count - 1)) != 0) {
+        halving_doubling_steps_count_per_dim.push_back(-1);
+        halving_doubling_hops_count_per_dim.push_back(-1);
+        return;
+    }
+    auto halving_doubling_steps_count = 0;
+    auto halving_doubling_hops_count = 0;
+    for (auto distance = 1; distance < npus_count; distance *= 2) {
+        halving_doubling_steps_count++;
+        halving_doubling_hops_count += compute_hops_count(model, distance);
+    }
+    halving_doubling_steps_count_per_dim.push_back(halving_doubling_steps_count);
+    halving_doubling_hops_count_per_dim.push_back(halving_doubling_hops_count);
+}
+
+double CollectiveCostModel::compute_dim_collective_delay(const int dim,
+                                                         const CollectiveType collective_type,
+                                                         const CollectiveAlgorithm algorithm,
+                                                         const double collective_size) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    const auto npus_count = npus_count_per_dim[dim];
+    const auto bandwidth_Bpns = bandwidth_Bpns_per_dim[dim];
+    const auto latency = latency_per_dim[dim];
+
+    // a single NPU has nothing to communicate
+    if (npus_count == 1) {
+        return 0.0;
+    }
+
+    // an All-Reduce is a Reduce-Scatter followed by an All-Gather, which take the same time
+    if (collective_type == CollectiveType::AllReduce) {
+        return 2 * compute_dim_collective_delay(dim, CollectiveType::ReduceScatter, algorithm, collective_size);
+    }
+    const auto is_all_to_all = (collective_type == CollectiveType::AllToAll);
+    const auto shard_size = collective_size / npus_count;
+
+    switch (algorithm) {
+    case CollectiveAlgorithm::Ring: {
+        // p - 1 steps to the next NPU
+        const auto steps_count = npus_count - 1;
+        const auto link_delay = steps_count * next_hops_count_per_dim[dim] * latency;
+
+        // All-to-All sends (p - 1) + (p - 2) + ... + 1 shards, the others a shard per step
+        const auto sent_size = is_all_to_all ? (shard_size * steps_count * npus_count / 2) : (shard_size * steps_count);
+        return link_delay + (sent_size / bandwidth_Bpns);
+    }
+    case CollectiveAlgorithm::Direct: {
+        // a single step, as long as the send to the farthest NPU
+        return (max_hops_count_per_dim[dim] * latency) + (shard_size / bandwidth_Bpns);
+    }
+    case CollectiveAlgorithm::HalvingDoubling: {
+        const auto hops_count = halving_doubling_hops_count_per_dim[dim];
+        if (hops_count < 0) {
+            std::cerr << "[Error] (network/analytical/congestion_unaware) "
+                      << "HalvingDoubling needs a power of 2 NPUs, but dim " << dim << " has " << npus_count
+                      << std::endl;
+            std::exit(-1);
+        }
+
+        // log2(p) steps: All-to-All sends half of the buffer each step, the others m / 2 + m / 4 + ... + m / p
+        const auto steps_count = halving_doubling_steps_count_per_dim[dim];
+        const auto sent_size = is_all_to_all ? (collective_size / 2 * steps_count) : (collective_size - shard_size);
+        return (hops_count * latency) + (sent_size / bandwidth_Bpns);
+    }
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "Not supported collective algorithm"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
@@ -4,6 +4,8 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/MultiDimTopology.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
@@ -22,17 +24,16 @@ MultiDimTopology::MultiDimTopology() noexcept : Topology() {
 }
 
 EventTime MultiDimTopology::send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
-    // translate src and dest to multi-dim address
-    const auto src_address = translate_address(src);
-    const auto dest_address = translate_address(dest);
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
 
     // get dim to transfer
-    const auto dim_to_transfer = get_dim_to_transfer(src_address, dest_address);
+    const auto dim_to_transfer = get_dim_to_transfer(src, dest);
 
     // prepare localized topology and address info
     auto* const topology = topology_per_dim[dim_to_transfer].get();
-    const auto src_local_id = src_address[dim_to_transfer];
-    const auto dest_local_id = dest_address[dim_to_transfer];
+    const auto src_local_id = translate_address(src, dim_to_transfer);
+    const auto dest_local_id = translate_address(dest, dim_to_transfer);
 
     // run localized communication
     const auto comms_delay = topology->send(src_local_id, dest_local_id, chunk_size);
@@ -41,7 +42,135 @@ EventTime MultiDimTopology::send(const DeviceId src, const DeviceId dest, const
     return comms_delay;
 }
 
+void MultiDimTopology::send_batch(const DeviceId* const srcs,
+                                  const DeviceId* const dests,
+                                  const ChunkSize* const chunk_sizes,
+                                  EventTime* const comm_delays,
+                                  const size_t chunks_count) const noexcept {
+    assert(chunks_count == 0 || (srcs != nullptr && dests != nullptr));
+    assert(chunks_count == 0 || (chunk_sizes != nullptr && comm_delays != nullptr));
+
+    // raw views of the per-dimension parameters
+    const auto* const npus_count_divisor = npus_count_divisor_per_dim.data();
+    const auto* const npus_count_of_dim = npus_count_per_dim.data();
+    const auto* const hops_count_model = hops_count_model_per_dim.data();
+
+    for (auto i = static_cast<size_t>(0); i < chunks_count; i++) {
+        const auto src = srcs[i];
+        const auto dest = dests[i];
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+        assert(src != dest);
+        assert(chunk_sizes[i] > 0);
+
+        // find the lowest dimension where src and dest addresses differ (see get_dim_to_transfer),
+        // translating every dimension and selecting it without branches
+        auto dim_to_transfer = 0;
+        auto src_local_id = 0;
+        auto dest_local_id = 0;
+        auto src_leftover = src;
+        auto dest_leftover = dest;
+        for (auto dim = 0; dim < dims_count; dim++) {
+            const auto src_quotient = npus_count_divisor[dim].divide(src_leftover);
+            const auto dest_quotient = npus_count_divisor[dim].divide(dest_leftover);
+            const auto src_address = src_leftover - (src_quotient * npus_count_of_dim[dim]);
+            const auto dest_address = dest_leftover - (dest_quotient * npus_count_of_dim[dim]);
+
+            // only the first differing dimension is taken
+            const auto taken = (src_address != dest_address) && (src_local_id == dest_local_id);
+            dim_to_transfer = taken ? dim : dim_to_transfer;
+            src_local_id = taken ? src_address : src_local_id;
+            dest_local_id = taken ? dest_address : dest_local_id;
+
+            src_leftover = src_quotient;
+            dest_leftover = dest_quotient;
+        }
+
+        // compute hops count in the dimension
+        const auto& model = hops_count_model[dim_to_transfer];
+        auto clockwise_distance = dest_local_id - src_local_id;
+        clockwise_distance += (clockwise_distance < 0) ? npus_count_of_dim[dim_to_transfer] : 0;
+        const auto ring_distance = std::min(clockwise_distance, model.ring_length - clockwise_distance);
+        const auto hops_count = model.constant_hops_count + (model.ring_weight * ring_distance);
+
+        // same delay as the BasicTopology of the dimension
+        const auto link_delay = hops_count * latency_per_dim[dim_to_transfer];
+        const auto serialization_delay = static_cast<double>(chunk_sizes[i]) / bandwidth_Bpns_per_dim[dim_to_transfer];
+        comm_delays[i] = static_cast<EventTime>(link_delay + serialization_delay);
+    }
+}
+
+int MultiDimTopology::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // get the hops count in the dimension to transfer
+    const auto dim_to_transfer = get_dim_to_transfer(src, dest);
+    const auto src_local_id = translate_address(src, dim_to_transfer);
+    const auto dest_local_id = translate_address(dest, dim_to_transfer);
+    return topology_per_dim[dim_to_transfer]->get_hops_count(src_local_id, dest_local_id);
+}
+
+void MultiDimTopology::send_row(const DeviceId src,
+                                const ChunkSize chunk_size,
+                                uint32_t* const hops_counts,
+                                EventTime* const comm_delays) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(hops_counts != nullptr && comm_delays != nullptr);
+    assert(chunk_size > 0);
+
+    // src itself
+    hops_counts[src] = 0;
+    comm_delays[src] = 0;
+
+    // an NPU is reached through dim if it shares the src address below dim and differs at dim:
+    // it is (src % stride) + (dest_address * stride) + (k * stride * npus_count of dim), for any k
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto stride = static_cast<int>(stride_divisor_per_dim[dim].divisor);
+        const auto dim_npus_count = npus_count_per_dim[dim];
+        const auto upper_stride = stride * dim_npus_count;
+        const auto src_lower_id = src % stride;
+        const auto src_address = translate_address(src, dim);
+
+        const auto& model = hops_count_model_per_dim[dim];
+        const auto serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bpns_per_dim[dim];
+
+        for (auto dest_address = 0; dest_address < dim_npus_count; dest_address++) {
+            if (dest_address == src_address) {
+                continue;
+            }
+
+            // compute hops count and delay of the group, same as the BasicTopology of the dimension
+            auto clockwise_distance = dest_address - src_address;
+            clockwise_distance += (clockwise_distance < 0) ? dim_npus_count : 0;
+            const auto ring_distance = std::min(clockwise_distance, model.ring_length - clockwise_distance);
+            const auto hops_count = model.constant_hops_count + (model.ring_weight * ring_distance);
+            const auto link_delay = hops_count * latency_per_dim[dim];
+            const auto comm_delay = static_cast<EventTime>(link_delay + serialization_delay);
+
+            // fill in the group
+            for (auto dest = src_lower_id + (dest_address * stride); dest < npus_count; dest += upper_stride) {
+                hops_counts[dest] = static_cast<uint32_t>(hops_count);
+                comm_delays[dest] = comm_delay;
+            }
+        }
+    }
+}
+
+const BasicTopology& MultiDimTopology::get_basic_topology(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    return *topology_per_dim[dim];
+}
+
 void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology) noexcept {
+    // addresses are stored inline
+    if (dims_count >= max_dims_count) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware): "
+                  << "at most " << max_dims_count << " dimensions are supported" << std::endl;
+        std::exit(-1);
+    }
+
     // increment dims_count
     dims_count++;
 
@@ -53,37 +182,39 @@ void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology)
     const auto bandwidth = topology->get_bandwidth_per_dim()[0];
     bandwidth_per_dim.push_back(bandwidth);
 
+    // precompute the divisors of address translation
+    npus_count_divisor_per_dim.emplace_back(topology_size);
+    stride_divisor_per_dim.emplace_back(npus_count / topology_size);
+
+    // precompute the parameters of batched sends
+    hops_count_model_per_dim.push_back(topology->get_hops_count_model());
+    latency_per_dim.push_back(topology->get_latency());
+    bandwidth_Bpns_per_dim.push_back(bw_GBps_to_Bpns(bandwidth));
+
     // push back topology and npus_count
     topology_per_dim.push_back(std::move(topology));
     npus_count_per_dim.push_back(topology_size);
 }
 
 MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
     // If units-count if [2, 8, 4], and the given id is 47, then the id should be
-    // 47 // 16 = 2, leftover = 47 % 16 = 15
-    // 15 // 2 = 7, leftover = 15 % 2 = 1
-    // 1 // 1 = 1, leftover = 0
+    // 47 % 2 = 1, leftover = 47 // 2 = 23
+    // 23 % 8 = 7, leftover = 23 // 8 = 2
+    // 2 % 4 = 2, leftover = 2 // 4 = 0
     // therefore the address is [1, 7, 2]
 
     // create empty address
     auto multi_dim_address = MultiDimAddress();
-    for (auto i = 0; i < dims_count; i++) {
-        multi_dim_address.push_back(-1);
-    }
+    multi_dim_address.fill(-1);
 
     auto leftover = npu_id;
-    auto denominator = npus_count;
-
-    for (auto dim = dims_count - 1; dim >= 0; dim--) {
-        // change denominator
-        denominator /= npus_count_per_dim[dim];
-
+    for (auto dim = 0; dim < dims_count; dim++) {
         // get and update address
-        const auto quotient = leftover / denominator;
-        leftover %= denominator;
-
-        // update address
-        multi_dim_address[dim] = quotient;
+        const auto quotient = npus_count_divisor_per_dim[dim].divide(leftover);
+        multi_dim_address[dim] = leftover - (quotient * npus_count_per_dim[dim]);
+        leftover = quotient;
     }
 
     // check address translation
@@ -96,13 +227,32 @@ MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(const Devi
     return multi_dim_address;
 }
 
-int MultiDimTopology::get_dim_to_transfer(const MultiDimAddress& src_address,
-                                          const MultiDimAddress& dest_address) const noexcept {
+DeviceId MultiDimTopology::translate_address(const DeviceId npu_id, const int dim) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+    assert(0 <= dim && dim < dims_count);
+
+    // (npu_id / stride) % npus_count of the dimension
+    return npus_count_divisor_per_dim[dim].remainder(stride_divisor_per_dim[dim].divide(npu_id));
+}
+
+int MultiDimTopology::get_dim_to_transfer(const DeviceId src, const DeviceId dest) const noexcept {
+    // peel off the addresses from the lowest dimension
+    auto src_leftover = src;
+    auto dest_leftover = dest;
+
     for (auto dim = 0; dim < dims_count; dim++) {
+        const auto src_quotient = npus_count_divisor_per_dim[dim].divide(src_leftover);
+        const auto dest_quotient = npus_count_divisor_per_dim[dim].divide(dest_leftover);
+
         // check the dim that has different address
-        if (src_address[dim] != dest_address[dim]) {
+        const auto src_address = src_leftover - (src_quotient * npus_count_per_dim[dim]);
+        const auto dest_address = dest_leftover - (dest_quotient * npus_count_per_dim[dim]);
+        if (src_address != dest_address) {
             return dim;
         }
+
+        src_leftover = src_quotient;
+        dest_leftover = dest_quotient;
     }
 
     // shouldn't reach here
@@ -0,0 +1,108 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/AllPairsMatrix.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// rows are computed and written in blocks of about this many bytes
+constexpr uint64_t block_size = 256ull * 1'024 * 1'024;
+
+/// matrices start at offsets aligned to this many bytes
+constexpr uint64_t matrix_alignment = 64;
+
+}  // namespace
+
+void NetworkAnalyticalCongestionUnaware::compute_all_pairs_rows(const Topology& topology,
+                                                                const ChunkSize chunk_size,
+                                                                const DeviceId first_src,
+                                                                const int rows_count,
+                                                                uint32_t* const hops_counts,
+                                                                EventTime* const comm_delays,
+                                                                ThreadPool& thread_pool) noexcept {
+    const auto npus_count = topology.get_npus_count();
+    assert(chunk_size > 0);
+    assert(0 <= first_src && rows_count >= 0 && first_src + rows_count <= npus_count);
+    assert(rows_count == 0 || (hops_counts != nullptr && comm_delays != nullptr));
+
+    // each row is independent
+    thread_pool.parallel_for(rows_count, [&](const size_t row) {
+        const auto offset = row * npus_count;
+        topology.send_row(first_src + static_cast<DeviceId>(row), chunk_size, hops_counts + offset,
+                          comm_delays + offset);
+    });
+}
+
+void NetworkAnalyticalCongestionUnaware::write_all_pairs_matrix(const Topology& topology,
+                                                                const ChunkSize chunk_size,
+                                                                const std::string& output_path,
+                                                                const int threads_count) noexcept {
+    assert(chunk_size > 0);
+    assert(threads_count >= 0);
+
+    const auto npus_count = topology.get_npus_count();
+    const auto row_entries_count = static_cast<uint64_t>(npus_count);
+
+    // lay out the file
+    auto header = AllPairsMatrixHeader();
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, all_pairs_matrix_magic, sizeof(header.magic));
+    header.version = all_pairs_matrix_version;
+    header.npus_count = static_cast<uint32_t>(npus_count);
+    header.chunk_size = chunk_size;
+    header.hops_counts_offset = sizeof(AllPairsMatrixHeader);
+    const auto hops_counts_end = header.hops_counts_offset + (row_entries_count * row_entries_count * sizeof(uint32_t));
+    header.comm_delays_offset = (hops_counts_end + matrix_alignment - 1) / matrix_alignment * matrix_alignment;
+
+    // open the file
+    auto output = std::ofstream(output_path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "failed to open " << output_path
+                  << std::endl;
+        std::exit(-1);
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // compute and write the rows block by block
+    const auto row_size = row_entries_count * (sizeof(uint32_t) + sizeof(EventTime));
+    const auto block_rows_count = static_cast<int>(std::clamp(block_size / row_size, static_cast<uint64_t>(1),
+                                                              static_cast<uint64_t>(npus_count)));
+    auto hops_counts = std::vector<uint32_t>(block_rows_count * row_entries_count);
+    auto comm_delays = std::vector<EventTime>(block_rows_count * row_entries_count);
+    auto thread_pool = ThreadPool(threads_count);
+
+    for (auto first_src = 0; first_src < npus_count; first_src += block_rows_count) {
+        const auto rows_count = std::min(block_rows_count, npus_count - first_src);
+        compute_all_pairs_rows(topology, chunk_size, first_src, rows_count, hops_counts.data(), comm_delays.data(),
+                               thread_pool);
+
+        const auto first_entry = static_cast<uint64_t>(first_src) * row_entries_count;
+        const auto entries_count = static_cast<uint64_t>(rows_count) * row_entries_count;
+        output.seekp(static_cast<std::streamoff>(header.hops_counts_offset + (first_entry * sizeof(uint32_t))));
+        output.write(reinterpret_cast<const char*>(hops_counts.data()),
+                     static_cast<std::streamsize>(entries_count * sizeof(uint32_t)));
+        output.seekp(static_cast<std::streamoff>(header.comm_delays_offset + (first_entry * sizeof(EventTime))));
+        output.write(reinterpret_cast<const char*>(comm_delays.data()),
+                     static_cast<std::streamsize>(entries_count * sizeof(EventTime)));
+    }
+
+    // check every write went through
+    output.close();
+    if (output.fail()) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "failed to write " << output_path
+                  << std::endl;
+        std::exit(-1);
+    }
+}
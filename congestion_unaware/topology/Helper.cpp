@@ -8,9 +8,14 @@ LICENSE file in the root directory of this source tree.
 #include "congestion_unaware/FullyConnected.h"
 #include "congestion_unaware/MultiDimTopology.h"
 #include "congestion_unaware/Ring.h"
+#include "congestion_unaware/StaticMultiDimTopology.h"
 #include "congestion_unaware/Switch.h"
+#include <algorithm>
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
@@ -84,3 +89,50 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology
     // return created multi-dimensional topology
     return multi_dim_topology;
 }
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_static_topology(
+    const NetworkParser& network_parser) noexcept {
+    auto static_topology = std::shared_ptr<Topology>();
+
+    // copy the matching instantiation, if any
+    visit_static_topology(network_parser, [&](const auto& topology) {
+        using StaticTopology = std::decay_t<decltype(topology)>;
+        static_topology = std::make_shared<StaticTopology>(topology);
+    });
+
+    return static_topology;
+}
+
+EventTime NetworkAnalyticalCongestionUnaware::simulate_all_to_all(const NetworkParser& network_parser,
+                                                                  const ChunkSize chunk_size) noexcept {
+    assert(chunk_size > 0);
+
+    // create topology, preferring its static form
+    auto topology = construct_static_topology(network_parser);
+    if (topology == nullptr) {
+        topology = construct_topology(network_parser);
+    }
+    const auto npus_count = topology->get_npus_count();
+
+    // every NPU sends to every other NPU, one batch per src NPU
+    auto srcs = std::vector<DeviceId>(npus_count - 1);
+    auto dests = std::vector<DeviceId>(npus_count - 1);
+    const auto chunk_sizes = std::vector<ChunkSize>(npus_count - 1, chunk_size);
+    auto comm_delays = std::vector<EventTime>(npus_count - 1);
+
+    // the All-to-All finishes when the longest send finishes
+    auto finish_time = static_cast<EventTime>(0);
+    for (auto src = 0; src < npus_count; src++) {
+        std::fill(srcs.begin(), srcs.end(), src);
+        for (auto dest = 0; dest < npus_count - 1; dest++) {
+            dests[dest] = (dest < src) ? dest : (dest + 1);
+        }
+
+        topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), comm_delays.data(), npus_count - 1);
+        for (const auto comm_delay : comm_delays) {
+            finish_time = std::max(finish_time, comm_delay);
+        }
+    }
+
+    return finish_time;
+}
@@ -0,0 +1,242 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/PhaseContentionModel.h"
+#include "common/NetworkFunction.h"
+#include "congestion_unaware/Helper.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+PhaseContentionModel::PhaseContentionModel(const BasicTopology& topology) noexcept
+    : npus_count(1),
+      dims_count(0),
+      dense_links_count(0) {
+    append_dimension(topology);
+    allocate_links();
+}
+
+PhaseContentionModel::PhaseContentionModel(const MultiDimTopology& topology) noexcept
+    : npus_count(1),
+      dims_count(0),
+      dense_links_count(0) {
+    for (auto dim = 0; dim < topology.get_dims_count(); dim++) {
+        append_dimension(topology.get_basic_topology(dim));
+    }
+    allocate_links();
+}
+
+PhaseContentionModel::PhaseContentionModel(const NetworkParser& network_parser) noexcept
+    : npus_count(1),
+      dims_count(0),
+      dense_links_count(0) {
+    // construct_topology creates a BasicTopology for a single dimension, a MultiDimTopology otherwise
+    const auto topology = construct_topology(network_parser);
+    if (network_parser.get_dims_count() == 1) {
+        append_dimension(*std::static_pointer_cast<BasicTopology>(topology));
+    } else {
+        const auto multi_dim_topology = std::static_pointer_cast<MultiDimTopology>(topology);
+        for (auto dim = 0; dim < multi_dim_topology->get_dims_count(); dim++) {
+            append_dimension(multi_dim_topology->get_basic_topology(dim));
+        }
+    }
+    allocate_links();
+}
+
+EventTime PhaseContentionModel::estimate_phase(const DeviceId* const srcs,
+                                               const DeviceId* const dests,
+                                               const ChunkSize* const transfer_sizes,
+                                               EventTime* const comm_delays,
+                                               const size_t transfers_count) noexcept {
+    assert(transfers_count == 0 || (srcs != nullptr && dests != nullptr));
+    assert(transfers_count == 0 || (transfer_sizes != nullptr && comm_delays != nullptr));
+
+    // accumulate the load of every link
+    for (auto i = static_cast<size_t>(0); i < transfers_count; i++) {
+        assert(0 <= srcs[i] && srcs[i] < npus_count);
+        assert(0 <= dests[i] && dests[i] < npus_count);
+        assert(srcs[i] != dests[i]);
+        assert(transfer_sizes[i] > 0);
+
+        const auto transfer_size = static_cast<double>(transfer_sizes[i]);
+        const auto dim = get_dim_to_transfer(srcs[i], dests[i]);
+        for_each_link(dim, srcs[i], dests[i], [&](const size_t link) {
+            const auto slot = link_slot(link);
+            if (link_transfers_counts[slot] == 0) {
+                loaded_links.push_back(slot);
+            }
+            link_loads[slot] += transfer_size;
+            link_transfers_counts[slot]++;
+        });
+    }
+
+    // serve each transfer its share of its bottleneck link
+    auto phase_delay = EventTime(0);
+    for (auto i = static_cast<size_t>(0); i < transfers_count; i++) {
+        const auto transfer_size = static_cast<double>(transfer_sizes[i]);
+        const auto dim = get_dim_to_transfer(srcs[i], dests[i]);
+        auto hops_count = 0;
+        auto bottleneck_size = 0.0;
+        for_each_link(dim, srcs[i], dests[i], [&](const size_t link) {
+            const auto slot = link_slot(link);
+            const auto shared_size = std::min(link_loads[slot], link_transfers_counts[slot] * transfer_size);
+            bottleneck_size = std::max(bottleneck_size, shared_size);
+            hops_count++;
+        });
+
+        // same as Topology::send, with the bottleneck bytes serialized
+        const auto link_delay = hops_count * latency_per_dim[dim];
+        const auto serialization_delay = bottleneck_size / bandwidth_Bpns_per_dim[dim];
+        comm_delays[i] = static_cast<EventTime>(link_delay + serialization_delay);
+        phase_delay = std::max(phase_delay, comm_delays[i]);
+    }
+
+    // clear the loaded links for the next phase, and drop the FullyConnected ones
+    for (const auto slot : loaded_links) {
+        link_loads[slot] = 0;
+        link_transfers_counts[slot] = 0;
+    }
+    loaded_links.clear();
+    link_loads.resize(dense_links_count);
+    link_transfers_counts.resize(dense_links_count);
+    sparse_link_slots.clear();
+
+    return phase_delay;
+}
+
+size_t PhaseContentionModel::get_links_count() const noexcept {
+    return link_loads.size();
+}
+
+size_t PhaseContentionModel::link_slot(const size_t link) noexcept {
+    if (link < dense_links_count) {
+        return link;
+    }
+
+    // take a slot for a FullyConnected link on its first load in the phase
+    const auto [slot, inserted] = sparse_link_slots.try_emplace(link, link_loads.size());
+    if (inserted) {
+        link_loads.push_back(0);
+        link_transfers_counts.push_back(0);
+    }
+    return slot->second;
+}
+
+void PhaseContentionModel::append_dimension(const BasicTopology& topology) noexcept {
+    const auto dim_npus_count = topology.get_npus_count();
+
+    dims_count++;
+    npus_count_per_dim.push_back(dim_npus_count);
+    stride_per_dim.push_back(npus_count);
+    npus_count *= dim_npus_count;
+    topology_type_per_dim.push_back(topology.get_basic_topology_type());
+    bandwidth_Bpns_per_dim.push_back(bw_GBps_to_Bpns(topology.get_bandwidth_per_dim()[0]));
+    latency_per_dim.push_back(topology.get_latency());
+
+    // only a unidirectional ring has to take the long way round
+    bidirectional_per_dim.push_back(topology.get_hops_count_model().ring_length == dim_npus_count);
+}
+
+void PhaseContentionModel::allocate_links() noexcept {
+    // every dimension is replicated for every address of the other dimensions, i.e., has npus_count NPUs in total:
+    //   - Ring: a clockwise and an anticlockwise link per NPU
+    //   - Switch: an uplink and a downlink port per NPU
+    //   - FullyConnected: a link per NPU to each address of the dimension, numbered after the dense links
+    first_link_per_dim.assign(dims_count, 0);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        switch (topology_type_per_dim[dim]) {
+        case TopologyBuildingBlock::Ring:
+        case TopologyBuildingBlock::Switch:
+            first_link_per_dim[dim] = dense_links_count;
+            dense_links_count += 2 * static_cast<size_t>(npus_count);
+            break;
+        case TopologyBuildingBlock::FullyConnected:
+            break;
+        default:
+            // shouldn't reach here
+            std::cerr << "[Error] (network/analytical/congestion_unaware): " << "Not supported topology type"
+                      << std::endl;
+            std::exit(-1);
+        }
+    }
+    auto sparse_links_count = dense_links_count;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (topology_type_per_dim[dim] == TopologyBuildingBlock::FullyConnected) {
+            first_link_per_dim[dim] = sparse_links_count;
+            sparse_links_count += static_cast<size_t>(npus_count) * npus_count_per_dim[dim];
+        }
+    }
+
+    link_loads.assign(dense_links_count, 0);
+    link_transfers_counts.assign(dense_links_count, 0);
+}
+
+int PhaseContentionModel::get_dim_to_transfer(const DeviceId src, const DeviceId dest) const noexcept {
+    // peel off the addresses from the lowest dimension
+    auto src_leftover = src;
+    auto dest_leftover = dest;
+
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (src_leftover % npus_count_per_dim[dim] != dest_leftover % npus_count_per_dim[dim]) {
+            return dim;
+        }
+        src_leftover /= npus_count_per_dim[dim];
+        dest_leftover /= npus_count_per_dim[dim];
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical/congestion_unaware): " << "src and dest have the same address"
+              << std::endl;
+    std::exit(-1);
+}
+
+template <typename Visit>
+void PhaseContentionModel::for_each_link(const int dim,
+                                         const DeviceId src,
+                                         const DeviceId dest,
+                                         Visit&& visit) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    const auto dim_npus_count = npus_count_per_dim[dim];
+    const auto stride = stride_per_dim[dim];
+    const auto src_address = (src / stride) % dim_npus_count;
+    const auto dest_address = (dest / stride) % dim_npus_count;
+    const auto first_link = first_link_per_dim[dim];
+
+    switch (topology_type_per_dim[dim]) {
+    case TopologyBuildingBlock::Ring: {
+        // walk the ring, clockwise unless anticlockwise is shorter
+        auto clockwise_distance = dest_address - src_address;
+        clockwise_distance += (clockwise_distance < 0) ? dim_npus_count : 0;
+        const auto anticlockwise_distance = dim_npus_count - clockwise_distance;
+        const auto anticlockwise = bidirectional_per_dim[dim] && (anticlockwise_distance < clockwise_distance);
+        const auto step = anticlockwise ? (dim_npus_count - 1) : 1;
+
+        const auto base_npu = src - (src_address * stride);
+        for (auto address = src_address; address != dest_address; address = (address + step) % dim_npus_count) {
+            const auto npu = static_cast<size_t>(base_npu + (address * stride));
+            visit(first_link + (2 * npu) + (anticlockwise ? 1 : 0));
+        }
+        return;
+    }
+    case TopologyBuildingBlock::FullyConnected:
+        visit(first_link + (static_cast<size_t>(src) * dim_npus_count) + dest_address);
+        return;
+    case TopologyBuildingBlock::Switch:
+        visit(first_link + (2 * static_cast<size_t>(src)));
+        visit(first_link + (2 * static_cast<size_t>(dest)) + 1);
+        return;
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_unaware): " << "Not supported topology type"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
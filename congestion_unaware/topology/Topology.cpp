@@ -11,6 +11,40 @@ using namespace NetworkAnalyticalCongestionUnaware;
 
 Topology::Topology() noexcept : npus_count(-1), dims_count(-1) {}
 
+void Topology::send_batch(const DeviceId* const srcs,
+                          const DeviceId* const dests,
+                          const ChunkSize* const chunk_sizes,
+                          EventTime* const comm_delays,
+                          const size_t chunks_count) const noexcept {
+    assert(chunks_count == 0 || (srcs != nullptr && dests != nullptr));
+    assert(chunks_count == 0 || (chunk_sizes != nullptr && comm_delays != nullptr));
+
+    // send each chunk
+    for (auto i = static_cast<size_t>(0); i < chunks_count; i++) {
+        comm_delays[i] = send(srcs[i], dests[i], chunk_sizes[i]);
+    }
+}
+
+void Topology::send_row(const DeviceId src,
+                        const ChunkSize chunk_size,
+                        uint32_t* const hops_counts,
+                        EventTime* const comm_delays) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(hops_counts != nullptr && comm_delays != nullptr);
+
+    // send to each NPU
+    for (auto dest = 0; dest < npus_count; dest++) {
+        if (dest == src) {
+            hops_counts[dest] = 0;
+            comm_delays[dest] = 0;
+            continue;
+        }
+
+        hops_counts[dest] = static_cast<uint32_t>(get_hops_count(src, dest));
+        comm_delays[dest] = send(src, dest, chunk_size);
+    }
+}
+
 int Topology::get_npus_count() const noexcept {
     assert(npus_count > 0);
 
@@ -0,0 +1,123 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueueEngine.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * CalendarQueueEngine implements an EventQueueEngine as a calendar queue (R. Brown, 1988).
+ *
+ * Events are hashed into an array of buckets ("days") by (event time / bucket width),
+ * wrapping around the array ("year"). Each bucket is kept sorted.
+ * Extraction scans the days in order starting from the current one,
+ * so that both push and pop take O(1) expected time
+ * once the bucket width matches the spacing of pending events.
+ *
+ * The number of buckets doubles (halves) when the queue grows (shrinks) past a threshold,
+ * and the bucket width is re-estimated from the spacing of the earliest events.
+ * Buckets chain events through their intrusive links, so only resizing allocates.
+ */
+class CalendarQueueEngine final : public EventQueueEngine {
+  public:
+    /**
+     * Constructor.
+     */
+    CalendarQueueEngine() noexcept;
+
+    /**
+     * Implementation of push method in EventQueueEngine.
+     */
+    void push(ScheduledEvent* event) noexcept override;
+
+    /**
+     * Implementation of pop method in EventQueueEngine.
+     */
+    ScheduledEvent* pop() noexcept override;
+
+    /**
+     * Implementation of next_event_time method in EventQueueEngine.
+     */
+    [[nodiscard]] EventTime next_event_time() noexcept override;
+
+    /**
+     * Implementation of empty method in EventQueueEngine.
+     */
+    [[nodiscard]] bool empty() const noexcept override;
+
+  private:
+    /**
+     * Bucket is a day of the calendar:
+     * an intrusive singly-linked list sorted in (event time, sequence) order.
+     */
+    struct Bucket {
+        /// earliest event of the bucket
+        ScheduledEvent* head;
+
+        /// latest event of the bucket
+        ScheduledEvent* tail;
+    };
+
+    /// days of the calendar
+    std::vector<Bucket> buckets;
+
+    /// time span covered by a single bucket
+    EventTime bucket_width;
+
+    /// index of the bucket the scan is currently at
+    size_t current_bucket;
+
+    /// (exclusive) end time of the current bucket within the current year
+    EventTime current_bucket_end;
+
+    /// number of events held by the calendar
+    size_t events_count;
+
+    /// scratch space to drain events into while resizing, kept to reuse its capacity
+    std::vector<ScheduledEvent*> resize_buffer;
+
+    /**
+     * Get the bucket index the given event time is hashed into.
+     *
+     * @param event_time event time to hash
+     * @return bucket index
+     */
+    [[nodiscard]] size_t bucket_index(EventTime event_time) const noexcept;
+
+    /**
+     * Move the scan position to the day holding the given event time.
+     *
+     * @param event_time event time to move to
+     */
+    void move_to(EventTime event_time) noexcept;
+
+    /**
+     * Insert an event into its bucket, keeping the bucket sorted.
+     *
+     * @param event event to insert
+     */
+    void insert(ScheduledEvent* event) noexcept;
+
+    /**
+     * Advance the scan position until it reaches the bucket holding the earliest event.
+     * The calendar should not be empty.
+     */
+    void locate_earliest_event() noexcept;
+
+    /**
+     * Rebuild the calendar with the given number of buckets
+     * and a freshly estimated bucket width.
+     *
+     * @param buckets_count number of buckets of the new calendar
+     */
+    void resize(size_t buckets_count) noexcept;
+};
+
+}  // namespace NetworkAnalytical
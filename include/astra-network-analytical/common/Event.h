@@ -15,6 +15,12 @@ namespace NetworkAnalytical {
  */
 class Event {
   public:
+    /**
+     * Default constructor, creating an empty event slot.
+     * A callback should be assigned before the event gets invoked.
+     */
+    Event() noexcept;
+
     /**
      * Constructor.
      *
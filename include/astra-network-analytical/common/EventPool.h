@@ -0,0 +1,69 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueueEngine.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * EventPool recycles ScheduledEvent slots.
+ *
+ * Slots are allocated in fixed-size slabs and handed out through an intrusive free list,
+ * so once the pool has grown to the peak number of pending events,
+ * acquiring and releasing events does not touch the heap allocator at all.
+ */
+class EventPool {
+  public:
+    /**
+     * Constructor.
+     */
+    EventPool() noexcept;
+
+    /**
+     * Take a free event slot, growing the pool by a slab if none is left.
+     *
+     * @return pointer to the free event slot
+     */
+    [[nodiscard]] ScheduledEvent* acquire() noexcept;
+
+    /**
+     * Return an event slot to the pool.
+     *
+     * @param event event slot to recycle
+     */
+    void release(ScheduledEvent* event) noexcept;
+
+    /**
+     * Get the number of event slots allocated from the heap so far.
+     * This stays constant during steady-state simulation.
+     *
+     * @return number of allocated event slots
+     */
+    [[nodiscard]] uint64_t get_events_allocated_count() const noexcept;
+
+  private:
+    /// number of event slots per slab
+    static constexpr size_t slab_size = 4096;
+
+    /// allocated slabs, which own the event slots
+    std::vector<std::unique_ptr<ScheduledEvent[]>> slabs;
+
+    /// head of the free slot list
+    ScheduledEvent* free_list;
+
+    /**
+     * Allocate a new slab and thread its slots onto the free list.
+     */
+    void allocate_slab() noexcept;
+};
+
+}  // namespace NetworkAnalytical
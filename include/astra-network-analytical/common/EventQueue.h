@@ -5,20 +5,35 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
-#include "common/EventList.h"
+#include "common/EventPool.h"
+#include "common/EventQueueEngine.h"
 #include "common/Type.h"
+#include <cstdint>
+#include <memory>
 
 namespace NetworkAnalytical {
 
+struct EventQueuePartition;
+class ParallelEventQueue;
+
 /**
- * EventQueue manages scheduled EventLists.
+ * EventQueue manages scheduled Events.
+ * Events are invoked in the order of their event time,
+ * and events registered at the same event time are invoked in FIFO order.
  */
 class EventQueue {
   public:
     /**
      * Constructor.
+     *
+     * @param engine_type priority queue engine to hold the scheduled events
+     */
+    explicit EventQueue(EventQueueEngineType engine_type = EventQueueEngineType::QuaternaryHeap) noexcept;
+
+    /**
+     * Destructor.
      */
-    EventQueue() noexcept;
+    ~EventQueue() noexcept;
 
     /**
      * Get current event time of the event queue.
@@ -52,12 +67,102 @@ class EventQueue {
      */
     void schedule_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
 
+    /**
+     * Schedule an event on another partition of the same ParallelEventQueue.
+     * The event is ordered as if it had been scheduled on this event queue,
+     * and is delivered to the other partition at the next synchronization,
+     * so the event time should be at least the lookahead of the ParallelEventQueue after the current time.
+     *
+     * @param event_queue event queue of the partition to schedule the event on
+     * @param event_time time of event
+     * @param callback callback function pointer
+     * @param callback_arg argument of the callback function
+     */
+    void schedule_remote_event(EventQueue& event_queue,
+                               EventTime event_time,
+                               Callback callback,
+                               CallbackArg callback_arg) noexcept;
+
+    /**
+     * Reserve a sequence number for an event that may or may not be scheduled later.
+     * If scheduled with the reserved sequence number, the event is ordered
+     * exactly as if it had been scheduled at the time of the reservation.
+     *
+     * @return reserved sequence number
+     */
+    [[nodiscard]] uint64_t reserve_sequence() noexcept;
+
+    /**
+     * Schedule an event with a given event time and a previously reserved sequence number.
+     * The event should not have been passed yet.
+     *
+     * @param event_time time of event
+     * @param sequence sequence number obtained from reserve_sequence
+     * @param callback callback function pointer
+     * @param callback_arg argument of the callback function
+     */
+    void schedule_reserved_event(EventTime event_time,
+                                 uint64_t sequence,
+                                 Callback callback,
+                                 CallbackArg callback_arg) noexcept;
+
+    /**
+     * Check whether an event with the given event time and sequence number
+     * would have already been invoked, had it been scheduled.
+     *
+     * @param event_time time of event
+     * @param sequence sequence number of event
+     * @return true if the event queue has already passed the event, false otherwise
+     */
+    [[nodiscard]] bool passed(EventTime event_time, uint64_t sequence) const noexcept;
+
+    /**
+     * Get the number of events scheduled so far.
+     *
+     * @return number of scheduled events
+     */
+    [[nodiscard]] uint64_t get_scheduled_events_count() const noexcept;
+
+    /**
+     * Get the number of event slots the event queue has allocated from the heap so far.
+     * Event slots are recycled, so this stays constant once the number of pending events
+     * has reached its peak, i.e., steady-state scheduling performs no heap allocation.
+     *
+     * @return number of allocated event slots
+     */
+    [[nodiscard]] uint64_t get_allocated_event_slots_count() const noexcept;
+
   private:
+    /// ParallelEventQueue drives the event queues of its partitions
+    friend class ParallelEventQueue;
+
     /// current time of the event queue
     EventTime current_time;
 
-    /// list of EventLists
-    std::list<EventList> event_queue;
+    /// sequence number to be given to the next scheduled (or reserved) event
+    uint64_t next_sequence;
+
+    /// events at current_time with a smaller sequence number than this have been invoked
+    uint64_t invoked_sequence_bound;
+
+    /// number of events scheduled so far
+    uint64_t scheduled_events_count;
+
+    /// recycles the storage of scheduled events
+    EventPool event_pool;
+
+    /// priority queue holding the scheduled events
+    std::unique_ptr<EventQueueEngine> engine;
+
+    /// state as a partition of a ParallelEventQueue, or nullptr for a sequential event queue
+    std::unique_ptr<EventQueuePartition> partition;
+
+    /**
+     * Reserve the sequence number of an event scheduled on a partition of a ParallelEventQueue.
+     *
+     * @return reserved sequence number
+     */
+    [[nodiscard]] uint64_t reserve_partition_sequence() noexcept;
 };
 
 }  // namespace NetworkAnalytical
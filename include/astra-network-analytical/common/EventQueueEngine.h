@@ -0,0 +1,96 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Event.h"
+#include "common/Type.h"
+#include <cstdint>
+
+namespace NetworkAnalytical {
+
+/**
+ * ScheduledEvent is an Event tagged with its event time
+ * and the sequence number it was scheduled with.
+ * The sequence number breaks ties between events registered at the same event time,
+ * so that they are invoked in FIFO order.
+ *
+ * ScheduledEvents are recycled by an EventPool,
+ * and carry an intrusive link so that engines can chain them without allocating list nodes.
+ */
+struct ScheduledEvent {
+    /// time the event should be invoked
+    EventTime event_time;
+
+    /// scheduling order of the event
+    uint64_t sequence;
+
+    /// callback and its argument
+    Event event;
+
+    /// intrusive link, owned by whichever list (engine bucket or pool free list) holds the event
+    ScheduledEvent* next;
+
+    /**
+     * Check whether this event should be invoked before the other event.
+     *
+     * @param other event to compare with
+     * @return true if this event precedes the other event, false otherwise
+     */
+    [[nodiscard]] bool precedes(const ScheduledEvent& other) const noexcept {
+        if (event_time != other.event_time) {
+            return event_time < other.event_time;
+        }
+        return sequence < other.sequence;
+    }
+};
+
+/**
+ * EventQueueEngine abstracts the priority queue holding the scheduled events of an EventQueue.
+ * Events are extracted in increasing (event time, sequence) order.
+ *
+ * Engines only hold pointers to events owned by the EventQueue's EventPool,
+ * and may freely overwrite their intrusive next link.
+ */
+class EventQueueEngine {
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~EventQueueEngine() noexcept;
+
+    /**
+     * Insert an event into the engine.
+     *
+     * @param event event to insert
+     */
+    virtual void push(ScheduledEvent* event) noexcept = 0;
+
+    /**
+     * Remove and return the earliest event.
+     * The engine should not be empty.
+     *
+     * @return earliest event
+     */
+    virtual ScheduledEvent* pop() noexcept = 0;
+
+    /**
+     * Get the event time of the earliest event.
+     * The engine should not be empty.
+     * This is not a const method, as engines may lazily reorganize themselves to locate the event.
+     *
+     * @return event time of the earliest event
+     */
+    [[nodiscard]] virtual EventTime next_event_time() noexcept = 0;
+
+    /**
+     * Check whether the engine holds no event.
+     *
+     * @return true if the engine is empty, false otherwise
+     */
+    [[nodiscard]] virtual bool empty() const noexcept = 0;
+};
+
+}  // namespace NetworkAnalytical
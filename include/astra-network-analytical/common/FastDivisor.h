@@ -0,0 +1,73 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace NetworkAnalytical {
+
+/**
+ * FastDivisor divides non-negative ints by a fixed positive divisor
+ * with a multiplication and a shift instead of an integer division.
+ *
+ * With shift = ceil(log2(divisor)) and multiplier = floor(2^(32 + shift) / divisor) + 1,
+ * (dividend * multiplier) >> (32 + shift) equals dividend / divisor for every dividend below 2^32
+ * (Granlund and Montgomery, "Division by Invariant Integers using Multiplication").
+ * As dividends are ints (below 2^31) and the multiplier is below 2^33, the product fits in 64 bits.
+ */
+struct FastDivisor {
+    /// divisor
+    uint32_t divisor;
+
+    /// reciprocal of the divisor, scaled by 2^(32 + shift) and rounded up
+    uint64_t multiplier;
+
+    /// 32 + ceil(log2(divisor))
+    int shift;
+
+    /**
+     * Constructor.
+     *
+     * @param divisor divisor, should be positive
+     */
+    explicit FastDivisor(const int divisor) noexcept : divisor(static_cast<uint32_t>(divisor)) {
+        assert(divisor > 0);
+
+        // ceil(log2(divisor))
+        auto log2_divisor = 0;
+        while ((static_cast<uint64_t>(1) << log2_divisor) < this->divisor) {
+            log2_divisor++;
+        }
+
+        shift = 32 + log2_divisor;
+        multiplier = ((static_cast<uint64_t>(1) << shift) / this->divisor) + 1;
+    }
+
+    /**
+     * Compute dividend / divisor.
+     *
+     * @param dividend dividend, should be non-negative
+     * @return quotient
+     */
+    [[nodiscard]] int divide(const int dividend) const noexcept {
+        assert(dividend >= 0);
+
+        return static_cast<int>((static_cast<uint64_t>(dividend) * multiplier) >> shift);
+    }
+
+    /**
+     * Compute dividend % divisor.
+     *
+     * @param dividend dividend, should be non-negative
+     * @return remainder
+     */
+    [[nodiscard]] int remainder(const int dividend) const noexcept {
+        return dividend - (divide(dividend) * static_cast<int>(divisor));
+    }
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,59 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueueEngine.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * HeapEventQueueEngine implements an EventQueueEngine as an implicit d-ary min-heap.
+ * Both push and pop take O(log n) time.
+ *
+ * Arity=2 is the classic binary heap.
+ * Arity=4 makes the heap shallower and each sift-down to scan a single cache line of children.
+ *
+ * @tparam Arity number of children per heap node
+ */
+template <int Arity> class HeapEventQueueEngine final : public EventQueueEngine {
+  public:
+    static_assert(Arity >= 2, "heap arity should be at least 2");
+
+    /**
+     * Constructor.
+     */
+    HeapEventQueueEngine() noexcept;
+
+    /**
+     * Implementation of push method in EventQueueEngine.
+     */
+    void push(ScheduledEvent* event) noexcept override;
+
+    /**
+     * Implementation of pop method in EventQueueEngine.
+     */
+    ScheduledEvent* pop() noexcept override;
+
+    /**
+     * Implementation of next_event_time method in EventQueueEngine.
+     */
+    [[nodiscard]] EventTime next_event_time() noexcept override;
+
+    /**
+     * Implementation of empty method in EventQueueEngine.
+     */
+    [[nodiscard]] bool empty() const noexcept override;
+
+  private:
+    /// heap-ordered events, heap[0] is the earliest one
+    /// the vector keeps its capacity, so steady-state push and pop do not allocate
+    std::vector<ScheduledEvent*> heap;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,157 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueueEngine.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * LadderQueueEngine implements an EventQueueEngine as a ladder queue (W. T. Tang et al., 2005).
+ *
+ * Events are held in three tiers:
+ *   - Top: unsorted events far in the future
+ *   - Ladder: rungs of unsorted buckets, where each rung refines one bucket of the rung above
+ *   - Bottom: a short sorted list of the earliest events
+ * Events are only sorted once they reach Bottom, in small batches,
+ * which gives O(1) amortized push and pop regardless of the event time distribution.
+ * Every tier chains events through their intrusive links,
+ * and retired rungs are kept for reuse, so steady-state operation does not allocate.
+ */
+class LadderQueueEngine final : public EventQueueEngine {
+  public:
+    /**
+     * Constructor.
+     */
+    LadderQueueEngine() noexcept;
+
+    /**
+     * Implementation of push method in EventQueueEngine.
+     */
+    void push(ScheduledEvent* event) noexcept override;
+
+    /**
+     * Implementation of pop method in EventQueueEngine.
+     */
+    ScheduledEvent* pop() noexcept override;
+
+    /**
+     * Implementation of next_event_time method in EventQueueEngine.
+     */
+    [[nodiscard]] EventTime next_event_time() noexcept override;
+
+    /**
+     * Implementation of empty method in EventQueueEngine.
+     */
+    [[nodiscard]] bool empty() const noexcept override;
+
+  private:
+    /**
+     * Bucket is an unsorted intrusive singly-linked list of events.
+     */
+    struct Bucket {
+        /// first event of the bucket
+        ScheduledEvent* head;
+
+        /// number of events in the bucket
+        size_t events_count;
+    };
+
+    /**
+     * Rung is a single level of the ladder.
+     * Bucket i covers [start + i * bucket_width, start + (i + 1) * bucket_width).
+     */
+    struct Rung {
+        /// start time of the first bucket
+        EventTime start;
+
+        /// time span covered by a single bucket
+        EventTime bucket_width;
+
+        /// first bucket which has not been handed down yet
+        size_t current_bucket;
+
+        /// buckets of the rung
+        std::vector<Bucket> buckets;
+
+        /**
+         * Get the start time of the current bucket.
+         *
+         * @return start time of the current bucket
+         */
+        [[nodiscard]] EventTime current_bucket_start() const noexcept {
+            return start + current_bucket * bucket_width;
+        }
+    };
+
+    /// unsorted events at or after top_start
+    Bucket top;
+
+    /// smallest event time in top
+    EventTime top_min;
+
+    /// largest event time in top
+    EventTime top_max;
+
+    /// events at or after this time are inserted into top
+    EventTime top_start;
+
+    /// rungs of the ladder, from the coarsest to the finest one
+    /// only the first rungs_count rungs are in use, the others are kept to reuse their buckets
+    std::vector<Rung> rungs;
+
+    /// number of rungs in use
+    size_t rungs_count;
+
+    /// earliest events, as an intrusive singly-linked list sorted in (event time, sequence) order
+    ScheduledEvent* bottom;
+
+    /// scratch space to sort buckets in, kept to reuse its capacity
+    std::vector<ScheduledEvent*> sort_buffer;
+
+    /// number of events held by the queue
+    size_t events_count;
+
+    /**
+     * Insert an event into bottom, keeping it sorted.
+     *
+     * @param event event to insert
+     */
+    void insert_bottom(ScheduledEvent* event) noexcept;
+
+    /**
+     * Refill the (empty) bottom with the earliest events,
+     * spawning finer rungs on the way if a bucket holds too many events.
+     */
+    void refill_bottom() noexcept;
+
+    /**
+     * Move every event in top into a new (first) rung.
+     */
+    void transfer_top_to_ladder() noexcept;
+
+    /**
+     * Create a new rung at the bottom of the ladder, and spread the given events over it.
+     *
+     * @param events events to spread
+     * @param start start time of the new rung
+     * @param span time span the new rung should cover
+     * @param buckets_count number of buckets the span should be divided into
+     */
+    void spawn_rung(Bucket events, EventTime start, EventTime span, EventTime buckets_count) noexcept;
+
+    /**
+     * Sort the given events and make them the bottom.
+     *
+     * @param events events to sort
+     */
+    void sort_into_bottom(Bucket events) noexcept;
+};
+
+}  // namespace NetworkAnalytical
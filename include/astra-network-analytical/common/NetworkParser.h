@@ -23,6 +23,13 @@ class NetworkParser {
      */
     explicit NetworkParser(const std::string& path) noexcept;
 
+    /**
+     * Constructor.
+     *
+     * @param network_config already loaded network configuration YAML node
+     */
+    explicit NetworkParser(const YAML::Node& network_config) noexcept;
+
     /**
      * Return the number of network dimensions.
      * Which is calculated by the length of "topology" value
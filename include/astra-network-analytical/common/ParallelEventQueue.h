@@ -0,0 +1,267 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Event.h"
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * EventQueuePartition holds the state an EventQueue needs as a partition of a ParallelEventQueue.
+ *
+ * In a partition, the sequence number of an event is derived from the event that scheduled it:
+ * (rank of the scheduling event, index among the events it scheduled).
+ * Events scheduled before the simulation (roots) simply take increasing sequence numbers.
+ * As a sequential EventQueue invokes events in (event time, sequence) order
+ * and numbers new events in that same order, these sequences order same-time events
+ * exactly like a single EventQueue would, regardless of how the simulation is partitioned.
+ *
+ * The rank of an invoked event is its position in the global invocation order.
+ * It is only known once every partition has finished the window of the event,
+ * so events logged in the current window carry a provisional rank (rank_base + log index),
+ * which is replaced by the actual rank before the event's children are delivered.
+ */
+struct EventQueuePartition {
+    /**
+     * StagedEvent is an event waiting in an outbox for the next synchronization.
+     */
+    struct StagedEvent {
+        /// time the event should be invoked
+        EventTime event_time;
+
+        /// sequence number of the event
+        uint64_t sequence;
+
+        /// callback and its argument
+        Event event;
+    };
+
+    /**
+     * LoggedEvent is an event invoked in the current window that has scheduled other events.
+     */
+    struct LoggedEvent {
+        /// time the event was invoked
+        EventTime event_time;
+
+        /// sequence number of the event
+        uint64_t sequence;
+    };
+
+    /// index of the partition
+    int index;
+
+    /// events scheduled at or after this time are staged until the next synchronization
+    EventTime window_end;
+
+    /// rank of the first event logged in the current window
+    uint64_t rank_base;
+
+    /// next sequence number of root events, shared by every partition
+    uint64_t* root_sequence;
+
+    /// true while the event queue is invoking events
+    bool invoking;
+
+    /// true if the event being invoked has been logged
+    bool invoked_event_logged;
+
+    /// sequence number of the next event scheduled by the event being invoked
+    uint64_t next_child_sequence;
+
+    /// events invoked in the current window that have scheduled other events, in invocation order
+    std::vector<LoggedEvent> logged_events;
+
+    /// actual rank of each logged event, computed at the end of the window
+    std::vector<uint64_t> logged_event_ranks;
+
+    /// staged events, per destination partition
+    std::vector<std::vector<StagedEvent>> outboxes;
+};
+
+/**
+ * ParallelEventQueue runs a simulation split into multiple EventQueue partitions,
+ * each on its own thread, with conservative (YAWNS-style) synchronization.
+ *
+ * Partitions proceed in lockstep windows of [window start, window start + lookahead),
+ * where the window start is the earliest pending event of all partitions.
+ * An event scheduled on another partition (see EventQueue::schedule_remote_event)
+ * should be at least lookahead after the current time, so it always falls in a later window.
+ * Within a window, every partition therefore invokes its events independently,
+ * staging the events of later windows in per-destination outboxes, which are
+ * exchanged at the end of the window without any lock.
+ *
+ * Same-time events are ordered as if every event had been scheduled on a single EventQueue,
+ * so a parallel simulation produces exactly the same results as the sequential one.
+ */
+class ParallelEventQueue {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param partitions_count number of partitions, each of which runs on its own thread
+     * @param lookahead minimum delay of the events scheduled on another partition, at least 1
+     * @param engine_type priority queue engine of each partition
+     */
+    ParallelEventQueue(int partitions_count,
+                       EventTime lookahead,
+                       EventQueueEngineType engine_type = EventQueueEngineType::QuaternaryHeap) noexcept;
+
+    /**
+     * Destructor.
+     */
+    ~ParallelEventQueue() noexcept;
+
+    /**
+     * Get the number of partitions.
+     *
+     * @return number of partitions
+     */
+    [[nodiscard]] int get_partitions_count() const noexcept;
+
+    /**
+     * Get the event queue of a partition.
+     *
+     * @param partition index of the partition
+     * @return event queue of the partition
+     */
+    [[nodiscard]] std::shared_ptr<EventQueue> get_partition(int partition) const noexcept;
+
+    /**
+     * Invoke every scheduled event, including the ones scheduled by the invoked events,
+     * with each partition running on its own thread.
+     * Events should be scheduled on the partitions before, and can only be run once.
+     */
+    void run() noexcept;
+
+    /**
+     * Get the time of the last invoked event.
+     *
+     * @return current event time
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Get the number of events scheduled so far on every partition.
+     *
+     * @return number of scheduled events
+     */
+    [[nodiscard]] uint64_t get_scheduled_events_count() const noexcept;
+
+    /**
+     * Get the number of windows processed by run.
+     *
+     * @return number of windows
+     */
+    [[nodiscard]] uint64_t get_windows_count() const noexcept;
+
+    /// a sequence number with this bit set is derived from the event that scheduled it
+    static constexpr uint64_t child_sequence_flag = static_cast<uint64_t>(1) << 63;
+
+    /// number of low bits of a derived sequence number holding the index among the sibling events
+    static constexpr int child_index_bits = 24;
+
+  private:
+    /**
+     * SpinBarrier blocks the partitions until all of them have reached it.
+     */
+    class SpinBarrier {
+      public:
+        /**
+         * Constructor.
+         *
+         * @param threads_count number of threads to synchronize
+         */
+        explicit SpinBarrier(int threads_count) noexcept;
+
+        /**
+         * Block until every thread has called wait.
+         */
+        void wait() noexcept;
+
+      private:
+        /// number of threads to synchronize
+        int threads_count;
+
+        /// number of threads waiting at the barrier
+        std::atomic<int> waiting_count;
+
+        /// number of times the barrier has been passed
+        std::atomic<uint64_t> generation;
+    };
+
+    /// number of partitions
+    int partitions_count;
+
+    /// minimum delay of the events scheduled on another partition
+    EventTime lookahead;
+
+    /// event queue of each partition
+    std::vector<std::shared_ptr<EventQueue>> partitions;
+
+    /// next sequence number of root events
+    uint64_t root_sequence;
+
+    /// earliest pending event time of each partition, published at each synchronization
+    std::vector<EventTime> next_event_times;
+
+    /// number of events logged by every partition in the last window, as counted by each partition
+    std::vector<uint64_t> logged_events_counts;
+
+    /// synchronizes the partitions
+    SpinBarrier barrier;
+
+    /// number of windows processed by run
+    uint64_t windows_count;
+
+    /// true once run has been invoked
+    bool ran;
+
+    /**
+     * Main loop of a partition.
+     *
+     * @param partition index of the partition
+     */
+    void run_partition(int partition) noexcept;
+
+    /**
+     * Move the events staged for a partition into its event queue,
+     * replacing their provisional parent ranks with the actual ones.
+     *
+     * @param partition index of the destination partition
+     */
+    void deliver(int partition) noexcept;
+
+    /**
+     * Compute the actual ranks of the events logged in the window.
+     * The logged events of all partitions are merged in invocation order,
+     * each partition merging its own slice.
+     *
+     * @param partition index of the partition doing the work
+     */
+    void rank_logged_events(int partition) noexcept;
+
+    /**
+     * Check whether a logged event was invoked before another logged event.
+     *
+     * @param partition partition of the first event
+     * @param index log index of the first event
+     * @param other_partition partition of the other event
+     * @param other_index log index of the other event
+     * @return true if the first event precedes the other event, false otherwise
+     */
+    [[nodiscard]] bool logged_event_precedes(int partition,
+                                             size_t index,
+                                             int other_partition,
+                                             size_t other_index) const noexcept;
+};
+
+}  // namespace NetworkAnalytical
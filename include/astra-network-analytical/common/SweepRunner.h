@@ -0,0 +1,91 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/SweepSpec.h"
+#include "common/ThreadPool.h"
+#include "common/Type.h"
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/// Evaluates a single sweep point on a backend, returning the communication time,
+/// or std::nullopt if the backend doesn't support the network
+using SweepEvaluator =
+    std::function<std::optional<EventTime>(const NetworkParser& network_parser, ChunkSize chunk_size)>;
+
+/**
+ * SweepResult holds the evaluation result of a sweep point on a backend.
+ */
+struct SweepResult {
+    /// index of the sweep point
+    size_t point;
+
+    /// name of the backend
+    std::string backend;
+
+    /// network configuration of the sweep point
+    SweepSpec::NetworkConfig network_config;
+
+    /// communication time, or std::nullopt if the backend doesn't support the network
+    std::optional<EventTime> comm_time;
+};
+
+/**
+ * SweepRunner evaluates every (sweep point, backend) pair of a SweepSpec on a ThreadPool.
+ */
+class SweepRunner {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param sweep_spec sweep to run
+     * @param threads_count number of worker threads, or 0 to use the number of hardware threads
+     */
+    explicit SweepRunner(SweepSpec sweep_spec, int threads_count = 0) noexcept;
+
+    /**
+     * Register the evaluator of a backend.
+     *
+     * @param backend name of the backend, as used in the sweep spec
+     * @param evaluator evaluator of the backend, which should be safe to call concurrently
+     */
+    void register_backend(const std::string& backend, SweepEvaluator evaluator) noexcept;
+
+    /**
+     * Evaluate every sweep point on every backend of the sweep spec.
+     *
+     * @return results, ordered by (sweep point, backend)
+     */
+    [[nodiscard]] std::vector<SweepResult> run() noexcept;
+
+    /**
+     * Write the results as a CSV table.
+     *
+     * @param results results to write
+     * @param chunk_size chunk size the results are evaluated with
+     * @param output stream to write to
+     */
+    static void write_csv(const std::vector<SweepResult>& results, ChunkSize chunk_size, std::ostream& output) noexcept;
+
+  private:
+    /// sweep to run
+    SweepSpec sweep_spec;
+
+    /// workers evaluating the sweep points
+    ThreadPool thread_pool;
+
+    /// registered evaluator per backend
+    std::map<std::string, SweepEvaluator> evaluators;
+};
+
+}  // namespace NetworkAnalytical
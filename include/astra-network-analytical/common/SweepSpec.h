@@ -0,0 +1,147 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace NetworkAnalytical {
+
+/**
+ * SweepSpec describes a design-space sweep over network configurations.
+ *
+ * A sweep spec file looks like:
+ *
+ *   network: Ring.yml             # base network configuration, relative to the spec file
+ *   backends: [ congestion_unaware, congestion_aware ]
+ *   chunk_size: 1048576           # bytes each NPU sends to every other NPU
+ *   sweep:
+ *     npus_count: [ [8], [16] ]   # candidate values of the whole key
+ *     bandwidth[0]: [ 50, 100 ]   # candidate values of a single dimension of the key
+ *
+ * The sweep points are the Cartesian product of all candidate values, applied on top of the base network.
+ * Points are decoded on demand from their index, so the product is never materialized.
+ */
+class SweepSpec {
+  public:
+    /// network configuration in plain form: key -> value of each dimension
+    using NetworkConfig = std::map<std::string, std::vector<std::string>>;
+
+    /**
+     * Constructor.
+     *
+     * @param path path of the sweep spec yml file
+     */
+    explicit SweepSpec(const std::string& path) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param sweep_config already loaded sweep spec YAML node
+     * @param base_directory directory the base network path is relative to
+     */
+    SweepSpec(const YAML::Node& sweep_config, const std::string& base_directory) noexcept;
+
+    /**
+     * Get the number of sweep points.
+     *
+     * @return number of sweep points
+     */
+    [[nodiscard]] size_t get_points_count() const noexcept;
+
+    /**
+     * Get the network configuration of a sweep point.
+     *
+     * @param point index of the sweep point
+     * @return network configuration of the sweep point
+     */
+    [[nodiscard]] NetworkConfig get_point_config(size_t point) const noexcept;
+
+    /**
+     * Build a fresh YAML node from a network configuration,
+     * which can be given to NetworkParser.
+     * The node shares no state with the spec, so it can be built and parsed in any thread.
+     *
+     * @param network_config network configuration
+     * @return YAML node of the network configuration
+     */
+    [[nodiscard]] static YAML::Node to_yaml(const NetworkConfig& network_config) noexcept;
+
+    /**
+     * Get the backends to evaluate each sweep point on.
+     *
+     * @return names of the backends
+     */
+    [[nodiscard]] std::vector<std::string> get_backends() const noexcept;
+
+    /**
+     * Get the chunk size each NPU sends to every other NPU.
+     *
+     * @return chunk size
+     */
+    [[nodiscard]] ChunkSize get_chunk_size() const noexcept;
+
+  private:
+    /**
+     * SweepAxis is a single swept key (or a single dimension of a key) with its candidate values.
+     */
+    struct SweepAxis {
+        /// swept key, e.g., "npus_count"
+        std::string key;
+
+        /// swept dimension of the key, or -1 if the whole key is swept
+        int dim;
+
+        /// candidate values, each being the value of every (or the single swept) dimension
+        std::vector<std::vector<std::string>> values;
+    };
+
+    /// base network configuration
+    NetworkConfig base_config;
+
+    /// swept axes
+    std::vector<SweepAxis> axes;
+
+    /// backends to evaluate each point on
+    std::vector<std::string> backends;
+
+    /// chunk size each NPU sends to every other NPU
+    ChunkSize chunk_size;
+
+    /**
+     * Parse the given YAML node and retrieve the sweep spec.
+     *
+     * @param sweep_config opened and parsed YAML node
+     * @param base_directory directory the base network path is relative to
+     * @throws YAML::Exception if the spec or the base network is malformed
+     */
+    void parse_sweep_config_yml(const YAML::Node& sweep_config, const std::string& base_directory);
+
+    /**
+     * Parse a swept key of the form "key" or "key[dim]".
+     *
+     * @param swept_key swept key string
+     * @param values candidate values of the key
+     * @return parsed sweep axis
+     * @throws YAML::Exception if the values are malformed
+     */
+    [[nodiscard]] static SweepAxis parse_axis(const std::string& swept_key, const YAML::Node& values);
+
+    /**
+     * Read a YAML scalar or sequence of scalars as strings.
+     *
+     * @param node YAML node to read
+     * @return scalar values
+     * @throws YAML::Exception if the node holds a non-scalar element
+     */
+    [[nodiscard]] static std::vector<std::string> parse_scalars(const YAML::Node& node);
+};
+
+}  // namespace NetworkAnalytical
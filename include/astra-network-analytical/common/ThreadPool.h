@@ -0,0 +1,119 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * ThreadPool runs batches of independent tasks on a fixed set of worker threads.
+ *
+ * Each worker owns a task deque seeded with a contiguous block of the batch.
+ * A worker takes tasks from the back of its own deque,
+ * and once it runs dry, steals from the front of the other workers' deques,
+ * so that uneven task costs are balanced across workers.
+ */
+class ThreadPool {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param threads_count number of worker threads,
+     *     or 0 to use the number of hardware threads
+     */
+    explicit ThreadPool(int threads_count = 0) noexcept;
+
+    /**
+     * Destructor, joining every worker thread.
+     */
+    ~ThreadPool() noexcept;
+
+    /**
+     * Get the number of worker threads.
+     *
+     * @return number of worker threads
+     */
+    [[nodiscard]] int get_threads_count() const noexcept;
+
+    /**
+     * Run task(0), task(1), ..., task(tasks_count - 1) on the worker threads,
+     * and block until all of them finish.
+     *
+     * @param tasks_count number of tasks to run
+     * @param task function to run, given the index of the task
+     */
+    void parallel_for(size_t tasks_count, const std::function<void(size_t)>& task) noexcept;
+
+  private:
+    /**
+     * WorkQueue is the task deque owned by a single worker.
+     */
+    struct WorkQueue {
+        /// protects tasks
+        std::mutex mutex;
+
+        /// indices of the tasks to run
+        std::deque<size_t> tasks;
+    };
+
+    /// worker threads
+    std::vector<std::thread> workers;
+
+    /// task deque per each worker
+    std::vector<std::unique_ptr<WorkQueue>> work_queues;
+
+    /// task function of the current batch
+    const std::function<void(size_t)>* current_task;
+
+    /// number of tasks of the current batch not finished yet
+    std::atomic<size_t> remaining_tasks_count;
+
+    /// number of workers currently draining task deques
+    size_t active_workers_count;
+
+    /// incremented whenever a new batch is submitted
+    uint64_t batch_id;
+
+    /// true if the pool is being destroyed
+    bool stopping;
+
+    /// protects current_task, active_workers_count, batch_id, and stopping
+    std::mutex mutex;
+
+    /// notifies workers of a new batch or of the pool being destroyed
+    std::condition_variable batch_submitted;
+
+    /// notifies the submitter that a task batch is finished or a worker went idle
+    std::condition_variable batch_finished;
+
+    /**
+     * Main loop of a worker thread.
+     *
+     * @param worker_id id of the worker
+     */
+    void run_worker(size_t worker_id) noexcept;
+
+    /**
+     * Take a task, first from the worker's own deque and then from the other workers' deques.
+     *
+     * @param worker_id id of the worker
+     * @param task taken task index, if any
+     * @return true if a task was taken, false if every deque is empty
+     */
+    bool take_task(size_t worker_id, size_t& task) noexcept;
+};
+
+}  // namespace NetworkAnalytical
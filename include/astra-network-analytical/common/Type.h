@@ -33,4 +33,13 @@ using EventTime = uint64_t;
 /// Basic multi-dimensional topology building blocks
 enum class TopologyBuildingBlock { Undefined, Ring, FullyConnected, Switch };
 
+/// Collective communication patterns
+enum class CollectiveType { AllReduce, AllGather, ReduceScatter, AllToAll };
+
+/// Algorithms running a collective among the NPUs of a network dimension
+enum class CollectiveAlgorithm { Ring, Direct, HalvingDoubling, BinaryTree };
+
+/// Priority queue engines an EventQueue can be backed by
+enum class EventQueueEngineType { BinaryHeap, QuaternaryHeap, CalendarQueue, LadderQueue };
+
 }  // namespace NetworkAnalytical
@@ -7,6 +7,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/Type.h"
+#include <cstddef>
 #include <memory>
 
 using namespace NetworkAnalytical;
@@ -16,6 +17,14 @@ namespace NetworkAnalyticalCongestionAware {
 /**
  * Chunk class represents a chunk.
  * Chunk is a basic unit of transmission.
+ *
+ * A chunk may batch items_count items of chunk_size bytes each, which share the route and the injection time.
+ * A batch is transmitted back-to-back as a single transmission per hop,
+ * and its callback is invoked once per item, when each item arrives at the destination.
+ *
+ * Chunks created by Topology::create_chunk (i.e., "new (chunk_pool) Chunk(...)") are recycled by the topology's
+ * ChunkPool, while std::make_unique<Chunk>(...) still works as before.
+ * Both can be destroyed by std::unique_ptr<Chunk>.
  */
 class Chunk {
   public:
@@ -28,6 +37,38 @@ class Chunk {
      */
     static void chunk_arrived_next_device(void* chunk_ptr) noexcept;
 
+    /**
+     * Allocate a chunk from the heap.
+     *
+     * @param size size of the chunk object
+     * @return storage of the chunk
+     */
+    static void* operator new(size_t size);
+
+    /**
+     * Allocate a chunk from a chunk pool.
+     *
+     * @param size size of the chunk object
+     * @param chunk_pool pool to take the chunk storage from
+     * @return storage of the chunk
+     */
+    static void* operator new(size_t size, ChunkPool& chunk_pool);
+
+    /**
+     * Return the storage of a chunk to wherever it was allocated from.
+     *
+     * @param chunk_storage storage of the chunk
+     */
+    static void operator delete(void* chunk_storage) noexcept;
+
+    /**
+     * Return the storage of a chunk to its pool, if the construction of a pooled chunk fails.
+     *
+     * @param chunk_storage storage of the chunk
+     * @param chunk_pool pool the chunk storage was taken from
+     */
+    static void operator delete(void* chunk_storage, ChunkPool& chunk_pool) noexcept;
+
     /**
      * Constructor.
      *
@@ -36,43 +77,136 @@ class Chunk {
      * @param callback: callback to be invoked when the chunk arrives destination
      * @param callback_arg: argument of the callback
      */
-    Chunk(ChunkSize chunk_size, Route route, Callback callback, CallbackArg callback_arg) noexcept;
+    Chunk(ChunkSize chunk_size, const Route& route, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Constructor.
+     * The route is shared with other chunks, e.g., one obtained from Topology::shared_route,
+     * so constructing the chunk does not allocate any route.
+     *
+     * @param chunk_size: size of the chunk
+     * @param route: shared route of the chunk from its source to destination
+     * @param callback: callback to be invoked when the chunk arrives destination
+     * @param callback_arg: argument of the callback
+     */
+    Chunk(ChunkSize chunk_size, SharedRoute route, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Constructor of a batch of identical items.
+     *
+     * @param chunk_size: size of each item
+     * @param items_count: number of items in the batch
+     * @param route: shared route of the items from their source to destination
+     * @param callback: callback to be invoked when each item arrives destination
+     * @param callback_arg: argument of the callback
+     */
+    Chunk(ChunkSize chunk_size,
+          int items_count,
+          SharedRoute route,
+          Callback callback,
+          CallbackArg callback_arg) noexcept;
 
     /**
      * Get the current sitting device of the chunk
      *
      * @return current device of the chunk
      */
-    [[nodiscard]] std::shared_ptr<Device> current_device() const noexcept;
+    [[nodiscard]] const std::shared_ptr<Device>& current_device() const noexcept;
 
     /**
      * Get the next destined device of the chunk
      *
      * @return next device of the chunk
      */
-    [[nodiscard]] std::shared_ptr<Device> next_device() const noexcept;
+    [[nodiscard]] const std::shared_ptr<Device>& next_device() const noexcept;
+
+    /**
+     * Get the link to the next destined device of the chunk
+     *
+     * @return link to the next device of the chunk
+     */
+    [[nodiscard]] Link* next_link() const noexcept;
 
     /**
      * Mark the chunk arrived at its next device
-     * i.e., drop the current device from the route
+     * i.e., advance the route cursor past the current device
      */
     void mark_arrived_next_device() noexcept;
 
     /**
      * Check if the chunk arrived at its destination
-     * i.e., if the route length is 1 (only destination device left)
+     * i.e., if the route cursor points to the destination device
      *
      * @return true if the chunk arrived at its destination, false otherwise
      */
     [[nodiscard]] bool arrived_dest() const noexcept;
 
     /**
-     * Get the size of the chunk
+     * Check if the next device of the chunk is its destination
+     * i.e., if the chunk is about to take the last link of its route
+     *
+     * @return true if the next device is the destination, false otherwise
+     */
+    [[nodiscard]] bool next_device_is_dest() const noexcept;
+
+    /**
+     * Get the time the last byte of the chunk arrives at its current device.
+     * A packetized chunk can be forwarded as soon as its first packet arrives, before its last one does.
+     *
+     * @return time the chunk fully arrives at its current device
+     */
+    [[nodiscard]] EventTime get_tail_arrival_time() const noexcept;
+
+    /**
+     * Set the time the last byte of the chunk arrives at its next device.
+     *
+     * @param tail_arrival_time time the chunk fully arrives at its next device
+     */
+    void set_tail_arrival_time(EventTime tail_arrival_time) noexcept;
+
+    /**
+     * Get the time between the arrivals of consecutive items of the chunk at its current device,
+     * i.e., the longest item serialization delay over the links the chunk has gone through.
+     *
+     * @return item spacing of the chunk
+     */
+    [[nodiscard]] EventTime get_item_spacing() const noexcept;
+
+    /**
+     * Set the time between the arrivals of consecutive items of the chunk at its next device.
+     *
+     * @param item_spacing item spacing of the chunk at its next device
+     */
+    void set_item_spacing(EventTime item_spacing) noexcept;
+
+    /**
+     * Get the size of the chunk, i.e., of each of its items
      *
      * @return size of the chunk
      */
     [[nodiscard]] ChunkSize get_size() const noexcept;
 
+    /**
+     * Get the number of items batched in the chunk
+     *
+     * @return number of items
+     */
+    [[nodiscard]] int get_items_count() const noexcept;
+
+    /**
+     * Get the callback to be invoked when each item arrives destination
+     *
+     * @return callback of the chunk
+     */
+    [[nodiscard]] Callback get_callback() const noexcept;
+
+    /**
+     * Get the argument of the callback
+     *
+     * @return argument of the callback
+     */
+    [[nodiscard]] CallbackArg get_callback_arg() const noexcept;
+
     /**
      * Invoke the registered callback
      * i.e., this method should be called when the chunk arrives its destination.
@@ -80,20 +214,39 @@ class Chunk {
     void invoke_callback() noexcept;
 
   private:
-    /// size of the chunk
+    /// ChunkQueue chains chunks through next_queued
+    friend class ChunkQueue;
+
+    /// size of the chunk, i.e., of each of its items
     ChunkSize chunk_size;
 
-    /// route of the chunk to its destination.
-    /// Route has the structure of [current device, next device, ..., dest device]
+    /// number of items batched in the chunk
+    int items_count;
+
+    /// route of the chunk from its source to its destination.
+    /// Route has the structure of [src device, ..., dest device]
     /// e.g., if a chunk starts from device 5, then reaches destination 3,
     /// the route would be e.g., [5, 1, 6, 2, 3]
-    Route route;
+    /// The route is immutable, as it may be shared with other chunks.
+    SharedRoute route;
+
+    /// index of the current device of the chunk in the route
+    size_t route_cursor;
+
+    /// time the last byte of the chunk arrives at its current device, if it's forwarded as a packet train
+    EventTime tail_arrival_time;
+
+    /// time between the arrivals of consecutive items at its current device, if it's forwarded as a packet train
+    EventTime item_spacing;
 
     /// callback to be invoked when the chunk arrives at its destination
     Callback callback;
 
     /// argument of the callback
     CallbackArg callback_arg;
+
+    /// intrusive link to the next chunk of the ChunkQueue holding this chunk
+    Chunk* next_queued;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,118 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Type.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ChunkPool recycles the storage of Chunks.
+ *
+ * Storage is allocated in fixed-size slabs and handed out through an intrusive free list,
+ * so once the pool has grown to the peak number of live chunks,
+ * creating and destroying chunks does not touch the heap allocator at all.
+ *
+ * Every chunk storage, pooled or not, is prefixed with the pool it belongs to,
+ * so that deleting a chunk (e.g., by its std::unique_ptr) returns the storage to the right place.
+ * A pool should outlive the chunks it holds.
+ */
+class ChunkPool {
+  public:
+    /**
+     * Constructor.
+     */
+    ChunkPool() noexcept;
+
+    /**
+     * Take a free chunk storage, growing the pool by a slab if none is left.
+     *
+     * @return pointer to the storage of a chunk
+     */
+    [[nodiscard]] void* acquire() noexcept;
+
+    /**
+     * Allocate a chunk storage from the heap, which belongs to no pool.
+     *
+     * @return pointer to the storage of a chunk
+     */
+    [[nodiscard]] static void* allocate_unpooled() noexcept;
+
+    /**
+     * Return a chunk storage to the pool it belongs to, or to the heap if it belongs to no pool.
+     *
+     * @param chunk_storage storage of a destroyed chunk
+     */
+    static void release(void* chunk_storage) noexcept;
+
+    /**
+     * Allow chunks to be destroyed on other threads, e.g., by the partitions of a parallel simulation.
+     * Storages released concurrently are taken back by acquire,
+     * which should still be invoked by a single thread at a time.
+     *
+     * @param concurrent_release true to allow concurrent release, false otherwise
+     */
+    void set_concurrent_release(bool concurrent_release) noexcept;
+
+    /**
+     * Get the number of chunk storages allocated from the heap so far.
+     * This stays constant during steady-state simulation.
+     *
+     * @return number of allocated chunk storages
+     */
+    [[nodiscard]] uint64_t get_chunks_allocated_count() const noexcept;
+
+  private:
+    /**
+     * Slot holds the storage of a single chunk, prefixed with its owner.
+     */
+    struct Slot {
+        /// pool the slot belongs to, or nullptr if allocated from the heap
+        ChunkPool* pool;
+
+        /// intrusive link of the free slot list
+        Slot* next;
+
+        /// storage of the chunk
+        alignas(Chunk) unsigned char storage[sizeof(Chunk)];
+    };
+
+    /// number of slots per slab
+    static constexpr size_t slab_size = 1024;
+
+    /// allocated slabs, which own the slots
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+
+    /// head of the free slot list
+    Slot* free_list;
+
+    /// true if chunks may be released on other threads
+    bool concurrent_release;
+
+    /// head of the list of slots released concurrently, to be taken over by acquire
+    std::atomic<Slot*> released_list;
+
+    /**
+     * Get the slot holding the given chunk storage.
+     *
+     * @param chunk_storage storage of a chunk
+     * @return slot holding the storage
+     */
+    [[nodiscard]] static Slot* slot_of(void* chunk_storage) noexcept;
+
+    /**
+     * Allocate a new slab and thread its slots onto the free list.
+     */
+    void allocate_slab() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
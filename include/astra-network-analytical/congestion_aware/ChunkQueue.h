@@ -0,0 +1,72 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Type.h"
+#include <memory>
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ChunkQueue is a FIFO queue of chunks, chained through the chunks' intrusive links.
+ * The queue owns the chunks it holds, and pushing or popping a chunk never allocates.
+ */
+class ChunkQueue {
+  public:
+    /**
+     * Constructor.
+     */
+    ChunkQueue() noexcept;
+
+    /**
+     * Move constructor.
+     * The other queue becomes empty.
+     *
+     * @param other queue to take the chunks from
+     */
+    ChunkQueue(ChunkQueue&& other) noexcept;
+
+    /**
+     * Destructor, which destroys the chunks left in the queue.
+     */
+    ~ChunkQueue() noexcept;
+
+    ChunkQueue(const ChunkQueue&) = delete;
+    ChunkQueue& operator=(const ChunkQueue&) = delete;
+    ChunkQueue& operator=(ChunkQueue&&) = delete;
+
+    /**
+     * Append a chunk to the back of the queue.
+     *
+     * @param chunk chunk to append
+     */
+    void push(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Remove and return the chunk at the front of the queue.
+     * The queue should not be empty.
+     *
+     * @return front chunk
+     */
+    [[nodiscard]] std::unique_ptr<Chunk> pop() noexcept;
+
+    /**
+     * Check whether the queue holds no chunk.
+     *
+     * @return true if the queue is empty, false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+  private:
+    /// front chunk of the queue
+    Chunk* head;
+
+    /// back chunk of the queue
+    Chunk* tail;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
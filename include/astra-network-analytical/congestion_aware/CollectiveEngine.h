@@ -0,0 +1,221 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/MessagePool.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * CollectiveEngine runs collectives over every NPU of a topology, by sending chunks through Topology::send.
+ *
+ * The buffer of each NPU is split into chunks_count chunks, each of which runs the collective on its own.
+ * At most pipeline_depth chunks are in flight at once:
+ * chunk c starts once chunk c - pipeline_depth has finished on every NPU.
+ *
+ * Each chunk runs as a sequence of stages on every NPU.
+ * At each stage, an NPU waits for the messages of the stage to arrive, then sends its messages of the stage,
+ * so that a message is sent as soon as the messages it depends on have arrived.
+ * For p NPUs and a chunk of m bytes:
+ *   - Ring: p - 1 steps of m / p to the next NPU for Reduce-Scatter and All-Gather,
+ *     and p - 1 steps of m * (p - i) / p (i = 1, ..., p - 1) for All-to-All.
+ *   - Direct: a single step, where every NPU sends m / p to every other NPU.
+ *   - HalvingDoubling: log2(p) steps, exchanging m / 2, m / 4, ..., m / p with NPUs p / 2, p / 4, ..., 1 apart
+ *     for Reduce-Scatter and All-Gather, and m / 2 with NPUs 1, 2, ..., p / 2 apart for All-to-All.
+ *     p should be a power of 2.
+ *   - BinaryTree: the NPUs form a binary heap rooted at NPU 0. The data flows up to the root, then back down:
+ *     All-Reduce reduces and broadcasts m, All-Gather gathers and broadcasts, Reduce-Scatter reduces and scatters.
+ *     All-to-All isn't supported.
+ * An All-Reduce is a Reduce-Scatter followed by an All-Gather, except for BinaryTree.
+ * Message sizes are rounded up to whole bytes.
+ *
+ * Bookkeeping only holds the pipeline_depth chunks in flight, in preallocated per-stage arrival counters,
+ * and messages are recycled, so running a collective does not allocate once the pools have grown.
+ */
+class CollectiveEngine {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to run collectives on, whose event queue has been set
+     */
+    explicit CollectiveEngine(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Run a collective, and process the events of the topology's event queue until it finishes.
+     *
+     * @param collective_type type of the collective
+     * @param algorithm algorithm of the collective
+     * @param collective_size buffer size of each NPU
+     * @param chunks_count number of chunks to split the buffer into
+     * @param pipeline_depth maximum number of chunks in flight at once
+     * @return time for the collective to finish
+     */
+    [[nodiscard]] EventTime run(CollectiveType collective_type,
+                                CollectiveAlgorithm algorithm,
+                                ChunkSize collective_size,
+                                int chunks_count = 1,
+                                int pipeline_depth = 1) noexcept;
+
+    /**
+     * Get the number of messages sent by the last collective.
+     *
+     * @return number of sent messages
+     */
+    [[nodiscard]] uint64_t get_sent_messages_count() const noexcept;
+
+  private:
+    /**
+     * Message is a chunk of a collective in flight, passed to its arrival callback.
+     */
+    struct Message {
+        /// engine running the collective
+        CollectiveEngine* engine;
+
+        /// pipeline slot of the chunk the message belongs to
+        int slot;
+
+        /// dest NPU of the message
+        DeviceId dest;
+
+        /// stage of the dest NPU the message arrives for
+        int stage;
+
+        /// next free message, while the message is in the free list
+        Message* next_free;
+    };
+
+    /// topology to run collectives on
+    std::shared_ptr<Topology> topology;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// type of the running collective
+    CollectiveType collective_type;
+
+    /// algorithm of the running collective
+    CollectiveAlgorithm algorithm;
+
+    /// size of each chunk
+    ChunkSize chunk_size;
+
+    /// size of each chunk divided by the number of NPUs, rounded up
+    ChunkSize shard_size;
+
+    /// number of chunks
+    int chunks_count;
+
+    /// number of pipeline slots, i.e., chunks in flight at once
+    int slots_count;
+
+    /// number of chunks started so far
+    int started_chunks_count;
+
+    /// number of chunks finished on every NPU so far
+    int finished_chunks_count;
+
+    /// number of stages each NPU goes through for a chunk
+    int stages_count;
+
+    /// number of arrival counters of each NPU for a chunk:
+    /// messages of a ring arrive in order, so a single counter serves every stage
+    int counters_count;
+
+    /// log2 of the number of NPUs, for HalvingDoubling
+    int log2_npus_count;
+
+    /// current stage of each NPU, for each slot
+    /// stage_per_npu[slot * npus_count + npu]
+    std::vector<int> stage_per_npu;
+
+    /// messages arrived for each stage (modulo counters_count) of each NPU, for each slot
+    /// arrivals_count[(slot * npus_count + npu) * counters_count + stage % counters_count]
+    std::vector<uint32_t> arrivals_count;
+
+    /// number of NPUs which have finished the chunk of each slot
+    std::vector<int> finished_npus_count;
+
+    /// time the last collective started at
+    EventTime start_time;
+
+    /// time the last collective finished at
+    EventTime finish_time;
+
+    /// number of messages sent by the last collective
+    uint64_t sent_messages_count;
+
+    /// recycles the messages in flight
+    MessagePool<Message> message_pool;
+
+    /**
+     * Callback invoked when a message arrives at its dest NPU.
+     *
+     * @param message_ptr pointer to the arrived message
+     */
+    static void message_arrived(void* message_ptr) noexcept;
+
+    /**
+     * Start the next chunk on a pipeline slot.
+     *
+     * @param slot pipeline slot to start the chunk on
+     */
+    void start_chunk(int slot) noexcept;
+
+    /**
+     * Go through every stage of an NPU whose messages have all arrived.
+     *
+     * @param slot pipeline slot of the chunk
+     * @param npu NPU to advance
+     */
+    void advance(int slot, DeviceId npu) noexcept;
+
+    /**
+     * Get the number of messages an NPU waits for at a stage.
+     *
+     * @param npu NPU waiting for the messages
+     * @param stage stage of the NPU
+     * @return number of messages to wait for
+     */
+    [[nodiscard]] uint32_t get_expected_arrivals_count(DeviceId npu, int stage) const noexcept;
+
+    /**
+     * Send the messages of an NPU at a stage.
+     *
+     * @param slot pipeline slot of the chunk
+     * @param npu NPU sending the messages
+     * @param stage stage of the NPU
+     */
+    void send_stage(int slot, DeviceId npu, int stage) noexcept;
+
+    /**
+     * Send a message.
+     *
+     * @param slot pipeline slot of the chunk
+     * @param src src NPU
+     * @param dest dest NPU
+     * @param stage stage of the dest NPU the message arrives for
+     * @param message_size size of the message
+     */
+    void send_message(int slot, DeviceId src, DeviceId dest, int stage, ChunkSize message_size) noexcept;
+
+    /**
+     * Get the number of NPUs in the subtree of an NPU, for BinaryTree.
+     *
+     * @param npu root of the subtree
+     * @return number of NPUs in the subtree
+     */
+    [[nodiscard]] int get_subtree_npus_count(DeviceId npu) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,174 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ScheduledSend is a send of a collective schedule.
+ *
+ * A collective schedule is a list of sends, sorted by step.
+ * Sends are identified by their index in the list, starting from 0.
+ * A send is issued once every send it depends on has arrived at its dest,
+ * and may only depend on sends of earlier steps.
+ */
+struct ScheduledSend {
+    /// step of the send
+    uint32_t step;
+
+    /// src NPU
+    DeviceId src;
+
+    /// dest NPU
+    DeviceId dest;
+
+    /// number of bytes to send
+    ChunkSize size;
+
+    /// ids of the sends this send depends on
+    std::vector<uint64_t> dependencies;
+};
+
+/**
+ * CollectiveScheduleHeader starts a binary collective schedule file.
+ *
+ * After the header, each send is a record of step, src, dest and dependencies count (uint32_t each),
+ * followed by size (uint64_t) and the dependencies (uint64_t each).
+ * Every field is in native byte order.
+ *
+ * A text collective schedule file has a send per line: "step src dest size [dependency ...]".
+ * Anything after '#' is a comment, and blank lines are ignored.
+ */
+struct CollectiveScheduleHeader {
+    /// identifies the file format, collective_schedule_magic
+    char magic[8];
+
+    /// version of the file format, collective_schedule_version
+    uint32_t version;
+
+    /// reserved, 0
+    uint32_t reserved;
+};
+
+static_assert(sizeof(CollectiveScheduleHeader) == 16, "CollectiveScheduleHeader should take 16 bytes");
+
+/// magic of a binary collective schedule file
+constexpr char collective_schedule_magic[8] = {'N', 'A', 'S', 'C', 'H', 'E', 'D', '\0'};
+
+/// version of the binary collective schedule file format
+constexpr uint32_t collective_schedule_version = 1;
+
+/**
+ * CollectiveScheduleReader reads a collective schedule file send by send,
+ * so that the schedule never has to be held in memory at once.
+ * The format (text or binary) is detected from the start of the file.
+ */
+class CollectiveScheduleReader {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param schedule_path path of the schedule file
+     */
+    explicit CollectiveScheduleReader(const std::string& schedule_path) noexcept;
+
+    /**
+     * Read the next send.
+     *
+     * @param send output: next send, whose dependencies vector is reused
+     * @return true if a send has been read, false at the end of the file
+     */
+    [[nodiscard]] bool read(ScheduledSend& send) noexcept;
+
+    /**
+     * Get the format of the schedule file.
+     *
+     * @return format of the schedule file
+     */
+    [[nodiscard]] ScheduleFormat get_format() const noexcept;
+
+  private:
+    /// path of the schedule file
+    std::string schedule_path;
+
+    /// schedule file
+    std::ifstream input;
+
+    /// format of the schedule file
+    ScheduleFormat format;
+
+    /// size of the schedule file in bytes, to bound the records of binary files
+    uint64_t file_size;
+
+    /// number of the last line read, for text files
+    uint64_t line_number;
+
+    /// last line read, for text files
+    std::string line;
+
+    /**
+     * Read the next send of a text file.
+     *
+     * @param send output: next send
+     * @return true if a send has been read, false at the end of the file
+     */
+    [[nodiscard]] bool read_text(ScheduledSend& send) noexcept;
+
+    /**
+     * Read the next send of a binary file.
+     *
+     * @param send output: next send
+     * @return true if a send has been read, false at the end of the file
+     */
+    [[nodiscard]] bool read_binary(ScheduledSend& send) noexcept;
+};
+
+/**
+ * CollectiveScheduleWriter writes a collective schedule file send by send.
+ */
+class CollectiveScheduleWriter {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param schedule_path path of the schedule file to write
+     * @param format format of the schedule file
+     */
+    CollectiveScheduleWriter(const std::string& schedule_path, ScheduleFormat format) noexcept;
+
+    /**
+     * Append a send to the schedule.
+     *
+     * @param send send to append
+     */
+    void write(const ScheduledSend& send) noexcept;
+
+    /**
+     * Flush and close the schedule file.
+     */
+    void close() noexcept;
+
+  private:
+    /// path of the schedule file
+    std::string schedule_path;
+
+    /// schedule file
+    std::ofstream output;
+
+    /// format of the schedule file
+    ScheduleFormat format;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
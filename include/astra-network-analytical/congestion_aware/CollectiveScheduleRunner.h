@@ -0,0 +1,215 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/CollectiveSchedule.h"
+#include "congestion_aware/MessagePool.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * CollectiveScheduleRunner streams a collective schedule file into chunks sent through Topology::send.
+ *
+ * Only a window of lookahead_steps steps is loaded at once, starting from the oldest unfinished step.
+ * Once every send of the oldest step has arrived, the step and its dependencies are released,
+ * and the next step is loaded from the file.
+ * Memory thus stays bounded by the largest lookahead_steps consecutive steps, however long the schedule is.
+ * A send loaded into the window is issued as soon as every send it depends on has arrived.
+ */
+class CollectiveScheduleRunner {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to send chunks on, whose event queue has been set
+     * @param lookahead_steps number of steps loaded at once, at least 1
+     */
+    explicit CollectiveScheduleRunner(std::shared_ptr<Topology> topology, int lookahead_steps = 2) noexcept;
+
+    /**
+     * Run a collective schedule, and process the events of the topology's event queue until it finishes.
+     *
+     * @param schedule_path path of the schedule file
+     * @return time for the schedule to finish
+     */
+    [[nodiscard]] EventTime run(const std::string& schedule_path) noexcept;
+
+    /**
+     * Get the number of sends issued by the last schedule.
+     *
+     * @return number of issued sends
+     */
+    [[nodiscard]] uint64_t get_sent_count() const noexcept;
+
+    /**
+     * Get the peak number of sends loaded at once by the last schedule.
+     *
+     * @return peak number of loaded sends
+     */
+    [[nodiscard]] uint64_t get_peak_loaded_sends_count() const noexcept;
+
+  private:
+    /**
+     * SendState is a loaded send.
+     */
+    struct SendState {
+        /// src NPU
+        DeviceId src;
+
+        /// dest NPU
+        DeviceId dest;
+
+        /// number of bytes to send
+        ChunkSize size;
+
+        /// number of dependencies which haven't arrived yet
+        uint32_t pending_dependencies_count;
+
+        /// index of the first edge to the sends depending on this send, or -1
+        int64_t first_dependent;
+
+        /// true if the send has arrived at its dest
+        bool arrived;
+    };
+
+    /**
+     * DependentEdge links a send to a send depending on it.
+     */
+    struct DependentEdge {
+        /// id of the dependent send
+        uint64_t dependent_id;
+
+        /// index of the next edge of the same send, or -1
+        int64_t next;
+    };
+
+    /**
+     * LoadedStep holds the sends of a step.
+     */
+    struct LoadedStep {
+        /// step number
+        uint32_t step;
+
+        /// id of the first send of the step
+        uint64_t first_send_id;
+
+        /// number of sends which haven't arrived yet
+        uint64_t remaining_sends_count;
+
+        /// sends of the step, indexed by id - first_send_id
+        std::vector<SendState> sends;
+
+        /// edges to the sends depending on the sends of the step
+        std::vector<DependentEdge> dependents;
+    };
+
+    /**
+     * Message is a send in flight, passed to its arrival callback.
+     */
+    struct Message {
+        /// runner running the schedule
+        CollectiveScheduleRunner* runner;
+
+        /// id of the send
+        uint64_t send_id;
+
+        /// next free message, while the message is in the free list
+        Message* next_free;
+    };
+
+    /// topology to send chunks on
+    std::shared_ptr<Topology> topology;
+
+    /// number of steps loaded at once
+    int lookahead_steps;
+
+    /// reader of the running schedule
+    std::unique_ptr<CollectiveScheduleReader> reader;
+
+    /// send read ahead from the schedule, which belongs to the next step to load
+    ScheduledSend next_send;
+
+    /// true if next_send holds a send
+    bool has_next_send;
+
+    /// id of the next send to read
+    uint64_t next_send_id;
+
+    /// loaded steps, from the oldest unfinished one
+    std::deque<LoadedStep> loaded_steps;
+
+    /// released steps, whose storage is reused by the next steps to load
+    std::vector<LoadedStep> spare_steps;
+
+    /// number of sends loaded at the moment
+    uint64_t loaded_sends_count;
+
+    /// peak number of sends loaded at once
+    uint64_t peak_loaded_sends_count;
+
+    /// number of sends issued
+    uint64_t sent_count;
+
+    /// time the last schedule started at
+    EventTime start_time;
+
+    /// time the last schedule finished at
+    EventTime finish_time;
+
+    /// recycles the messages in flight
+    MessagePool<Message> message_pool;
+
+    /**
+     * Callback invoked when a send arrives at its dest NPU.
+     *
+     * @param message_ptr pointer to the arrived message
+     */
+    static void message_arrived(void* message_ptr) noexcept;
+
+    /**
+     * Load steps until the window is full or the schedule ends.
+     */
+    void load_steps() noexcept;
+
+    /**
+     * Load the next step from the schedule, and issue its sends with no pending dependencies.
+     */
+    void load_step() noexcept;
+
+    /**
+     * Find the loaded step a send belongs to.
+     *
+     * @param send_id id of a loaded send
+     * @return loaded step of the send
+     */
+    [[nodiscard]] LoadedStep& find_step(uint64_t send_id) noexcept;
+
+    /**
+     * Issue a send as a chunk.
+     *
+     * @param send_id id of the send
+     * @param send loaded send
+     */
+    void issue(uint64_t send_id, const SendState& send) noexcept;
+
+    /**
+     * Mark a send arrived, issue the sends it unblocks, and release the finished steps.
+     *
+     * @param send_id id of the arrived send
+     */
+    void complete(uint64_t send_id) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
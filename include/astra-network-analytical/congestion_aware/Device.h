@@ -7,7 +7,6 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/Type.h"
-#include <map>
 #include <memory>
 
 using namespace NetworkAnalytical;
@@ -17,6 +16,10 @@ namespace NetworkAnalyticalCongestionAware {
 /**
  * Device class represents a single device in the network.
  * Device is usually an NPU or a switch.
+ *
+ * Devices and links are stored contiguously by their Topology.
+ * A device only views its row of the topology's adjacency,
+ * i.e., its outgoing links sorted by their dest device id.
  */
 class Device {
   public:
@@ -43,29 +46,62 @@ class Device {
     void send(std::unique_ptr<Chunk> chunk) noexcept;
 
     /**
-     * Connect a device to another device.
+     * Set the outgoing links of the device.
      *
-     * @param id id of the device to connect this device to
-     * @param bandwidth bandwidth of the link
-     * @param latency latency of the link
+     * @param links pointer to the first outgoing link
+     * @param link_dests pointer to the dest device id of the first outgoing link, sorted in increasing order
+     * @param links_count number of outgoing links
      */
-    void connect(DeviceId id, Bandwidth bandwidth, Latency latency) noexcept;
+    void set_links(Link* links, const DeviceId* link_dests, int links_count) noexcept;
+
+    /**
+     * Set the table instantiating the links not in the device's row of the adjacency on their first use.
+     *
+     * @param lazy_link_table pointer to the lazy link table, owned by the topology
+     */
+    void set_lazy_link_table(LazyLinkTable* lazy_link_table) noexcept;
+
+    /**
+     * Get the link from this device to another device.
+     * The devices should be connected, either by an adjacency link or through the lazy link table.
+     *
+     * @param dest id of the dest device
+     * @return pointer to the link
+     */
+    [[nodiscard]] Link* link_to(DeviceId dest) const noexcept;
 
   private:
     /// device Id
     DeviceId device_id;
 
-    /// links to other nodes
-    /// map[dest node node_id] -> link
-    std::map<DeviceId, std::shared_ptr<Link>> links;
+    /// outgoing links, owned by the topology
+    Link* links;
+
+    /// dest device id of each outgoing link, owned by the topology
+    const DeviceId* link_dests;
+
+    /// number of outgoing links
+    int links_count;
+
+    /// instantiates the links not in the adjacency, or nullptr if unused
+    LazyLinkTable* lazy_link_table;
+
+    /**
+     * Find the index of the outgoing link to another device.
+     *
+     * @param dest id of the dest device
+     * @return index of the link, or -1 if not connected
+     */
+    [[nodiscard]] int find_link(DeviceId dest) const noexcept;
 
     /**
-     * Check if this device is connected to another device.
+     * Get the link from this device to another device if it exists, without instantiating any lazy link,
+     * so that the partitions of a parallel simulation can check their links concurrently.
      *
-     * @param dest id of the device to check te connectivity
-     * @return true if connected to the given device, false otherwise
+     * @param dest id of the dest device
+     * @return pointer to the link, or nullptr if not instantiated
      */
-    [[nodiscard]] bool connected(DeviceId dest) const noexcept;
+    [[nodiscard]] const Link* instantiated_link_to(DeviceId dest) const noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -23,6 +23,9 @@ namespace NetworkAnalyticalCongestionAware {
  * Therefore, the number of NPUs and devices are both 4.
  *
  * Arbitrary send between two pair of NPUs will take 1 hop.
+ *
+ * With lazy links, each of the N*(N-1) links is instantiated only when it's first used,
+ * so that large FullyConnected topologies only pay for the links the workload exercises.
  */
 class FullyConnected final : public BasicTopology {
   public:
@@ -32,8 +35,9 @@ class FullyConnected final : public BasicTopology {
      * @param npus_count number of npus in the FullyConnected topology
      * @param bandwidth bandwidth of each link
      * @param latency latency of each link
+     * @param lazy_links true to instantiate each link on its first use, false to instantiate every link upfront
      */
-    FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
+    FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency, bool lazy_links = false) noexcept;
 
     /**
      * Implementation of route function in Topology.
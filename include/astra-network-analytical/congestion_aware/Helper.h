@@ -17,8 +17,22 @@ namespace NetworkAnalyticalCongestionAware {
  * Construct a topology from a NetworkParser.
  *
  * @param network_parser NetworkParser to parse the network input file
+ * @param lazy_links true to instantiate the links of a FullyConnected topology on their first use
+ *                   (see FullyConnected), false to instantiate every link upfront
  * @return pointer to the constructed topology
  */
-[[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
+[[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser,
+                                                           bool lazy_links = false) noexcept;
+
+/**
+ * Construct a topology from a NetworkParser,
+ * and simulate an All-to-All where every NPU sends a chunk to every other NPU at time 0.
+ * The simulation runs on its own event queue, so it can be invoked from multiple threads concurrently.
+ *
+ * @param network_parser NetworkParser to parse the network input file
+ * @param chunk_size size of the chunk each NPU sends to every other NPU
+ * @return time for the All-to-All to finish
+ */
+[[nodiscard]] EventTime simulate_all_to_all(const NetworkParser& network_parser, ChunkSize chunk_size) noexcept;
 
 }  // namespace NetworkAnalyticalCongestionAware
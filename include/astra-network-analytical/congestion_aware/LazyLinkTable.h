@@ -0,0 +1,132 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Type.h"
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * LazyLinkTable holds the links of a full mesh of identical links,
+ * instantiating each link only when it's first used.
+ * Memory and setup time therefore scale with the links a workload exercises,
+ * not with the square of the number of devices.
+ */
+class LazyLinkTable {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param devices_count number of devices in the full mesh
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    LazyLinkTable(int devices_count, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Get the link from src to dest, instantiating it on its first use.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return pointer to the link, which stays valid as long as the table
+     */
+    [[nodiscard]] Link* link(DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Find the link from src to dest without instantiating it,
+     * which is safe while other threads look up links as well.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return pointer to the link, or nullptr if it hasn't been instantiated yet
+     */
+    [[nodiscard]] const Link* find_link(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Set the event queue to be used by the links, including the ones instantiated later.
+     *
+     * @param event_queue pointer to the event queue
+     */
+    void set_event_queue(EventQueue* event_queue) noexcept;
+
+    /**
+     * Set the event queue of each device, e.g., its partition in a parallel simulation,
+     * including for the links instantiated later.
+     * A link schedules its own events on the event queue of its src device,
+     * and its chunk arrivals on the event queue of its dest device.
+     *
+     * @param device_event_queues pointer to the event queue of each device
+     */
+    void set_device_event_queues(std::vector<EventQueue*> device_event_queues) noexcept;
+
+    /**
+     * Set the link mode of the links, including the ones instantiated later.
+     *
+     * @param link_mode link mode to use
+     */
+    void set_link_mode(LinkMode link_mode) noexcept;
+
+    /**
+     * Set the MTU of the links, including the ones instantiated later.
+     *
+     * @param mtu maximum packet size, or 0 to forward every chunk as a whole
+     */
+    void set_mtu(ChunkSize mtu) noexcept;
+
+    /**
+     * Get the latency of each link.
+     *
+     * @return latency of each link in ns
+     */
+    [[nodiscard]] Latency get_latency() const noexcept;
+
+    /**
+     * Get the number of links instantiated so far.
+     *
+     * @return number of instantiated links
+     */
+    [[nodiscard]] int get_links_count() const noexcept;
+
+  private:
+    /// number of devices in the full mesh
+    int devices_count;
+
+    /// bandwidth of each link
+    Bandwidth bandwidth;
+
+    /// latency of each link
+    Latency latency;
+
+    /// event queue the links schedule events on
+    EventQueue* event_queue;
+
+    /// event queue of each device, or empty if every link uses event_queue
+    std::vector<EventQueue*> device_event_queues;
+
+    /// link mode of the links
+    LinkMode link_mode;
+
+    /// MTU of the links
+    ChunkSize mtu;
+
+    /// instantiated links, a deque keeps their addresses stable
+    std::deque<Link> links;
+
+    /// instantiated links
+    /// map[src * devices_count + dest] -> link
+    std::unordered_map<int64_t, Link*> links_index;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
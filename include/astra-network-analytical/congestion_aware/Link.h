@@ -7,6 +7,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/EventQueue.h"
 #include "common/Type.h"
+#include "congestion_aware/ChunkQueue.h"
 #include "congestion_aware/Type.h"
 #include <memory>
 
@@ -28,20 +29,68 @@ class Link {
      */
     static void link_become_free(void* link_ptr) noexcept;
 
+    /**
+     * Constructor.
+     *
+     * @param bandwidth bandwidth of the link
+     * @param latency latency of the link
+     */
+    Link(Bandwidth bandwidth, Latency latency) noexcept;
+
     /**
      * Set the event queue to be used by the link.
      *
+     * The event queue should outlive the link, e.g., by being held by the link's topology.
+     *
      * @param event_queue_ptr pointer to the event queue
      */
-    static void set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+    void set_event_queue(EventQueue* event_queue_ptr) noexcept;
 
     /**
-     * Constructor.
+     * Set the event queue the chunk arrivals of the link are scheduled on,
+     * i.e., the partition of the link's dest device in a parallel simulation.
+     * It should be set after set_event_queue, which makes it the link's own event queue.
      *
-     * @param bandwidth bandwidth of the link
-     * @param latency latency of the link
+     * @param event_queue_ptr pointer to the event queue of the dest device
      */
-    Link(Bandwidth bandwidth, Latency latency) noexcept;
+    void set_arrival_event_queue(EventQueue* event_queue_ptr) noexcept;
+
+    /**
+     * Get the latency of the link.
+     *
+     * @return latency of the link in ns
+     */
+    [[nodiscard]] Latency get_latency() const noexcept;
+
+    /**
+     * Get the bandwidth of the link.
+     *
+     * @return bandwidth of the link in B/ns
+     */
+    [[nodiscard]] Bandwidth get_bandwidth_Bpns() const noexcept;
+
+    /**
+     * Set how the link tracks when it becomes free.
+     * Should be set before any chunk is sent through the link.
+     *
+     * @param link_mode link mode to use
+     */
+    void set_link_mode(LinkMode link_mode) noexcept;
+
+    /**
+     * Set the MTU of the link, i.e., forward the chunks larger than it as packet trains.
+     * Should be set before any chunk is sent through the link.
+     *
+     * A packet train is still transmitted by a single transmission per hop,
+     * but it's forwarded to the next link as soon as its first packet arrives (cut-through),
+     * and the next link can't finish it before its last packet arrives.
+     * The chunk arrives at its destination once its last packet does.
+     * Without contention, a chunk over h hops thus pays its serialization once, plus (h - 1) packets,
+     * instead of h times.
+     *
+     * @param mtu maximum packet size, or 0 to forward every chunk as a whole (store-and-forward)
+     */
+    void set_mtu(ChunkSize mtu) noexcept;
 
     /**
      * Try to send a chunk through the link.
@@ -77,7 +126,10 @@ class Link {
 
   private:
     /// event queue Link uses to schedule events
-    static std::shared_ptr<EventQueue> event_queue;
+    EventQueue* event_queue;
+
+    /// event queue Link schedules chunk arrivals on
+    EventQueue* arrival_event_queue;
 
     /// bandwidth of the link in GB/s
     Bandwidth bandwidth;
@@ -89,11 +141,26 @@ class Link {
     Latency latency;
 
     /// queue of pending chunks
-    std::list<std::unique_ptr<Chunk>> pending_chunks;
+    ChunkQueue pending_chunks;
 
     /// flag to indicate if the link is busy
     bool busy;
 
+    /// how the link tracks when it becomes free
+    LinkMode link_mode;
+
+    /// maximum packet size, or 0 if chunks are forwarded as a whole
+    ChunkSize mtu;
+
+    /// time the link becomes free (BusyUntil mode)
+    EventTime busy_until;
+
+    /// sequence number reserved for the link-free event of the current transmission (BusyUntil mode)
+    uint64_t link_free_sequence;
+
+    /// flag to indicate if the link-free event of the current transmission is scheduled (BusyUntil mode)
+    bool link_free_scheduled;
+
     /**
      * Compute the serialization delay of a chunk on the link.
      * i.e., serialization delay = (chunk size) / (link bandwidth)
@@ -116,11 +183,47 @@ class Link {
      * Schedule the transmission of a chunk.
      * - Set the link as busy.
      * - Link becomes free after the serialization delay.
+     *   In BusyUntil mode, the link-free event is only scheduled once a chunk is pending.
      * - Chunk arrives next node after the communication delay.
      *
      * @param chunk chunk to be transmitted
      */
     void schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Schedule the transmission of a batch, or of a chunk larger than the MTU, as a packet train.
+     * - Link becomes free once every packet has been serialized,
+     *   which takes the serialization delay of the items, or longer if the last packet arrives late.
+     * - Chunk arrives next node once its first packet does.
+     * - At the destination, each item arrives once its last packet does, and the chunk with the last item.
+     *
+     * @param chunk chunk to be transmitted
+     * @param current_time current time
+     * @return time the link becomes free
+     */
+    EventTime schedule_packet_train_transmission(std::unique_ptr<Chunk> chunk, EventTime current_time) noexcept;
+
+    /**
+     * Schedule an arrival event at the next device.
+     *
+     * @param arrival_time time of the arrival
+     * @param callback callback of the arrival event
+     * @param callback_arg argument of the callback
+     */
+    void schedule_arrival(EventTime arrival_time, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Schedule the deferred link-free event of the current transmission (BusyUntil mode).
+     * The event takes the sequence number reserved when the transmission started,
+     * so it's invoked exactly when the LinkFreeEvent mode would have invoked it.
+     */
+    void schedule_link_free() noexcept;
+
+    /**
+     * Set the link as free if the deferred link-free event
+     * of the current transmission would have already been invoked (BusyUntil mode).
+     */
+    void update_busy() noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,77 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * MessagePool recycles the messages a driver passes to the arrival callbacks of its chunks.
+ *
+ * Messages are allocated in fixed-size slabs and handed out through an intrusive free list
+ * (Message::next_free), so once the pool has grown to the peak number of messages in flight,
+ * acquiring and releasing messages does not touch the heap allocator at all.
+ *
+ * @tparam Message message type, with a "Message* next_free" member
+ */
+template <typename Message>
+class MessagePool {
+  public:
+    /**
+     * Take a free message, growing the pool by a slab if none is left.
+     *
+     * @return pointer to the free message
+     */
+    [[nodiscard]] Message* acquire() noexcept {
+        if (free_list == nullptr) {
+            allocate_slab();
+        }
+
+        auto* const message = free_list;
+        free_list = message->next_free;
+        return message;
+    }
+
+    /**
+     * Return a message to the pool.
+     *
+     * @param message message to recycle
+     */
+    void release(Message* const message) noexcept {
+        assert(message != nullptr);
+
+        message->next_free = free_list;
+        free_list = message;
+    }
+
+  private:
+    /// number of messages per slab
+    static constexpr size_t slab_size = 4096;
+
+    /// allocated slabs, which own the messages
+    std::vector<std::unique_ptr<Message[]>> slabs;
+
+    /// head of the free message list
+    Message* free_list = nullptr;
+
+    /**
+     * Allocate a new slab and thread its messages onto the free list.
+     */
+    void allocate_slab() noexcept {
+        auto slab = std::make_unique<Message[]>(slab_size);
+        for (auto i = size_t(0); i < slab_size; i++) {
+            slab[i].next_free = (i + 1 < slab_size) ? &slab[i + 1] : free_list;
+        }
+        free_list = slab.get();
+        slabs.push_back(std::move(slab));
+    }
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,102 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * MultiDimTopology implements multi-dimensional network topologies
+ * whose dimensions are Ring, FullyConnected, or Switch basic topologies.
+ *
+ * Every dimension is instantiated directly into a single device graph:
+ * NPU ids are 0 to (npus_count - 1), where dim 0 is the least significant digit of the id,
+ * and a Switch dimension adds one switch device per group of NPUs differing only in that dimension.
+ * Hence each NPU only holds the links of its own neighbors in each dimension.
+ *
+ * A chunk is routed in dimension order:
+ * it first moves along dim 0 (using the dimension's basic routing), then dim 1, and so on.
+ *
+ * For example, with Ring(4) x Switch(2), NPU 1 = [1, 0] sends to NPU 7 = [3, 1] through:
+ * 1 -> 0 -> 3 (along the ring) -> switch of [3, *] -> 7
+ */
+class MultiDimTopology final : public Topology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology_per_dim basic topology type of each dimension
+     * @param npus_count_per_dim number of NPUs of each dimension
+     * @param bandwidth_per_dim link bandwidth of each dimension
+     * @param latency_per_dim link latency of each dimension
+     */
+    MultiDimTopology(const std::vector<TopologyBuildingBlock>& topology_per_dim,
+                     const std::vector<int>& npus_count_per_dim,
+                     const std::vector<Bandwidth>& bandwidth_per_dim,
+                     const std::vector<Latency>& latency_per_dim) noexcept;
+
+    /**
+     * Implementation of route function in Topology.
+     */
+    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+
+  private:
+    /// basic topology type of each dimension
+    std::vector<TopologyBuildingBlock> topology_per_dim;
+
+    /// distance between the ids of neighboring NPUs in each dimension
+    /// i.e., the product of the sizes of the lower dimensions
+    std::vector<int> stride_per_dim;
+
+    /// id of the first switch of each Switch dimension, -1 for other dimensions
+    std::vector<DeviceId> first_switch_id_per_dim;
+
+    /**
+     * Get the address of an NPU in a dimension.
+     *
+     * @param npu_id id of the NPU
+     * @param dim dimension
+     * @return address of the NPU in the dimension
+     */
+    [[nodiscard]] int address_of(DeviceId npu_id, int dim) const noexcept;
+
+    /**
+     * Get the switch that the given NPU is connected to in a Switch dimension.
+     *
+     * @param npu_id id of the NPU
+     * @param dim Switch dimension
+     * @return id of the switch device
+     */
+    [[nodiscard]] DeviceId switch_of(DeviceId npu_id, int dim) const noexcept;
+
+    /**
+     * Connect the NPUs along a dimension.
+     *
+     * @param dim dimension to connect
+     * @param bandwidth link bandwidth of the dimension
+     * @param latency link latency of the dimension
+     */
+    void connect_dimension(int dim, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Append the route along a single dimension, from current to the NPU whose address in the dimension is dest.
+     * The current NPU itself is not appended.
+     *
+     * @param route route to append to
+     * @param current id of the current NPU
+     * @param dim dimension to move along
+     * @param dest_address address of the destination in the dimension
+     * @return id of the NPU reached
+     */
+    DeviceId route_dimension(Route& route, DeviceId current, int dim, int dest_address) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
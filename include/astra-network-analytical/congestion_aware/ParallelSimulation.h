@@ -0,0 +1,106 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/ParallelEventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ParallelSimulation simulates a topology with conservative parallel discrete-event simulation.
+ *
+ * The devices are split into partitions of contiguous device ids (NPUs and switches separately),
+ * each of which has its own event queue and runs on its own thread.
+ * A link belongs to the partition of its src device, and its chunk arrivals
+ * are sent to the partition of its dest device at the end of each lookahead window,
+ * whose length is the minimum link latency of the topology.
+ * Results are identical to a sequential simulation of the same chunks.
+ *
+ * Usage: construct the simulation before sending any chunk, send the chunks through the topology,
+ * then run the simulation once. Links always use LinkMode::LinkFreeEvent,
+ * which gives the same results as LinkMode::BusyUntil.
+ *
+ * Chunk arrival callbacks are invoked on the thread of the dest device's partition,
+ * so they should not share unsynchronized state across partitions,
+ * and may only send chunks from the dest device, over routes resolved before the simulation
+ * and with chunks allocated by std::make_unique (the topology's chunk pool and route cache are not thread-safe).
+ */
+class ParallelSimulation {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to simulate, whose links should have a latency of at least 1 ns
+     * @param partitions_count number of partitions, i.e., threads
+     * @param engine_type priority queue engine of each partition
+     */
+    ParallelSimulation(std::shared_ptr<Topology> topology,
+                       int partitions_count,
+                       EventQueueEngineType engine_type = EventQueueEngineType::QuaternaryHeap) noexcept;
+
+    /**
+     * Get the partition a device belongs to.
+     *
+     * @param device id of the device
+     * @return index of the partition
+     */
+    [[nodiscard]] int get_partition(DeviceId device) const noexcept;
+
+    /**
+     * Get the event queue of the partition a device belongs to,
+     * e.g., to query the current time in a chunk arrival callback.
+     *
+     * @param device id of the device
+     * @return event queue of the device's partition
+     */
+    [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue(DeviceId device) const noexcept;
+
+    /**
+     * Run the simulation until every chunk has arrived its destination.
+     */
+    void run() noexcept;
+
+    /**
+     * Get the time the simulation finished at.
+     *
+     * @return time of the last event
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Get the number of events scheduled so far.
+     *
+     * @return number of scheduled events
+     */
+    [[nodiscard]] uint64_t get_scheduled_events_count() const noexcept;
+
+    /**
+     * Get the number of lookahead windows the simulation has gone through.
+     *
+     * @return number of windows
+     */
+    [[nodiscard]] uint64_t get_windows_count() const noexcept;
+
+  private:
+    /// topology being simulated
+    std::shared_ptr<Topology> topology;
+
+    /// partition index of each device
+    std::vector<int> partition_per_device;
+
+    /// event queues of the partitions
+    std::unique_ptr<ParallelEventQueue> parallel_event_queue;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
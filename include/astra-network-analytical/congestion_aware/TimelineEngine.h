@@ -0,0 +1,264 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include "congestion_aware/TraceReplay.h"
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * TimelineEngine computes the arrival time of every send of an open-loop trace,
+ * i.e., a trace whose whole injection schedule is known up front, without any event queue.
+ *
+ * Sends are stored and forwarded as whole chunks over the routes of a congestion aware topology,
+ * and each link serves the chunks in FIFO order of their arrival at it, keeping only
+ * the time it is busy until and a queue of the chunks waiting for it.
+ * The steps of the timeline (injections, arrivals at the next device, and links becoming free)
+ * are swept in (time, sequence number) order, numbered exactly as the event-driven engine would number its events,
+ * so every send arrives at exactly the same time as with TraceReplay, ties included,
+ * at the cost of a plain heap entry per step rather than a chunk, a callback, and an event.
+ *
+ * Only whole chunks are stored and forwarded: the topology should have no MTU (see Topology::set_mtu),
+ * whose packet trains should be replayed with TraceReplay instead, or the engine exits with an error.
+ * Chunk batches never arise, as every trace record is a single send.
+ */
+class TimelineEngine {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology whose routes and links the sends go through, without an MTU
+     */
+    explicit TimelineEngine(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Compute the timeline of a trace, given as records sorted by time.
+     *
+     * @param records records of the trace
+     * @param records_count number of records
+     * @param arrival_times output, if not nullptr: time each send arrives at, with one entry per record
+     * @return report of the timeline, as TraceReplay would report it
+     */
+    [[nodiscard]] TraceReplayReport run(const TraceRecord* records,
+                                        uint64_t records_count,
+                                        EventTime* arrival_times = nullptr) noexcept;
+
+    /**
+     * Compute the timeline of a trace file.
+     *
+     * @param trace_path path of the trace file
+     * @param arrival_times output, if not nullptr: time each send arrives at, with one entry per record
+     * @return report of the timeline, as TraceReplay would report it
+     */
+    [[nodiscard]] TraceReplayReport run(const std::string& trace_path, EventTime* arrival_times = nullptr) noexcept;
+
+  private:
+    /**
+     * StepType is the kind of a step of the timeline.
+     */
+    enum class StepType : uint32_t {
+        Inject = 0,
+        Arrival,
+        LinkFree
+    };
+
+    /**
+     * Step is a point of the timeline, the event-free counterpart of an event.
+     */
+    struct Step {
+        /// time of the step
+        EventTime time;
+
+        /// sequence number the event-driven engine would have given the event
+        uint64_t sequence;
+
+        /// kind of the step
+        StepType type;
+
+        /// send arriving at its next device (Arrival), or link becoming free (LinkFree)
+        uint32_t target;
+
+        /**
+         * Order steps by time, then by sequence number, for a min-heap.
+         *
+         * @param other step to compare with
+         * @return true if this step comes after the other
+         */
+        bool operator>(const Step& other) const noexcept {
+            return (time != other.time) ? (time > other.time) : (sequence > other.sequence);
+        }
+    };
+
+    /**
+     * TimelineLink is the state of a link.
+     */
+    struct TimelineLink {
+        /// bandwidth in B/ns
+        Bandwidth bandwidth_Bpns;
+
+        /// latency in ns
+        Latency latency;
+
+        /// time the link is busy until, if busy
+        EventTime busy_until;
+
+        /// sequence number reserved for the link becoming free at busy_until
+        uint64_t free_sequence;
+
+        /// first send waiting for the link, or -1
+        int pending_head;
+
+        /// last send waiting for the link, or -1
+        int pending_tail;
+
+        /// true if the link is serializing a chunk, or was until busy_until
+        bool busy;
+
+        /// true if a LinkFree step is in the heap
+        bool free_scheduled;
+    };
+
+    /**
+     * TimelineRoute is a route some sends in flight go through.
+     */
+    struct TimelineRoute {
+        /// key of the route, src * npus_count + dest
+        int64_t key;
+
+        /// indices of the links of the route
+        std::vector<int> links;
+
+        /// number of sends in flight through the route
+        uint64_t sends_count;
+    };
+
+    /**
+     * TimelineSend is a send in flight.
+     */
+    struct TimelineSend {
+        /// route of the send
+        TimelineRoute* route;
+
+        /// index of the link the send is on, or waiting for
+        uint32_t hop;
+
+        /// size of the send
+        ChunkSize size;
+
+        /// index of the record of the send
+        uint64_t record;
+
+        /// time the send was injected at
+        EventTime injection_time;
+
+        /// next send waiting for the same link, or -1
+        int next_pending;
+    };
+
+    /// topology whose routes and links the sends go through
+    std::shared_ptr<Topology> topology;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// index of each link the sends have gone through
+    std::unordered_map<const Link*, int> link_indices;
+
+    /// links, indexed by link_indices
+    std::vector<TimelineLink> links;
+
+    /// routes of the sends in flight, map[src * npus_count + dest] -> route, freed when their last send arrives
+    std::unordered_map<int64_t, std::unique_ptr<TimelineRoute>> routes;
+
+    /// sends in flight, indexed by id
+    std::vector<TimelineSend> sends;
+
+    /// ids of the arrived sends, which are reused by the next sends
+    std::vector<int> free_sends;
+
+    /// steps of the timeline not processed yet
+    std::priority_queue<Step, std::vector<Step>, std::greater<>> steps;
+
+    /// next sequence number to give a step
+    uint64_t next_sequence;
+
+    /// time of the step being processed
+    EventTime current_time;
+
+    /// sequence number of the step being processed
+    uint64_t current_sequence;
+
+    /**
+     * Check the topology forwards every chunk as a whole, or exit.
+     */
+    void check_store_and_forward() const noexcept;
+
+    /**
+     * Take the route from src to dest for a new send, resolving it if no send in flight goes through it.
+     *
+     * @param src src NPU
+     * @param dest dest NPU
+     * @return route from src to dest
+     */
+    [[nodiscard]] TimelineRoute* acquire_route(DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Release the route of an arrived send, freeing it if no other send in flight goes through it.
+     *
+     * @param route route to release
+     */
+    void release_route(TimelineRoute* route) noexcept;
+
+    /**
+     * Push a step into the heap, with the next sequence number.
+     *
+     * @param time time of the step
+     * @param type kind of the step
+     * @param target target of the step
+     */
+    void push_step(EventTime time, StepType type, uint32_t target) noexcept;
+
+    /**
+     * Send a send over the link of its current hop, as Link::send would.
+     *
+     * @param send_id id of the send
+     */
+    void send_to_link(int send_id) noexcept;
+
+    /**
+     * Start serializing a send over a free link, as Link::schedule_chunk_transmission would.
+     *
+     * @param link index of the link
+     * @param send_id id of the send
+     */
+    void transmit(int link, int send_id) noexcept;
+
+    /**
+     * Push the LinkFree step of a busy link, using the sequence number reserved for it.
+     *
+     * @param link index of the link
+     */
+    void schedule_link_free(int link) noexcept;
+
+    /**
+     * Take a link becoming free: serve the first send waiting for it, if any.
+     *
+     * @param link index of the link
+     */
+    void free_link(int link) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
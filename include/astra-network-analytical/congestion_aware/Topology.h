@@ -7,8 +7,15 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/EventQueue.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/ChunkPool.h"
 #include "congestion_aware/Device.h"
+#include "congestion_aware/LazyLinkTable.h"
+#include "congestion_aware/Link.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -17,20 +24,73 @@ namespace NetworkAnalyticalCongestionAware {
 
 /**
  * Topology abstracts a network topology.
+ *
+ * Devices and links are stored in contiguous arrays.
+ * Outgoing links are laid out in CSR (compressed sparse row) order:
+ * the links of device i are links[link_offsets[i]] to links[link_offsets[i + 1] - 1],
+ * sorted by their dest device id (link_dests).
  */
 class Topology {
   public:
+    /**
+     * Constructor.
+     */
+    Topology() noexcept;
+
     /**
      * Set the event queue to be used by the topology.
+     * Each topology instance (and its devices and links) schedules events only on its own event queue,
+     * so independent topologies can be simulated side by side, e.g., in separate threads.
      *
      * @param event_queue pointer to the event queue
      */
-    static void set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
+    void set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
 
     /**
-     * Constructor.
+     * Get the event queue used by the topology.
+     *
+     * @return pointer to the event queue
      */
-    Topology() noexcept;
+    [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
+
+    /**
+     * Distribute the devices of the topology over multiple event queues,
+     * e.g., the partitions of a ParallelEventQueue.
+     * Each link schedules its own events on the event queue of its src device,
+     * and the arrivals of its chunks on the event queue of its dest device.
+     * Chunks created by the topology may then be destroyed on any thread.
+     *
+     * @param device_event_queues event queue of each device
+     */
+    void set_device_event_queues(const std::vector<std::shared_ptr<EventQueue>>& device_event_queues) noexcept;
+
+    /**
+     * Set how the links of the topology model their occupancy.
+     * Links use LinkMode::LinkFreeEvent by default.
+     * Should be set before any chunk is sent.
+     *
+     * @param link_mode link mode to use
+     */
+    void set_link_mode(LinkMode link_mode) noexcept;
+
+    /**
+     * Set the MTU of the links of the topology, i.e., packetize the chunks larger than it.
+     * Chunks are forwarded as a whole (store-and-forward) by default.
+     * Should be set before any chunk is sent.
+     *
+     * A packetized chunk is pipelined over its route (cut-through) as a single packet train,
+     * which costs the same events per hop as a whole chunk. See Link::set_mtu.
+     *
+     * @param mtu maximum packet size, or 0 to forward every chunk as a whole
+     */
+    void set_mtu(ChunkSize mtu) noexcept;
+
+    /**
+     * Get the MTU of the links of the topology.
+     *
+     * @return maximum packet size, or 0 if every chunk is forwarded as a whole
+     */
+    [[nodiscard]] ChunkSize get_mtu() const noexcept;
 
     /**
      * Construct the route from src to dest.
@@ -46,6 +106,87 @@ class Topology {
      */
     [[nodiscard]] virtual Route route(DeviceId src, DeviceId dest) const noexcept = 0;
 
+    /**
+     * Get the route from src to dest as an immutable route shared by every caller.
+     * The route is constructed on the first request of each (src, dest) pair and cached afterward,
+     * so chunks between the same pair can be created without any route allocation.
+     *
+     * At most get_route_cache_capacity() routes are cached: once full, the least recently requested route
+     * is evicted, and constructed again on its next request.
+     * An evicted route stays valid for as long as a chunk (or any caller) holds it.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     *
+     * @return shared route from src NPU to dest NPU
+     */
+    [[nodiscard]] SharedRoute shared_route(DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Set the maximum number of routes shared_route caches, evicting the least recently requested ones beyond it.
+     * The capacity is 65'536 routes by default, i.e., every pair of up to 256 NPUs.
+     *
+     * @param route_cache_capacity maximum number of cached routes, at least 1
+     */
+    void set_route_cache_capacity(size_t route_cache_capacity) noexcept;
+
+    /**
+     * Get the maximum number of routes shared_route caches.
+     *
+     * @return maximum number of cached routes
+     */
+    [[nodiscard]] size_t get_route_cache_capacity() const noexcept;
+
+    /**
+     * Get the number of routes shared_route currently caches.
+     *
+     * @return number of cached routes
+     */
+    [[nodiscard]] size_t get_cached_routes_count() const noexcept;
+
+    /**
+     * Create a chunk whose storage is recycled by the topology's chunk pool.
+     * Behaves exactly like std::make_unique<Chunk>(chunk_size, route, callback, callback_arg),
+     * except that it does not allocate once the pool has grown to the peak number of live chunks.
+     * The chunk should not outlive the topology.
+     *
+     * @param chunk_size size of the chunk
+     * @param route shared route of the chunk from its source to destination
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param callback_arg argument of the callback
+     * @return created chunk
+     */
+    [[nodiscard]] std::unique_ptr<Chunk> create_chunk(ChunkSize chunk_size,
+                                                      SharedRoute route,
+                                                      Callback callback,
+                                                      CallbackArg callback_arg) noexcept;
+
+    /**
+     * Create a batch of identical chunks, e.g., equal pieces of a fan-out, in the topology's chunk pool.
+     * The batch behaves like items_count chunks of chunk_size sent back-to-back along the route,
+     * but costs the events of a single chunk per hop.
+     * The callback is invoked once per item, when each item arrives at the destination.
+     *
+     * @param chunk_size size of each item
+     * @param items_count number of items in the batch
+     * @param route shared route of the items from their source to destination
+     * @param callback callback to be invoked when each item arrives destination
+     * @param callback_arg argument of the callback
+     * @return created batch
+     */
+    [[nodiscard]] std::unique_ptr<Chunk> create_chunk_batch(ChunkSize chunk_size,
+                                                            int items_count,
+                                                            SharedRoute route,
+                                                            Callback callback,
+                                                            CallbackArg callback_arg) noexcept;
+
+    /**
+     * Get the number of chunk storages the topology's chunk pool has allocated so far.
+     *
+     * @return number of allocated chunk storages
+     */
+    [[nodiscard]] uint64_t get_allocated_chunk_slots_count() const noexcept;
+
     /**
      * Initiate a transmission of a chunk.
      *
@@ -69,6 +210,22 @@ class Topology {
      */
     [[nodiscard]] int get_devices_count() const noexcept;
 
+    /**
+     * Get the number of links instantiated so far.
+     * This includes lazily instantiated links that have been used.
+     *
+     * @return number of instantiated links
+     */
+    [[nodiscard]] int get_links_count() const noexcept;
+
+    /**
+     * Get the minimum latency of the links in the topology,
+     * i.e., the minimum delay between a chunk leaving a device and arriving at the next one.
+     *
+     * @return minimum link latency
+     */
+    [[nodiscard]] Latency get_min_link_latency() const noexcept;
+
     /**
      * Get the number of network dimensions.
      *
@@ -105,12 +262,75 @@ class Topology {
     /// number of NPUs per each dimension
     std::vector<int> npus_count_per_dim;
 
-    /// holds the entire device instances in the topology
+    /// holds the entire device instances in the topology, stored contiguously
+    std::shared_ptr<std::vector<Device>> device_storage;
+
+    /// handles to the devices in device_storage, indexed by device id
     std::vector<std::shared_ptr<Device>> devices;
 
+    /// holds the entire link instances in the topology, in CSR order
+    std::vector<Link> links;
+
+    /// links of device i are in [link_offsets[i], link_offsets[i + 1])
+    std::vector<int> link_offsets;
+
+    /// dest device id of each link
+    std::vector<DeviceId> link_dests;
+
+    /// instantiates full-mesh links on their first use, or nullptr if unused
+    std::unique_ptr<LazyLinkTable> lazy_link_table;
+
     /// bandwidth per each network dimension
     std::vector<Bandwidth> bandwidth_per_dim;
 
+    /// event queue the topology schedules its events on
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// event queue of each device, if the devices are distributed over multiple event queues
+    std::vector<std::shared_ptr<EventQueue>> device_event_queues;
+
+    /// link mode of the topology's links
+    LinkMode link_mode;
+
+    /// MTU of the topology's links, or 0 if chunks are forwarded as a whole
+    ChunkSize mtu;
+
+    /**
+     * LinkSpec is a connection requested by connect, to be instantiated by build_links.
+     */
+    struct LinkSpec {
+        /// src device id
+        DeviceId src;
+
+        /// dest device id
+        DeviceId dest;
+
+        /// bandwidth of the link
+        Bandwidth bandwidth;
+
+        /// latency of the link
+        Latency latency;
+    };
+
+    /// connections to be instantiated by build_links
+    std::vector<LinkSpec> link_specs;
+
+    /// recycles the storage of the chunks created by create_chunk
+    ChunkPool chunk_pool;
+
+    /// number of routes shared_route caches by default, i.e., every pair of up to 256 NPUs
+    static constexpr size_t default_route_cache_capacity = 65'536;
+
+    /// cached shared routes with their src * npus_count + dest key, the most recently requested first
+    std::list<std::pair<int64_t, SharedRoute>> shared_routes;
+
+    /// position of each cached route in shared_routes
+    /// map[src * npus_count + dest] -> position
+    std::unordered_map<int64_t, std::list<std::pair<int64_t, SharedRoute>>::iterator> shared_route_positions;
+
+    /// maximum number of cached shared routes
+    size_t route_cache_capacity;
+
     /**
      * Instantiate Device objects in the topology.
      */
@@ -118,7 +338,7 @@ class Topology {
 
     /**
      * Connect src -> dest with the given bandwidth and latency.
-     * (i.e., a `Link` gets constructed between the two npus)
+     * (i.e., a `Link` gets constructed between the two npus by build_links)
      *
      * if bidirectional=true, dest -> src connection is also established.
      *
@@ -129,6 +349,22 @@ class Topology {
      * @param bidirectional true if connection is bidirectional, false otherwise
      */
     void connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
+
+    /**
+     * Instantiate the Link objects of every connection in CSR order,
+     * and attach each device to its outgoing links.
+     * Should be invoked once, after every connection has been made.
+     */
+    void build_links() noexcept;
+
+    /**
+     * Connect every pair of devices with identical links,
+     * each of which is instantiated only when it's first used.
+     *
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    void connect_lazily(Bandwidth bandwidth, Latency latency) noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
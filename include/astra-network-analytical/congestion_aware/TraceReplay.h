@@ -0,0 +1,270 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/MessagePool.h"
+#include "congestion_aware/Topology.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * TraceHeader starts a binary traffic trace file.
+ *
+ * After the header, the file holds records_count TraceRecords, sorted by time.
+ * Every field is in native byte order, so that the file can be memory-mapped and read in place.
+ */
+struct TraceHeader {
+    /// identifies the file format, trace_magic
+    char magic[8];
+
+    /// version of the file format, trace_version
+    uint32_t version;
+
+    /// reserved, 0
+    uint32_t reserved;
+
+    /// number of records
+    uint64_t records_count;
+
+    /// reserved, 0
+    uint64_t reserved_tail;
+};
+
+static_assert(sizeof(TraceHeader) == 32, "TraceHeader should take 32 bytes");
+
+/**
+ * TraceRecord is a send of a traffic trace.
+ */
+struct TraceRecord {
+    /// time to inject the send at, relative to the start of the replay
+    EventTime time;
+
+    /// src NPU
+    uint32_t src;
+
+    /// dest NPU
+    uint32_t dest;
+
+    /// number of bytes to send
+    ChunkSize size;
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord should take 24 bytes");
+
+/// magic of a binary traffic trace file
+constexpr char trace_magic[8] = {'N', 'A', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+/// version of the binary traffic trace file format
+constexpr uint32_t trace_version = 1;
+
+/**
+ * Read every record of a binary traffic trace file into memory, after checking its header.
+ *
+ * @param trace_path path of the trace file
+ * @return records of the trace
+ */
+[[nodiscard]] std::vector<TraceRecord> read_trace(const std::string& trace_path) noexcept;
+
+/**
+ * Get the peak resident memory of the process so far.
+ *
+ * @return peak resident memory in KB
+ */
+[[nodiscard]] uint64_t get_peak_resident_memory_KB() noexcept;
+
+/**
+ * TraceReplayReport summarizes a trace replay.
+ */
+struct TraceReplayReport {
+    /// number of replayed sends
+    uint64_t sends_count;
+
+    /// time for the last send to arrive, relative to the start of the replay
+    EventTime finish_time;
+
+    /// mean time between the injection and the arrival of a send
+    double mean_send_delay;
+
+    /// maximum time between the injection and the arrival of a send
+    EventTime max_send_delay;
+
+    /// peak number of sends injected but not arrived yet
+    uint64_t peak_in_flight_sends_count;
+
+    /// peak resident memory of the process (KB), as reported by getrusage
+    uint64_t peak_resident_memory_KB;
+};
+
+/**
+ * TraceWriter writes a binary traffic trace file record by record.
+ */
+class TraceWriter {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param trace_path path of the trace file to write
+     */
+    explicit TraceWriter(const std::string& trace_path) noexcept;
+
+    /**
+     * Append a record to the trace.
+     *
+     * @param record record to append, no earlier than the last one
+     */
+    void write(const TraceRecord& record) noexcept;
+
+    /**
+     * Write the number of records into the header, then flush and close the trace file.
+     */
+    void close() noexcept;
+
+  private:
+    /// path of the trace file
+    std::string trace_path;
+
+    /// trace file
+    std::ofstream output;
+
+    /// number of records written
+    uint64_t records_count;
+
+    /// time of the last record written
+    EventTime last_time;
+};
+
+/**
+ * TraceReplay replays a binary traffic trace against a topology.
+ *
+ * The trace is memory-mapped, and its sends are injected lazily by a single injection event:
+ * when it fires, it sends every record due at the current time through Topology::send,
+ * then reschedules itself at the time of the next record.
+ * The event queue thus holds at most one injection event besides the chunks in flight,
+ * and the pages of the trace behind the injection cursor are released window by window,
+ * so a trace of any length replays in bounded memory.
+ */
+class TraceReplay {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to replay the trace on, whose event queue has been set
+     * @param release_window_size the pages of the trace are released every this many bytes
+     */
+    explicit TraceReplay(std::shared_ptr<Topology> topology, size_t release_window_size = 64 * 1'024 * 1'024) noexcept;
+
+    /**
+     * Replay a trace, and process the events of the topology's event queue until every send arrives.
+     *
+     * @param trace_path path of the trace file
+     * @param arrival_times output, if not nullptr: time each send arrives at, relative to the start of the replay,
+     *                      with one entry per record
+     * @return report of the replay
+     */
+    [[nodiscard]] TraceReplayReport run(const std::string& trace_path, EventTime* arrival_times = nullptr) noexcept;
+
+  private:
+    /**
+     * Message is a send in flight, passed to its arrival callback.
+     */
+    struct Message {
+        /// replay the send belongs to
+        TraceReplay* replay;
+
+        /// time the send was injected at
+        EventTime injection_time;
+
+        /// index of the record of the send
+        uint64_t record;
+
+        /// next free message, while the message is in the free list
+        Message* next_free;
+    };
+
+    /// topology to replay the trace on
+    std::shared_ptr<Topology> topology;
+
+    /// the pages of the trace are released every this many bytes
+    size_t release_window_size;
+
+    /// memory-mapped trace file
+    const char* mapped_trace;
+
+    /// size of the memory-mapped trace file
+    size_t mapped_size;
+
+    /// records of the trace
+    const TraceRecord* records;
+
+    /// number of records of the trace
+    uint64_t records_count;
+
+    /// index of the next record to inject
+    uint64_t next_record;
+
+    /// offset of the trace up to which pages have been released
+    size_t released_offset;
+
+    /// time the replay started at
+    EventTime start_time;
+
+    /// time each send arrives at, or nullptr if not requested
+    EventTime* arrival_times;
+
+    /// report of the running replay
+    TraceReplayReport report;
+
+    /// sum of the delays of the arrived sends
+    double total_send_delay;
+
+    /// number of sends injected but not arrived yet
+    uint64_t in_flight_sends_count;
+
+    /// recycles the messages in flight
+    MessagePool<Message> message_pool;
+
+    /**
+     * Callback of the injection event.
+     *
+     * @param replay_ptr pointer to the replay
+     */
+    static void inject(void* replay_ptr) noexcept;
+
+    /**
+     * Callback invoked when a send arrives at its dest NPU.
+     *
+     * @param message_ptr pointer to the arrived message
+     */
+    static void message_arrived(void* message_ptr) noexcept;
+
+    /**
+     * Map a trace file into memory, and check its header.
+     *
+     * @param trace_path path of the trace file
+     */
+    void map_trace(const std::string& trace_path) noexcept;
+
+    /**
+     * Unmap the trace file.
+     */
+    void unmap_trace() noexcept;
+
+    /**
+     * Release the pages of the trace which are a whole window behind the injection cursor.
+     */
+    void release_consumed_pages() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -7,15 +7,44 @@ LICENSE file in the root directory of this source tree.
 
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace NetworkAnalyticalCongestionAware {
 
 /// Forward declarations of network components
 class Chunk;
+class ChunkPool;
+class ChunkQueue;
 class Link;
 class Device;
+class LazyLinkTable;
 
 /// Route is a list of devices
 using Route = std::list<std::shared_ptr<Device>>;
 
+/**
+ * RoutePath is a contiguous route, resolved into the links it traverses.
+ */
+struct RoutePath {
+    /// devices to traverse, including the src and dest devices themselves
+    std::vector<std::shared_ptr<Device>> devices;
+
+    /// links to traverse, links[i] connects devices[i] to devices[i + 1]
+    std::vector<Link*> links;
+};
+
+/// SharedRoute is an immutable RoutePath which can be shared by many chunks
+using SharedRoute = std::shared_ptr<const RoutePath>;
+
+/**
+ * How a Link tracks when it becomes free.
+ *  - LinkFreeEvent: schedule a link-free event for every transmitted chunk.
+ *  - BusyUntil: keep the busy-until time, and schedule a link-free event only if a chunk has to wait for it.
+ * Both modes yield bit-identical simulation results.
+ */
+enum class LinkMode { LinkFreeEvent, BusyUntil };
+
+/// Encodings of a collective schedule file
+enum class ScheduleFormat { Text, Binary };
+
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,268 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionFluid {
+
+using NetworkAnalyticalCongestionAware::Link;
+using NetworkAnalyticalCongestionAware::SharedRoute;
+using NetworkAnalyticalCongestionAware::Topology;
+
+/**
+ * FlowNetwork simulates transfers as fluid flows over the routes of a congestion aware topology.
+ *
+ * Instead of forwarding chunks link by link, each flow streams over its whole route at a rate,
+ * and the rates of the flows sharing links are max-min fair:
+ * no flow can get a higher rate without lowering the rate of a flow with an equal or lower rate.
+ * A flow finishes once its bytes have been streamed, and arrives at its dest after the latency of its route,
+ * i.e., a flow is pipelined over its route rather than stored and forwarded at every hop.
+ *
+ * Rates are recomputed only when flows start or finish, once per timestamp,
+ * and only for the flows connected to them through shared links.
+ * A flow thus costs a handful of events, however long its route and however large it is,
+ * which makes bulk transfers orders of magnitude cheaper to simulate than with per-chunk store-and-forward.
+ */
+class FlowNetwork {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology whose routes and links the flows go through, whose event queue has been set
+     */
+    explicit FlowNetwork(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Start a flow at the current time.
+     *
+     * @param src src NPU
+     * @param dest dest NPU
+     * @param flow_size number of bytes to transfer
+     * @param callback callback to be invoked when the flow arrives at its dest
+     * @param callback_arg argument of the callback
+     */
+    void send(DeviceId src, DeviceId dest, ChunkSize flow_size, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Get the event queue the flows are simulated on.
+     *
+     * @return pointer to the event queue
+     */
+    [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
+
+    /**
+     * Get the number of flows in flight, i.e., started and not finished streaming yet.
+     *
+     * @return number of flows in flight
+     */
+    [[nodiscard]] uint64_t get_active_flows_count() const noexcept;
+
+    /**
+     * Get the number of times rates have been recomputed so far.
+     *
+     * @return number of rate recomputations
+     */
+    [[nodiscard]] uint64_t get_recomputations_count() const noexcept;
+
+  private:
+    /**
+     * Flow is a transfer in flight.
+     */
+    struct Flow {
+        /// route of the flow, held while the flow is in flight
+        SharedRoute route;
+
+        /// indices of the links of the route
+        std::vector<int> links;
+
+        /// sum of the latencies of the links of the route
+        EventTime latency;
+
+        /// position of the flow in the flow list of each link of its route
+        std::vector<int> positions;
+
+        /// bytes left to stream at last_update_time
+        double remaining_size;
+
+        /// current rate in B/ns
+        double rate;
+
+        /// time remaining_size was last updated at
+        EventTime last_update_time;
+
+        /// bumped whenever the rate changes, to invalidate the completions scheduled before
+        uint64_t version;
+
+        /// callback to be invoked when the flow arrives at its dest
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+
+        /// true if the flow is in flight
+        bool active;
+    };
+
+    /**
+     * FlowEntry is a flow on the flow list of a link.
+     */
+    struct FlowEntry {
+        /// id of the flow
+        int flow;
+
+        /// index of the link in the route of the flow
+        int hop;
+    };
+
+    /**
+     * Completion is a time a flow is expected to finish streaming at.
+     */
+    struct Completion {
+        /// expected finish time
+        EventTime time;
+
+        /// id of the flow
+        int flow;
+
+        /// version of the flow the completion was computed with
+        uint64_t version;
+
+        /**
+         * Order completions by time, for a min-heap.
+         *
+         * @param other completion to compare with
+         * @return true if this completion comes after the other
+         */
+        bool operator>(const Completion& other) const noexcept {
+            return time > other.time;
+        }
+    };
+
+    /// topology whose routes and links the flows go through
+    std::shared_ptr<Topology> topology;
+
+    /// event queue the flows are simulated on
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// index of each link the flows have gone through
+    std::unordered_map<const Link*, int> link_indices;
+
+    /// capacity of each link in B/ns
+    std::vector<double> link_capacities;
+
+    /// flows on each link
+    std::vector<std::vector<FlowEntry>> link_flows;
+
+    /// true if the flows of the link have changed since the last recomputation
+    std::vector<bool> link_dirty;
+
+    /// links whose flows have changed since the last recomputation
+    std::vector<int> dirty_links;
+
+    /// flows, indexed by id
+    std::vector<Flow> flows;
+
+    /// ids of the finished flows, which are reused by the next flows
+    std::vector<int> free_flows;
+
+    /// number of flows in flight
+    uint64_t active_flows_count;
+
+    /// expected completions, earliest first, including outdated ones
+    std::priority_queue<Completion, std::vector<Completion>, std::greater<>> completions;
+
+    /// earliest time a completion event is scheduled at, or UINT64_MAX
+    EventTime scheduled_completion_time;
+
+    /// true if a recomputation event is scheduled at the current time
+    bool recomputation_scheduled;
+
+    /// number of rate recomputations so far
+    uint64_t recomputations_count;
+
+    /// links connected to the dirty links, during a recomputation
+    std::vector<int> component_links;
+
+    /// flows connected to the dirty links, during a recomputation
+    std::vector<int> component_flows;
+
+    /// mark of the last recomputation each link has been visited by
+    std::vector<uint64_t> link_marks;
+
+    /// mark of the last recomputation each flow has been visited by
+    std::vector<uint64_t> flow_marks;
+
+    /// mark of the current recomputation
+    uint64_t mark;
+
+    /// capacity of each link not assigned to flows yet, during a recomputation
+    std::vector<double> residual_capacities;
+
+    /// number of flows of each link without a rate yet, during a recomputation
+    std::vector<int> unassigned_flows_counts;
+
+    /**
+     * Callback of the recomputation event.
+     *
+     * @param network_ptr pointer to the flow network
+     */
+    static void recompute_rates(void* network_ptr) noexcept;
+
+    /**
+     * Callback of the completion events.
+     *
+     * @param network_ptr pointer to the flow network
+     */
+    static void complete_flows(void* network_ptr) noexcept;
+
+    /**
+     * Resolve the route of a flow from src to dest into the indices of its links and its latency.
+     *
+     * @param flow flow to resolve the route of
+     * @param src src NPU
+     * @param dest dest NPU
+     */
+    void resolve_route(Flow& flow, DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Mark a link dirty, and schedule a recomputation at the current time if none is.
+     *
+     * @param link index of the link
+     */
+    void mark_dirty(int link) noexcept;
+
+    /**
+     * Recompute the max-min fair rates of the flows connected to the dirty links.
+     */
+    void recompute() noexcept;
+
+    /**
+     * Finish a flow which has streamed all of its bytes.
+     *
+     * @param flow_id id of the flow
+     */
+    void finish_flow(int flow_id) noexcept;
+
+    /**
+     * Schedule a completion event at the earliest expected completion, if none is scheduled by then.
+     */
+    void schedule_next_completion() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionFluid
@@ -0,0 +1,93 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/ThreadPool.h"
+#include "common/Type.h"
+#include "congestion_unaware/Topology.h"
+#include <cstdint>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * AllPairsMatrixHeader starts an all-pairs matrix file.
+ *
+ * After the header, the file holds two row-major npus_count x npus_count matrices,
+ * each starting at a 64-byte aligned offset:
+ * the hops counts (uint32_t) and the communication delays (EventTime) of sending a chunk
+ * from the NPU of the row to the NPU of the column (0 on the diagonal).
+ * Every field is in native byte order, so that consumers can memory-map the file and index it directly.
+ */
+struct AllPairsMatrixHeader {
+    /// identifies the file format, all_pairs_matrix_magic
+    char magic[8];
+
+    /// version of the file format, all_pairs_matrix_version
+    uint32_t version;
+
+    /// number of NPUs, i.e., number of rows and columns of each matrix
+    uint32_t npus_count;
+
+    /// size of the chunk sent between every pair of NPUs
+    uint64_t chunk_size;
+
+    /// offset of the hops count matrix from the start of the file, in bytes
+    uint64_t hops_counts_offset;
+
+    /// offset of the communication delay matrix from the start of the file, in bytes
+    uint64_t comm_delays_offset;
+
+    /// reserved, 0
+    uint64_t reserved[3];
+};
+
+static_assert(sizeof(AllPairsMatrixHeader) == 64, "AllPairsMatrixHeader should take 64 bytes");
+
+/// magic of an all-pairs matrix file
+constexpr char all_pairs_matrix_magic[8] = {'N', 'A', 'P', 'A', 'I', 'R', 'S', '\0'};
+
+/// version of the all-pairs matrix file format
+constexpr uint32_t all_pairs_matrix_version = 1;
+
+/**
+ * Compute consecutive rows of the all-pairs hops count and communication delay matrices,
+ * one row per task of the thread pool.
+ *
+ * @param topology topology to send chunks on
+ * @param chunk_size size of the chunk sent between every pair of NPUs
+ * @param first_src src NPU of the first row
+ * @param rows_count number of rows to compute
+ * @param hops_counts output: rows_count x npus_count hops counts, row-major
+ * @param comm_delays output: rows_count x npus_count communication delays, row-major
+ * @param thread_pool thread pool to compute the rows on
+ */
+void compute_all_pairs_rows(const Topology& topology,
+                            ChunkSize chunk_size,
+                            DeviceId first_src,
+                            int rows_count,
+                            uint32_t* hops_counts,
+                            EventTime* comm_delays,
+                            ThreadPool& thread_pool) noexcept;
+
+/**
+ * Compute the all-pairs hops count and communication delay matrices of a topology,
+ * and write them as an all-pairs matrix file (see AllPairsMatrixHeader).
+ * Rows are computed and written block by block, so the whole matrices are never held in memory.
+ *
+ * @param topology topology to send chunks on
+ * @param chunk_size size of the chunk sent between every pair of NPUs
+ * @param output_path path of the file to write
+ * @param threads_count number of threads computing the rows, or 0 to use the number of hardware threads
+ */
+void write_all_pairs_matrix(const Topology& topology,
+                            ChunkSize chunk_size,
+                            const std::string& output_path,
+                            int threads_count = 0) noexcept;
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -12,6 +12,24 @@ using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionUnaware {
 
+/**
+ * HopsCountModel describes the hops count between two NPUs of a BasicTopology in closed form:
+ * constant_hops_count + ring_weight * min(clockwise_distance, ring_length - clockwise_distance),
+ * where clockwise_distance is (dest - src) modulo the number of NPUs.
+ * Batched sends evaluate it without a branch or a virtual call.
+ */
+struct HopsCountModel {
+    /// hops count that doesn't depend on the distance between the NPUs
+    int constant_hops_count;
+
+    /// 1 if the ring distance between the NPUs adds to the hops count, 0 otherwise
+    int ring_weight;
+
+    /// sum of the clockwise and anticlockwise distances:
+    /// the number of NPUs, or twice that if only the clockwise direction can be taken
+    int ring_length;
+};
+
 /**
  * BasicTopology defines 1D topology
  * such as Ring, FullyConnected, and Switch topology,
@@ -38,6 +56,42 @@ class BasicTopology : public Topology {
      */
     [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
 
+    /**
+     * Implement the send_batch method of Topology.
+     */
+    void send_batch(const DeviceId* srcs,
+                    const DeviceId* dests,
+                    const ChunkSize* chunk_sizes,
+                    EventTime* comm_delays,
+                    size_t chunks_count) const noexcept override;
+
+    /**
+     * Implement the get_hops_count method of Topology.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implement the send_row method of Topology.
+     */
+    void send_row(DeviceId src,
+                  ChunkSize chunk_size,
+                  uint32_t* hops_counts,
+                  EventTime* comm_delays) const noexcept override;
+
+    /**
+     * Get the hops count between any two NPUs of the topology in closed form.
+     *
+     * @return hops count model of the topology
+     */
+    [[nodiscard]] virtual HopsCountModel get_hops_count_model() const noexcept = 0;
+
+    /**
+     * Get the latency of each link.
+     *
+     * @return latency of each link in ns
+     */
+    [[nodiscard]] Latency get_latency() const noexcept;
+
     /**
      * Return the type of the basic topology
      * as a TopologyBuildingBlock enum class element.
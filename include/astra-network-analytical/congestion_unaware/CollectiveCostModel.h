@@ -0,0 +1,155 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * CollectiveCostModel estimates the time of collectives in closed form, in O(dims) per query.
+ *
+ * A collective of collective_size bytes (the buffer size of each NPU) runs as a sequence of steps,
+ * each step being a set of sends happening at once.
+ * As the topology is congestion unaware, a step takes as long as its longest send,
+ * which takes (hops count * link latency) + (send size / link bandwidth), as Topology::send.
+ * For a dimension of p NPUs and a buffer of m bytes:
+ *   - Ring: p - 1 steps of m / p to the next NPU for Reduce-Scatter and All-Gather,
+ *     and p - 1 steps of m * (p - i) / p (i = 1, ..., p - 1) for All-to-All.
+ *   - Direct: a single step, where every NPU sends m / p to every other NPU.
+ *   - HalvingDoubling: log2(p) steps, exchanging m / 2, m / 4, ..., m / p with NPUs p / 2, p / 4, ..., 1 apart
+ *     for Reduce-Scatter and All-Gather, and m / 2 with NPUs 1, 2, ..., p / 2 apart for All-to-All (Bruck).
+ *     p should be a power of 2.
+ * An All-Reduce is a Reduce-Scatter followed by an All-Gather.
+ * BinaryTree isn't supported.
+ *
+ * Multi-dimensional collectives are composed hierarchically, from the lowest dimension:
+ * Reduce-Scatter, All-Gather and All-Reduce run on each dimension with the buffer divided by
+ * the number of NPUs of the lower dimensions, while All-to-All runs on each dimension with the whole buffer.
+ */
+class CollectiveCostModel {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology basic topology the collectives run on
+     */
+    explicit CollectiveCostModel(const BasicTopology& topology) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param topology multi-dimensional topology the collectives run on
+     */
+    explicit CollectiveCostModel(const MultiDimTopology& topology) noexcept;
+
+    /**
+     * Construct the model of the topology a NetworkParser describes, as construct_topology would.
+     *
+     * @param network_parser NetworkParser to parse the network input file
+     */
+    explicit CollectiveCostModel(const NetworkParser& network_parser) noexcept;
+
+    /**
+     * Estimate the time of a collective running on every dimension.
+     *
+     * @param collective_type type of the collective
+     * @param algorithm_per_dim algorithm of the collective on each dimension
+     * @param collective_size buffer size of each NPU
+     * @return time for the collective to finish
+     */
+    [[nodiscard]] EventTime get_collective_time(CollectiveType collective_type,
+                                                const std::vector<CollectiveAlgorithm>& algorithm_per_dim,
+                                                ChunkSize collective_size) const noexcept;
+
+    /**
+     * Estimate the time of a collective running on every dimension with the same algorithm.
+     *
+     * @param collective_type type of the collective
+     * @param algorithm algorithm of the collective on every dimension
+     * @param collective_size buffer size of each NPU
+     * @return time for the collective to finish
+     */
+    [[nodiscard]] EventTime get_collective_time(CollectiveType collective_type,
+                                                CollectiveAlgorithm algorithm,
+                                                ChunkSize collective_size) const noexcept;
+
+    /**
+     * Estimate the time of a collective running on a single dimension.
+     *
+     * @param dim dimension the collective runs on
+     * @param collective_type type of the collective
+     * @param algorithm algorithm of the collective
+     * @param collective_size buffer size of each NPU
+     * @return time for the collective to finish
+     */
+    [[nodiscard]] EventTime get_dim_collective_time(int dim,
+                                                    CollectiveType collective_type,
+                                                    CollectiveAlgorithm algorithm,
+                                                    ChunkSize collective_size) const noexcept;
+
+    /**
+     * Get the number of network dimensions.
+     *
+     * @return number of network dimensions
+     */
+    [[nodiscard]] int get_dims_count() const noexcept;
+
+  private:
+    /// number of network dimensions
+    int dims_count;
+
+    /// number of NPUs of each dimension
+    std::vector<int> npus_count_per_dim;
+
+    /// link bandwidth (B/ns) of each dimension
+    std::vector<Bandwidth> bandwidth_Bpns_per_dim;
+
+    /// link latency (ns) of each dimension
+    std::vector<Latency> latency_per_dim;
+
+    /// hops count to the next NPU of each dimension
+    std::vector<int> next_hops_count_per_dim;
+
+    /// hops count to the farthest NPU of each dimension
+    std::vector<int> max_hops_count_per_dim;
+
+    /// log2 of the number of NPUs of each dimension, or -1 if it isn't a power of 2
+    std::vector<int> halving_doubling_steps_count_per_dim;
+
+    /// sum of the hops counts to the NPUs 1, 2, 4, ..., p / 2 apart of each dimension,
+    /// or -1 if its number of NPUs isn't a power of 2
+    std::vector<int> halving_doubling_hops_count_per_dim;
+
+    /**
+     * Add a dimension to the model.
+     *
+     * @param topology basic topology of the dimension
+     */
+    void append_dimension(const BasicTopology& topology) noexcept;
+
+    /**
+     * Estimate the time of a collective running on a single dimension, without truncating it.
+     *
+     * @param dim dimension the collective runs on
+     * @param collective_type type of the collective
+     * @param algorithm algorithm of the collective
+     * @param collective_size buffer size of each NPU
+     * @return time for the collective to finish
+     */
+    [[nodiscard]] double compute_dim_collective_delay(int dim,
+                                                      CollectiveType collective_type,
+                                                      CollectiveAlgorithm algorithm,
+                                                      double collective_size) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -21,4 +21,24 @@ namespace NetworkAnalyticalCongestionUnaware {
  */
 [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
 
+/**
+ * Construct the StaticMultiDimTopology instantiation matching a NetworkParser, if there's one.
+ * Its sends yield the same delays as the topology of construct_topology, without a virtual call per chunk in batches.
+ *
+ * @param network_parser NetworkParser to parse the network input file
+ * @return pointer to the constructed topology, nullptr if no instantiation matches
+ */
+[[nodiscard]] std::shared_ptr<Topology> construct_static_topology(const NetworkParser& network_parser) noexcept;
+
+/**
+ * Construct a topology from a NetworkParser,
+ * and estimate the time for an All-to-All where every NPU sends a chunk to every other NPU at once.
+ * As the topology is congestion unaware, this is the longest of the individual sends.
+ *
+ * @param network_parser NetworkParser to parse the network input file
+ * @param chunk_size size of the chunk each NPU sends to every other NPU
+ * @return time for the All-to-All to finish
+ */
+[[nodiscard]] EventTime simulate_all_to_all(const NetworkParser& network_parser, ChunkSize chunk_size) noexcept;
+
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -5,9 +5,11 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/FastDivisor.h"
 #include "common/Type.h"
 #include "congestion_unaware/BasicTopology.h"
 #include "congestion_unaware/Topology.h"
+#include <array>
 #include <memory>
 
 using namespace NetworkAnalytical;
@@ -30,6 +32,38 @@ class MultiDimTopology : public Topology {
      */
     [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
 
+    /**
+     * Implement the send_batch method of Topology.
+     */
+    void send_batch(const DeviceId* srcs,
+                    const DeviceId* dests,
+                    const ChunkSize* chunk_sizes,
+                    EventTime* comm_delays,
+                    size_t chunks_count) const noexcept override;
+
+    /**
+     * Implement the get_hops_count method of Topology.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implement the send_row method of Topology.
+     * The NPUs reached through the same dimension and the same address in it share a delay,
+     * so each group is computed once and filled in, without per-NPU address translation.
+     */
+    void send_row(DeviceId src,
+                  ChunkSize chunk_size,
+                  uint32_t* hops_counts,
+                  EventTime* comm_delays) const noexcept override;
+
+    /**
+     * Get the BasicTopology of a dimension.
+     *
+     * @param dim dimension
+     * @return BasicTopology instance of the dimension
+     */
+    [[nodiscard]] const BasicTopology& get_basic_topology(int dim) const noexcept;
+
     /**
      * Add a dimension to the multi-dimensional topology.
      *
@@ -37,14 +71,14 @@ class MultiDimTopology : public Topology {
      */
     void append_dimension(std::unique_ptr<BasicTopology> basic_topology) noexcept;
 
-  private:
+    /// maximum number of dimensions of a multi-dimensional topology
+    static constexpr int max_dims_count = 8;
+
     /// Each NPU ID can be broken down into multiple dimensions.
     /// for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
     /// then the NPU ID can be broken down into [1, 7, 1].
-    using MultiDimAddress = std::vector<DeviceId>;
-
-    /// BasicTopology instances per dimension.
-    std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
+    /// Addresses are stored inline: only the first dims_count entries are used.
+    using MultiDimAddress = std::array<DeviceId, max_dims_count>;
 
     /**
      * Translate the NPU ID into a multi-dimensional address.
@@ -54,17 +88,45 @@ class MultiDimTopology : public Topology {
      */
     [[nodiscard]] MultiDimAddress translate_address(DeviceId npu_id) const noexcept;
 
+  private:
+    /// BasicTopology instances per dimension.
+    std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
+
+    /// divides by the number of NPUs of each dimension
+    std::vector<FastDivisor> npus_count_divisor_per_dim;
+
+    /// divides by the stride of each dimension: the number of NPUs between two consecutive addresses,
+    /// i.e., the product of the sizes of the lower dimensions
+    std::vector<FastDivisor> stride_divisor_per_dim;
+
+    /// hops count model of each dimension, so that batched sends don't go through the BasicTopology instances
+    std::vector<HopsCountModel> hops_count_model_per_dim;
+
+    /// link latency (ns) of each dimension
+    std::vector<Latency> latency_per_dim;
+
+    /// link bandwidth (B/ns) of each dimension
+    std::vector<Bandwidth> bandwidth_Bpns_per_dim;
+
+    /**
+     * Get the address of an NPU in a single dimension.
+     *
+     * @param npu_id id of the NPU
+     * @param dim dimension of the address
+     * @return address of the NPU in the dimension
+     */
+    [[nodiscard]] DeviceId translate_address(DeviceId npu_id, int dim) const noexcept;
+
     /**
-     * Given src and dest address in multi-dimensional form,
-     * return the dimension where the transfer should happen.
-     * i.e., the dimension where the src and dest addresses differ.
+     * Given src and dest NPU IDs, return the dimension where the transfer should happen.
+     * i.e., the lowest dimension where the src and dest addresses differ.
+     * Only the lower dimensions are translated, until the addresses differ.
      *
-     * @param src_address src NPU ID in multi-dimensional form
-     * @param dest_address dest NPU ID in multi-dimensional form
+     * @param src src NPU ID
+     * @param dest dest NPU ID
      * @return the dimension where the transfer should happen
      */
-    [[nodiscard]] int get_dim_to_transfer(const MultiDimAddress& src_address,
-                                          const MultiDimAddress& dest_address) const noexcept;
+    [[nodiscard]] int get_dim_to_transfer(DeviceId src, DeviceId dest) const noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -0,0 +1,175 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * PhaseContentionModel estimates a communication phase, i.e., a set of concurrent transfers,
+ * accounting for the transfers sharing links, without any event queue.
+ *
+ * Each transfer goes through the dimension Topology::send would send it through,
+ * over the links that dimension would take:
+ *   - Ring: the ring segments from src to dest, clockwise unless anticlockwise is shorter.
+ *   - FullyConnected: the dedicated link from src to dest.
+ *   - Switch: the uplink port of src, then the downlink port of dest.
+ * The load (bytes and number of transfers) of every link is accumulated first.
+ * Then, each transfer is served a fair share of each of its links:
+ * on a link carrying load bytes over n transfers, a transfer of size bytes is delayed by min(load, n * size) bytes,
+ * i.e., it shares the link equally, and never waits for more than the whole load.
+ * A transfer takes (hops count * link latency) + (bytes of its bottleneck link / link bandwidth),
+ * so a transfer without any contention takes exactly as long as Topology::send.
+ *
+ * A phase costs O(transfers * hops).
+ * Ring and Switch links are held densely (two per NPU and dimension),
+ * while FullyConnected links, N per NPU, are only held while a phase loads them.
+ */
+class PhaseContentionModel {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology basic topology the phases run on
+     */
+    explicit PhaseContentionModel(const BasicTopology& topology) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param topology multi-dimensional topology the phases run on
+     */
+    explicit PhaseContentionModel(const MultiDimTopology& topology) noexcept;
+
+    /**
+     * Construct the model of the topology a NetworkParser describes, as construct_topology would.
+     *
+     * @param network_parser NetworkParser to parse the network input file
+     */
+    explicit PhaseContentionModel(const NetworkParser& network_parser) noexcept;
+
+    /**
+     * Estimate a phase of concurrent transfers, given as structure-of-arrays:
+     * the i-th transfer of size transfer_sizes[i] is sent from srcs[i] to dests[i],
+     * and its communication delay under contention is written to comm_delays[i].
+     *
+     * @param srcs src NPU ID of each transfer
+     * @param dests dest NPU ID of each transfer
+     * @param transfer_sizes size of each transfer
+     * @param comm_delays output: time for each transfer to arrive, from the start of the phase
+     * @param transfers_count number of transfers in the phase
+     * @return time for the phase to finish, i.e., the longest communication delay
+     */
+    EventTime estimate_phase(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             const ChunkSize* transfer_sizes,
+                             EventTime* comm_delays,
+                             size_t transfers_count) noexcept;
+
+    /**
+     * Get the number of links the model holds the load of between phases,
+     * i.e., the Ring and Switch links, as FullyConnected links are only held during a phase.
+     *
+     * @return number of links held
+     */
+    [[nodiscard]] size_t get_links_count() const noexcept;
+
+  private:
+    /// number of NPUs
+    int npus_count;
+
+    /// number of network dimensions
+    int dims_count;
+
+    /// number of NPUs of each dimension
+    std::vector<int> npus_count_per_dim;
+
+    /// number of NPUs between two consecutive addresses of each dimension
+    std::vector<int> stride_per_dim;
+
+    /// building block of each dimension
+    std::vector<TopologyBuildingBlock> topology_type_per_dim;
+
+    /// true if the ring of each dimension is bidirectional (Ring only)
+    std::vector<bool> bidirectional_per_dim;
+
+    /// link bandwidth (B/ns) of each dimension
+    std::vector<Bandwidth> bandwidth_Bpns_per_dim;
+
+    /// link latency (ns) of each dimension
+    std::vector<Latency> latency_per_dim;
+
+    /// index of the first link of each dimension,
+    /// where the FullyConnected links are numbered after every densely held link
+    std::vector<size_t> first_link_per_dim;
+
+    /// number of densely held links, i.e., the Ring and Switch links
+    size_t dense_links_count;
+
+    /// slot of each FullyConnected link loaded in the current phase, map[link] -> slot
+    std::unordered_map<size_t, size_t> sparse_link_slots;
+
+    /// bytes to go through each link slot in the current phase
+    std::vector<double> link_loads;
+
+    /// number of transfers going through each link slot in the current phase
+    std::vector<uint32_t> link_transfers_counts;
+
+    /// link slots loaded in the current phase, to be cleared after it
+    std::vector<size_t> loaded_links;
+
+    /**
+     * Add a dimension to the model.
+     *
+     * @param topology basic topology of the dimension
+     */
+    void append_dimension(const BasicTopology& topology) noexcept;
+
+    /**
+     * Lay out the links of every dimension, once every dimension has been added.
+     */
+    void allocate_links() noexcept;
+
+    /**
+     * Get the slot holding the load of a link, taking one for a FullyConnected link on its first load in the phase.
+     *
+     * @param link index of the link
+     * @return slot of the link in link_loads and link_transfers_counts
+     */
+    [[nodiscard]] size_t link_slot(size_t link) noexcept;
+
+    /**
+     * Get the dimension a transfer goes through, as Topology::send would.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @return the lowest dimension where the src and dest addresses differ
+     */
+    [[nodiscard]] int get_dim_to_transfer(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Invoke a function on every link from src to dest.
+     *
+     * @param dim dimension of the transfer
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @param visit function invoked with the index of each link
+     */
+    template <typename Visit>
+    void for_each_link(int dim, DeviceId src, DeviceId dest, Visit&& visit) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -39,6 +39,11 @@ class Ring final : public BasicTopology {
      */
     Ring(int npus_count, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
 
+    /**
+     * Implements the get_hops_count_model method of BasicTopology.
+     */
+    [[nodiscard]] HopsCountModel get_hops_count_model() const noexcept override;
+
   private:
     /**
      * Implements the compute_hops_count method of BasicTopology.
@@ -0,0 +1,375 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/FastDivisor.h"
+#include "common/NetworkFunction.h"
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_unaware/FullyConnected.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/Switch.h"
+#include "congestion_unaware/Topology.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <tuple>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * StaticBasicTopology computes the hops count of a BasicTopology type at compile time,
+ * so that StaticMultiDimTopology can inline it.
+ *
+ * @tparam BasicTopologyType Ring, FullyConnected, or Switch
+ */
+template <typename BasicTopologyType> struct StaticBasicTopology;
+
+/**
+ * Hops count of a (bidirectional) Ring, as constructed by construct_topology.
+ */
+template <> struct StaticBasicTopology<Ring> {
+    /// building block of the dimension
+    static constexpr TopologyBuildingBlock basic_topology_type = TopologyBuildingBlock::Ring;
+
+    /**
+     * Compute the number of hops between src and dest.
+     *
+     * @param src src NPU ID in the dimension
+     * @param dest dest NPU ID in the dimension
+     * @param npus_count number of NPUs in the dimension
+     * @return number of hops between src and dest
+     */
+    [[nodiscard]] static int compute_hops_count(const DeviceId src,
+                                                const DeviceId dest,
+                                                const int npus_count) noexcept {
+        // shorter of the clockwise and anticlockwise distances
+        auto clockwise_distance = dest - src;
+        clockwise_distance += (clockwise_distance < 0) ? npus_count : 0;
+        return std::min(clockwise_distance, npus_count - clockwise_distance);
+    }
+};
+
+/**
+ * Hops count of a FullyConnected topology.
+ */
+template <> struct StaticBasicTopology<FullyConnected> {
+    /// building block of the dimension
+    static constexpr TopologyBuildingBlock basic_topology_type = TopologyBuildingBlock::FullyConnected;
+
+    /**
+     * Compute the number of hops between src and dest.
+     *
+     * @return number of hops between src and dest
+     */
+    [[nodiscard]] static int compute_hops_count(DeviceId, DeviceId, int) noexcept {
+        // src -> dest
+        return 1;
+    }
+};
+
+/**
+ * Hops count of a Switch topology.
+ */
+template <> struct StaticBasicTopology<Switch> {
+    /// building block of the dimension
+    static constexpr TopologyBuildingBlock basic_topology_type = TopologyBuildingBlock::Switch;
+
+    /**
+     * Compute the number of hops between src and dest.
+     *
+     * @return number of hops between src and dest
+     */
+    [[nodiscard]] static int compute_hops_count(DeviceId, DeviceId, int) noexcept {
+        // src -> switch -> dest
+        return 2;
+    }
+};
+
+/**
+ * StaticMultiDimTopology is a MultiDimTopology whose dimension types are template parameters,
+ * e.g., StaticMultiDimTopology<Ring, FullyConnected, Switch>.
+ * Its send is fully inlined: there is no virtual call nor heap allocation per chunk,
+ * and the delays are exactly the same as the MultiDimTopology of the same shape.
+ *
+ * @tparam BasicTopologies type of each dimension, from the lowest one
+ */
+template <typename... BasicTopologies> class StaticMultiDimTopology final : public Topology {
+  public:
+    /// number of dimensions
+    static constexpr int static_dims_count = static_cast<int>(sizeof...(BasicTopologies));
+    static_assert(static_dims_count > 0, "StaticMultiDimTopology should have at least one dimension");
+
+    /**
+     * Constructor.
+     *
+     * @param npus_count_per_dim number of NPUs of each dimension
+     * @param bandwidth_per_dim link bandwidth (GB/s) of each dimension
+     * @param latency_per_dim link latency (ns) of each dimension
+     */
+    StaticMultiDimTopology(const std::array<int, static_dims_count>& npus_count_per_dim,
+                           const std::array<Bandwidth, static_dims_count>& bandwidth_per_dim,
+                           const std::array<Latency, static_dims_count>& latency_per_dim) noexcept
+        : Topology(),
+          npus_count_of_dim(npus_count_per_dim),
+          npus_count_divisor_per_dim(
+              make_divisors(npus_count_per_dim, std::make_index_sequence<sizeof...(BasicTopologies)>())),
+          latency_per_dim(latency_per_dim) {
+        // set topology shape
+        npus_count = 1;
+        dims_count = static_dims_count;
+        for (auto dim = 0; dim < static_dims_count; dim++) {
+            assert(npus_count_per_dim[dim] > 0);
+            assert(bandwidth_per_dim[dim] > 0);
+            assert(latency_per_dim[dim] >= 0);
+
+            npus_count *= npus_count_per_dim[dim];
+            this->npus_count_per_dim.push_back(npus_count_per_dim[dim]);
+            this->bandwidth_per_dim.push_back(bandwidth_per_dim[dim]);
+
+            // translate bandwidth from GB/s to B/ns
+            bandwidth_Bpns_per_dim[dim] = bw_GBps_to_Bpns(bandwidth_per_dim[dim]);
+        }
+    }
+
+    /**
+     * Construct the topology from a NetworkParser whose topology types match the dimension types.
+     *
+     * @param network_parser NetworkParser to parse the network input file
+     */
+    explicit StaticMultiDimTopology(const NetworkParser& network_parser) noexcept
+        : StaticMultiDimTopology(to_array(network_parser.get_npus_counts_per_dim()),
+                                 to_array(network_parser.get_bandwidths_per_dim()),
+                                 to_array(network_parser.get_latencies_per_dim())) {
+        assert(matches(network_parser));
+    }
+
+    /**
+     * Check whether the topology types of a NetworkParser match the dimension types.
+     *
+     * @param network_parser NetworkParser to parse the network input file
+     * @return true if the topology types match, false otherwise
+     */
+    [[nodiscard]] static bool matches(const NetworkParser& network_parser) noexcept {
+        const auto topologies_per_dim = network_parser.get_topologies_per_dim();
+        const auto basic_topology_types = std::array<TopologyBuildingBlock, static_dims_count>{
+            StaticBasicTopology<BasicTopologies>::basic_topology_type...};
+
+        return std::equal(topologies_per_dim.begin(), topologies_per_dim.end(), basic_topology_types.begin(),
+                          basic_topology_types.end());
+    }
+
+    /**
+     * Implement the send method of Topology.
+     */
+    [[nodiscard]] EventTime send(const DeviceId src,
+                                 const DeviceId dest,
+                                 const ChunkSize chunk_size) const noexcept override {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+        assert(chunk_size > 0);
+
+        return send_from_dim<0>(src, dest, chunk_size);
+    }
+
+    /**
+     * Implement the get_hops_count method of Topology.
+     */
+    [[nodiscard]] int get_hops_count(const DeviceId src, const DeviceId dest) const noexcept override {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+
+        return hops_count_from_dim<0>(src, dest);
+    }
+
+    /**
+     * Implement the send_batch method of Topology.
+     */
+    void send_batch(const DeviceId* const srcs,
+                    const DeviceId* const dests,
+                    const ChunkSize* const chunk_sizes,
+                    EventTime* const comm_delays,
+                    const size_t chunks_count) const noexcept override {
+        assert(chunks_count == 0 || (srcs != nullptr && dests != nullptr));
+        assert(chunks_count == 0 || (chunk_sizes != nullptr && comm_delays != nullptr));
+
+        for (auto i = static_cast<size_t>(0); i < chunks_count; i++) {
+            assert(0 <= srcs[i] && srcs[i] < npus_count);
+            assert(0 <= dests[i] && dests[i] < npus_count);
+            assert(chunk_sizes[i] > 0);
+
+            comm_delays[i] = send_from_dim<0>(srcs[i], dests[i], chunk_sizes[i]);
+        }
+    }
+
+  private:
+    /// number of NPUs of each dimension
+    std::array<int, static_dims_count> npus_count_of_dim;
+
+    /// divides by the number of NPUs of each dimension
+    std::array<FastDivisor, static_dims_count> npus_count_divisor_per_dim;
+
+    /// link latency (ns) of each dimension
+    std::array<Latency, static_dims_count> latency_per_dim;
+
+    /// link bandwidth (B/ns) of each dimension
+    std::array<Bandwidth, static_dims_count> bandwidth_Bpns_per_dim;
+
+    /**
+     * Send a chunk through the lowest dimension, at or above Dim, where the src and dest addresses differ.
+     *
+     * @tparam Dim dimension to check
+     * @param src_leftover src NPU ID, with the addresses of the dimensions below Dim peeled off
+     * @param dest_leftover dest NPU ID, with the addresses of the dimensions below Dim peeled off
+     * @param chunk_size size of the chunk
+     * @return time to send the chunk from src to dest
+     */
+    template <int Dim>
+    [[nodiscard]] EventTime send_from_dim(const DeviceId src_leftover,
+                                          const DeviceId dest_leftover,
+                                          const ChunkSize chunk_size) const noexcept {
+        if constexpr (Dim == static_dims_count) {
+            // shouldn't reach here
+            std::cerr << "[Error] (network/analytical/congestion_unaware): " << "src and dest have the same address"
+                      << std::endl;
+            std::exit(-1);
+        } else {
+            // translate the addresses of the dimension
+            const auto src_quotient = npus_count_divisor_per_dim[Dim].divide(src_leftover);
+            const auto dest_quotient = npus_count_divisor_per_dim[Dim].divide(dest_leftover);
+            const auto src_address = src_leftover - (src_quotient * npus_count_of_dim[Dim]);
+            const auto dest_address = dest_leftover - (dest_quotient * npus_count_of_dim[Dim]);
+
+            // same address: the transfer happens in a higher dimension
+            if (src_address == dest_address) {
+                return send_from_dim<Dim + 1>(src_quotient, dest_quotient, chunk_size);
+            }
+
+            // same delay as the BasicTopology of the dimension
+            using DimTopology = std::tuple_element_t<Dim, std::tuple<BasicTopologies...>>;
+            const auto hops_count =
+                StaticBasicTopology<DimTopology>::compute_hops_count(src_address, dest_address, npus_count_of_dim[Dim]);
+            const auto link_delay = hops_count * latency_per_dim[Dim];
+            const auto serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bpns_per_dim[Dim];
+            return static_cast<EventTime>(link_delay + serialization_delay);
+        }
+    }
+
+    /**
+     * Get the hops count in the lowest dimension, at or above Dim, where the src and dest addresses differ.
+     *
+     * @tparam Dim dimension to check
+     * @param src_leftover src NPU ID, with the addresses of the dimensions below Dim peeled off
+     * @param dest_leftover dest NPU ID, with the addresses of the dimensions below Dim peeled off
+     * @return number of hops between src and dest
+     */
+    template <int Dim>
+    [[nodiscard]] int hops_count_from_dim(const DeviceId src_leftover, const DeviceId dest_leftover) const noexcept {
+        if constexpr (Dim == static_dims_count) {
+            // shouldn't reach here
+            std::cerr << "[Error] (network/analytical/congestion_unaware): " << "src and dest have the same address"
+                      << std::endl;
+            std::exit(-1);
+        } else {
+            // translate the addresses of the dimension
+            const auto src_quotient = npus_count_divisor_per_dim[Dim].divide(src_leftover);
+            const auto dest_quotient = npus_count_divisor_per_dim[Dim].divide(dest_leftover);
+            const auto src_address = src_leftover - (src_quotient * npus_count_of_dim[Dim]);
+            const auto dest_address = dest_leftover - (dest_quotient * npus_count_of_dim[Dim]);
+
+            // same address: the transfer happens in a higher dimension
+            if (src_address == dest_address) {
+                return hops_count_from_dim<Dim + 1>(src_quotient, dest_quotient);
+            }
+
+            using DimTopology = std::tuple_element_t<Dim, std::tuple<BasicTopologies...>>;
+            return StaticBasicTopology<DimTopology>::compute_hops_count(src_address, dest_address,
+                                                                        npus_count_of_dim[Dim]);
+        }
+    }
+
+    /**
+     * Create the divisors of each dimension.
+     *
+     * @param npus_count_per_dim number of NPUs of each dimension
+     * @return divisor of each dimension
+     */
+    template <size_t... Dims>
+    [[nodiscard]] static std::array<FastDivisor, static_dims_count> make_divisors(
+        const std::array<int, static_dims_count>& npus_count_per_dim,
+        std::index_sequence<Dims...>) noexcept {
+        return {FastDivisor(npus_count_per_dim[Dims])...};
+    }
+
+    /**
+     * Copy a per-dimension vector into an array.
+     *
+     * @tparam T type of the elements
+     * @param vector per-dimension vector, of static_dims_count elements
+     * @return array of the elements
+     */
+    template <typename T>
+    [[nodiscard]] static std::array<T, static_dims_count> to_array(const std::vector<T>& vector) noexcept {
+        assert(vector.size() == static_dims_count);
+
+        auto array = std::array<T, static_dims_count>();
+        std::copy(vector.begin(), vector.end(), array.begin());
+        return array;
+    }
+};
+
+/// maximum number of dimensions visit_static_topology instantiates
+constexpr int max_static_dims_count = 3;
+
+/**
+ * Construct the StaticMultiDimTopology matching a NetworkParser config, and invoke a visitor with it.
+ * Every combination of Ring, FullyConnected, and Switch up to max_static_dims_count dimensions is instantiated,
+ * so that the visitor runs its loops on the concrete type, with send fully inlined.
+ *
+ * @tparam BasicTopologies dimension types matched so far (internal)
+ * @param network_parser NetworkParser to parse the network input file
+ * @param visitor callable invoked with a const reference to the constructed topology
+ * @return true if an instantiation matched and the visitor was invoked, false otherwise
+ */
+template <typename... BasicTopologies, typename Visitor>
+bool visit_static_topology(const NetworkParser& network_parser, Visitor&& visitor) noexcept {
+    constexpr auto dim = static_cast<int>(sizeof...(BasicTopologies));
+
+    // every dimension is matched
+    if constexpr (dim > 0) {
+        if (dim == network_parser.get_dims_count()) {
+            const auto topology = StaticMultiDimTopology<BasicTopologies...>(network_parser);
+            visitor(topology);
+            return true;
+        }
+    }
+
+    // match the next dimension
+    if constexpr (dim < max_static_dims_count) {
+        if (dim < network_parser.get_dims_count()) {
+            switch (network_parser.get_topologies_per_dim()[dim]) {
+            case TopologyBuildingBlock::Ring:
+                return visit_static_topology<BasicTopologies..., Ring>(network_parser, visitor);
+            case TopologyBuildingBlock::FullyConnected:
+                return visit_static_topology<BasicTopologies..., FullyConnected>(network_parser, visitor);
+            case TopologyBuildingBlock::Switch:
+                return visit_static_topology<BasicTopologies..., Switch>(network_parser, visitor);
+            default:
+                return false;
+            }
+        }
+    }
+
+    // too many dimensions
+    return false;
+}
+
+}  // namespace NetworkAnalyticalCongestionUnaware
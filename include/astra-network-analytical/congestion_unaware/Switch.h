@@ -35,6 +35,11 @@ class Switch final : public BasicTopology {
      */
     Switch(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
+    /**
+     * Implements the get_hops_count_model method of BasicTopology.
+     */
+    [[nodiscard]] HopsCountModel get_hops_count_model() const noexcept override;
+
   private:
     /**
      * Implements the compute_hops_count method of BasicTopology.
@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -33,6 +35,48 @@ class Topology {
      */
     [[nodiscard]] virtual EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept = 0;
 
+    /**
+     * Estimate the time to be taken to transmit a batch of chunks,
+     * given as structure-of-arrays: the i-th chunk of size chunk_sizes[i] is sent from srcs[i] to dests[i],
+     * and its communication delay is written to comm_delays[i].
+     * Yields the same delays as calling send on every chunk, but topologies override it
+     * to process the whole batch without a virtual call per chunk.
+     *
+     * @param srcs src NPU ID of each chunk
+     * @param dests dest NPU ID of each chunk
+     * @param chunk_sizes size of each chunk
+     * @param comm_delays output: time to send each chunk from its src to its dest
+     * @param chunks_count number of chunks in the batch
+     */
+    virtual void send_batch(const DeviceId* srcs,
+                            const DeviceId* dests,
+                            const ChunkSize* chunk_sizes,
+                            EventTime* comm_delays,
+                            size_t chunks_count) const noexcept;
+
+    /**
+     * Get the number of hops a chunk takes from src NPU to dest NPU.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @return number of hops between src and dest
+     */
+    [[nodiscard]] virtual int get_hops_count(DeviceId src, DeviceId dest) const noexcept = 0;
+
+    /**
+     * Estimate sending a chunk from src NPU to every NPU, i.e., a row of the all-pairs matrices.
+     * The entries of src itself are 0.
+     *
+     * @param src src NPU ID
+     * @param chunk_size size of the chunk to send
+     * @param hops_counts output: number of hops to each NPU, with one entry per NPU
+     * @param comm_delays output: time to send the chunk to each NPU, with one entry per NPU
+     */
+    virtual void send_row(DeviceId src,
+                          ChunkSize chunk_size,
+                          uint32_t* hops_counts,
+                          EventTime* comm_delays) const noexcept;
+
     /**
      * Get the number of NPUs in the topology.
      *
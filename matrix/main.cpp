@@ -0,0 +1,45 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkParser.h"
+#include "congestion_unaware/AllPairsMatrix.h"
+#include "congestion_unaware/Helper.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+int main(int argc, char* argv[]) {
+    // parse arguments
+    if (argc < 4 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <network.yml> <chunk_size> <output.bin> [threads]" << std::endl;
+        return -1;
+    }
+    const auto network_path = std::string(argv[1]);
+    const auto chunk_size = static_cast<ChunkSize>(std::strtoull(argv[2], nullptr, 10));
+    const auto output_path = std::string(argv[3]);
+    const auto threads_count = (argc == 5) ? std::atoi(argv[4]) : 0;
+    if (chunk_size == 0) {
+        std::cerr << "[Error] (network/analytical) " << "chunk_size should be positive" << std::endl;
+        return -1;
+    }
+
+    // create the topology
+    const auto network_parser = NetworkParser(network_path);
+    const auto topology = construct_topology(network_parser);
+    std::cout << "NPUs Count: " << topology->get_npus_count() << std::endl;
+
+    // compute and write the matrices
+    const auto start = std::chrono::steady_clock::now();
+    write_all_pairs_matrix(*topology, chunk_size, output_path, threads_count);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Matrices written to " << output_path << " in " << elapsed << " s" << std::endl;
+
+    // terminate
+    return 0;
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_aware/TimelineEngine.h"
+#include "congestion_aware/TraceReplay.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+int main(int argc, char* argv[]) {
+    // parse arguments
+    // --timeline computes the timeline without an event queue, with identical results
+    const auto timeline = (argc == 4 && std::string(argv[3]) == "--timeline");
+    if (argc != 3 && !timeline) {
+        std::cerr << "Usage: " << argv[0] << " <network.yml> <trace.bin> [--timeline]" << std::endl;
+        return -1;
+    }
+    const auto network_path = std::string(argv[1]);
+    const auto trace_path = std::string(argv[2]);
+
+    // create the topology
+    const auto network_parser = NetworkParser(network_path);
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(std::make_shared<EventQueue>());
+    topology->set_link_mode(LinkMode::BusyUntil);
+    std::cout << "NPUs Count: " << topology->get_npus_count() << std::endl;
+
+    // replay the trace
+    const auto start = std::chrono::steady_clock::now();
+    auto report = TraceReplayReport();
+    if (timeline) {
+        auto timeline_engine = TimelineEngine(topology);
+        report = timeline_engine.run(trace_path);
+    } else {
+        auto trace_replay = TraceReplay(topology);
+        report = trace_replay.run(trace_path);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // print the report
+    std::cout << "Replayed Sends: " << report.sends_count << std::endl;
+    std::cout << "Finish Time: " << report.finish_time << " ns" << std::endl;
+    std::cout << "Mean Send Delay: " << report.mean_send_delay << " ns" << std::endl;
+    std::cout << "Max Send Delay: " << report.max_send_delay << " ns" << std::endl;
+    std::cout << "Peak In-Flight Sends: " << report.peak_in_flight_sends_count << std::endl;
+    std::cout << "Peak Resident Memory: " << report.peak_resident_memory_KB << " KB" << std::endl;
+    std::cout << "Replayed in " << elapsed << " s" << std::endl;
+
+    // terminate
+    return 0;
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkParser.h"
+#include "common/SweepRunner.h"
+#include "common/SweepSpec.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_unaware/Helper.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+int main(int argc, char* argv[]) {
+    // parse arguments
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <sweep.yml> <output.csv> [threads]" << std::endl;
+        return -1;
+    }
+    const auto sweep_spec_path = std::string(argv[1]);
+    const auto output_path = std::string(argv[2]);
+    const auto threads_count = (argc == 4) ? std::atoi(argv[3]) : 0;
+
+    // load the sweep spec
+    const auto sweep_spec = SweepSpec(sweep_spec_path);
+    const auto chunk_size = sweep_spec.get_chunk_size();
+    std::cout << "Sweep Points Count: " << sweep_spec.get_points_count() << std::endl;
+
+    // register backends
+    auto sweep_runner = SweepRunner(sweep_spec, threads_count);
+    sweep_runner.register_backend(
+        "congestion_unaware",
+        [](const NetworkParser& network_parser, const ChunkSize chunk_size) -> std::optional<EventTime> {
+            return NetworkAnalyticalCongestionUnaware::simulate_all_to_all(network_parser, chunk_size);
+        });
+    sweep_runner.register_backend(
+        "congestion_aware",
+        [](const NetworkParser& network_parser, const ChunkSize chunk_size) -> std::optional<EventTime> {
+            return NetworkAnalyticalCongestionAware::simulate_all_to_all(network_parser, chunk_size);
+        });
+
+    // run the sweep
+    const auto results = sweep_runner.run();
+
+    // write the results
+    auto output = std::ofstream(output_path);
+    if (!output.is_open()) {
+        std::cerr << "[Error] (network/analytical) " << "failed to open " << output_path << std::endl;
+        return -1;
+    }
+    SweepRunner::write_csv(results, chunk_size, output);
+    std::cout << "Results written to " << output_path << std::endl;
+
+    // terminate
+    return 0;
+}
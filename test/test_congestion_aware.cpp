@@ -5,10 +5,29 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/EventQueue.h"
 #include "common/NetworkParser.h"
+#include "common/SweepRunner.h"
+#include "common/SweepSpec.h"
 #include "common/Type.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/CollectiveEngine.h"
+#include "congestion_aware/CollectiveSchedule.h"
+#include "congestion_aware/CollectiveScheduleRunner.h"
+#include "congestion_aware/FullyConnected.h"
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/MultiDimTopology.h"
+#include "congestion_aware/ParallelSimulation.h"
+#include "congestion_aware/Ring.h"
+#include "congestion_aware/Switch.h"
+#include "congestion_aware/TimelineEngine.h"
+#include "congestion_aware/TraceReplay.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
@@ -16,9 +35,8 @@ using namespace NetworkAnalyticalCongestionAware;
 class TestNetworkAnalyticalCongestionAware : public ::testing::Test {
   protected:
     void SetUp() override {
-        // set event queue
+        // create event queue
         event_queue = std::make_shared<EventQueue>();
-        Topology::set_event_queue(event_queue);
 
         // set chunk size
         chunk_size = 1'048'576;  // 1 MB
@@ -35,6 +53,7 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Ring) {
     /// setup
     const auto network_parser = NetworkParser("../../input/Ring.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
 
     /// message settings
     auto route = topology->route(1, 4);
@@ -57,6 +76,7 @@ TEST_F(TestNetworkAnalyticalCongestionAware, FullyConnected) {
     /// setup
     const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
 
     /// message settings
     auto route = topology->route(1, 4);
@@ -79,6 +99,7 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Switch) {
     /// setup
     const auto network_parser = NetworkParser("../../input/Switch.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
 
     /// message settings
     auto route = topology->route(1, 4);
@@ -97,10 +118,86 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Switch) {
     EXPECT_EQ(simulation_time, 40'062);
 }
 
+TEST_F(TestNetworkAnalyticalCongestionAware, MultiDimTopology) {
+    /// setup: 2 x 8 x 4 NPUs, with 16 switches in the last dimension
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    EXPECT_EQ(topology->get_npus_count(), 64);
+    EXPECT_EQ(topology->get_devices_count(), 80);
+
+    /// only the neighbors of each dimension are connected
+    EXPECT_EQ(topology->get_links_count(), (32 * 2) + (64 * 7) + (64 * 2));
+
+    /// dimension-order routing: 0 = [0, 0, 0] -> 1 = [1, 0, 0] -> 15 = [1, 7, 0] -> switch -> 63 = [1, 7, 3]
+    auto route = topology->route(0, 63);
+    auto route_ids = std::vector<DeviceId>();
+    for (const auto& device : route) {
+        route_ids.push_back(device->get_id());
+    }
+    EXPECT_EQ(route_ids, (std::vector<DeviceId>{0, 1, 15, 64 + 15, 63}));
+
+    // send a chunk
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 58'259);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, MultiDimTopologyMatchesBasicTopology) {
+    /// a single-dimension MultiDimTopology should behave exactly like its basic topology
+    const auto basic_topologies = std::vector<std::pair<TopologyBuildingBlock, std::shared_ptr<Topology>>>{
+        {TopologyBuildingBlock::Ring, std::make_shared<Ring>(8, 50.0, 500.0)},
+        {TopologyBuildingBlock::FullyConnected, std::make_shared<FullyConnected>(8, 50.0, 500.0)},
+        {TopologyBuildingBlock::Switch, std::make_shared<Switch>(8, 50.0, 500.0)},
+    };
+
+    for (const auto& [topology_type, basic_topology] : basic_topologies) {
+        const auto multi_dim_topology = std::make_shared<MultiDimTopology>(
+            std::vector<TopologyBuildingBlock>{topology_type}, std::vector<int>{8}, std::vector<Bandwidth>{50.0},
+            std::vector<Latency>{500.0});
+        EXPECT_EQ(multi_dim_topology->get_devices_count(), basic_topology->get_devices_count());
+        EXPECT_EQ(multi_dim_topology->get_links_count(), basic_topology->get_links_count());
+
+        /// Run All-to-All on both topologies
+        auto simulation_times = std::vector<EventTime>();
+        for (const auto& topology : {basic_topology, std::static_pointer_cast<Topology>(multi_dim_topology)}) {
+            event_queue = std::make_shared<EventQueue>();
+            topology->set_event_queue(event_queue);
+
+            for (int i = 0; i < 8; i++) {
+                for (int j = 0; j < 8; j++) {
+                    if (i != j) {
+                        EXPECT_EQ(topology->route(i, j).size(), basic_topology->route(i, j).size());
+                        auto route = topology->shared_route(i, j);
+                        topology->send(std::make_unique<Chunk>(chunk_size, std::move(route), callback, nullptr));
+                    }
+                }
+            }
+
+            while (!event_queue->finished()) {
+                event_queue->proceed();
+            }
+            simulation_times.push_back(event_queue->get_current_time());
+        }
+
+        /// test
+        EXPECT_EQ(simulation_times[0], simulation_times[1]);
+    }
+}
+
 TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
     /// setup
     const auto network_parser = NetworkParser("../../input/Ring.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
     const auto npus_count = topology->get_npus_count();
 
     /// message settings
@@ -132,3 +229,868 @@ TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
     const auto simulation_time = event_queue->get_current_time();
     EXPECT_EQ(simulation_time, 704'116);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRingPerEventQueueEngine) {
+    for (const auto engine_type : {EventQueueEngineType::BinaryHeap, EventQueueEngineType::QuaternaryHeap,
+                                   EventQueueEngineType::CalendarQueue, EventQueueEngineType::LadderQueue}) {
+        /// setup
+        event_queue = std::make_shared<EventQueue>(engine_type);
+        const auto network_parser = NetworkParser("../../input/Ring.yml");
+        const auto topology = construct_topology(network_parser);
+        topology->set_event_queue(event_queue);
+        const auto npus_count = topology->get_npus_count();
+
+        /// Run All-Gather
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i == j) {
+                    continue;
+                }
+
+                auto route = topology->route(i, j);
+                auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+                topology->send(std::move(chunk));
+            }
+        }
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        /// test
+        const auto simulation_time = event_queue->get_current_time();
+        EXPECT_EQ(simulation_time, 704'116);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventQueueEngineOrdering) {
+    // an event records (invoked time, event id) into the shared log
+    struct OrderingEvent {
+        EventQueue* event_queue;
+        std::vector<std::pair<EventTime, int>>* log;
+        EventTime event_time;
+        int event_id;
+    };
+
+    static const auto record = [](void* const arg) {
+        auto* const event = static_cast<OrderingEvent*>(arg);
+        event->log->emplace_back(event->event_queue->get_current_time(), event->event_id);
+    };
+
+    for (const auto engine_type : {EventQueueEngineType::BinaryHeap, EventQueueEngineType::QuaternaryHeap,
+                                   EventQueueEngineType::CalendarQueue, EventQueueEngineType::LadderQueue}) {
+        auto queue = EventQueue(engine_type);
+        auto log = std::vector<std::pair<EventTime, int>>();
+
+        // schedule clustered pseudo-random event times, with many ties
+        auto events = std::vector<OrderingEvent>();
+        auto seed = static_cast<uint64_t>(12345);
+        for (auto i = 0; i < 5'000; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const auto event_time = static_cast<EventTime>((seed >> 33) % 700) * ((i % 7 == 0) ? 1'000 : 3);
+            events.push_back({&queue, &log, event_time, i});
+        }
+        for (auto& event : events) {
+            queue.schedule_event(event.event_time, record, &event);
+        }
+
+        while (!queue.finished()) {
+            queue.proceed();
+        }
+
+        // every event is invoked at its time, in (time, scheduling order) order
+        ASSERT_EQ(log.size(), events.size());
+        for (auto i = 0; i < log.size(); i++) {
+            EXPECT_EQ(log[i].first, events[log[i].second].event_time);
+            if (i > 0) {
+                EXPECT_TRUE(log[i - 1] < log[i]);
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventQueueRecyclesEventSlots) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather twice on the same event queue
+    auto allocated_event_slots = std::vector<uint64_t>();
+    for (auto iteration = 0; iteration < 2; iteration++) {
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i == j) {
+                    continue;
+                }
+
+                auto route = topology->route(i, j);
+                auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+                topology->send(std::move(chunk));
+            }
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        allocated_event_slots.push_back(event_queue->get_allocated_event_slots_count());
+    }
+
+    /// test: the second run is served entirely from recycled event slots
+    EXPECT_GT(allocated_event_slots[0], 0);
+    EXPECT_EQ(allocated_event_slots[1], allocated_event_slots[0]);
+    EXPECT_GT(event_queue->get_scheduled_events_count(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ConcurrentSimulations) {
+    /// run independent All-Gather simulations, each with its own topology and event queue, in parallel threads
+    const auto simulations_count = 4;
+    auto simulation_times = std::vector<EventTime>(simulations_count, 0);
+    auto threads = std::vector<std::thread>();
+
+    for (auto simulation = 0; simulation < simulations_count; simulation++) {
+        threads.emplace_back([this, simulation, &simulation_times]() {
+            /// setup
+            const auto simulation_event_queue = std::make_shared<EventQueue>();
+            const auto network_parser = NetworkParser("../../input/Ring.yml");
+            const auto topology = construct_topology(network_parser);
+            topology->set_event_queue(simulation_event_queue);
+            const auto npus_count = topology->get_npus_count();
+
+            /// Run All-Gather
+            for (int i = 0; i < npus_count; i++) {
+                for (int j = 0; j < npus_count; j++) {
+                    if (i == j) {
+                        continue;
+                    }
+
+                    auto route = topology->route(i, j);
+                    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+                    topology->send(std::move(chunk));
+                }
+            }
+
+            /// Run simulation
+            while (!simulation_event_queue->finished()) {
+                simulation_event_queue->proceed();
+            }
+            simulation_times[simulation] = simulation_event_queue->get_current_time();
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    /// test
+    for (const auto simulation_time : simulation_times) {
+        EXPECT_EQ(simulation_time, 704'116);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkModeBusyUntil) {
+    // records the arrival time of a chunk
+    struct ArrivalRecord {
+        EventQueue* event_queue;
+        EventTime arrival_time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const record = static_cast<ArrivalRecord*>(arg);
+        record->arrival_time = record->event_queue->get_current_time();
+    };
+
+    for (const auto* const network : {"../../input/Ring.yml", "../../input/FullyConnected.yml",
+                                      "../../input/Switch.yml"}) {
+        auto arrival_times = std::map<LinkMode, std::vector<EventTime>>();
+        auto events_counts = std::map<LinkMode, uint64_t>();
+
+        for (const auto link_mode : {LinkMode::LinkFreeEvent, LinkMode::BusyUntil}) {
+            /// setup
+            event_queue = std::make_shared<EventQueue>();
+            const auto network_parser = NetworkParser(network);
+            const auto topology = construct_topology(network_parser);
+            topology->set_event_queue(event_queue);
+            topology->set_link_mode(link_mode);
+            const auto npus_count = topology->get_npus_count();
+
+            /// Run All-to-All with distinct chunk sizes, so that contending chunks have different timings
+            auto records = std::vector<ArrivalRecord>(npus_count * npus_count, ArrivalRecord{event_queue.get(), 0});
+            for (int i = 0; i < npus_count; i++) {
+                for (int j = 0; j < npus_count; j++) {
+                    if (i == j) {
+                        continue;
+                    }
+
+                    auto route = topology->route(i, j);
+                    const auto size = static_cast<ChunkSize>((i * npus_count + j + 1) * 1'024);
+                    auto chunk = std::make_unique<Chunk>(size, route, record_arrival, &records[i * npus_count + j]);
+                    topology->send(std::move(chunk));
+                }
+            }
+
+            /// Run simulation
+            while (!event_queue->finished()) {
+                event_queue->proceed();
+            }
+
+            for (const auto& record : records) {
+                arrival_times[link_mode].push_back(record.arrival_time);
+            }
+            events_counts[link_mode] = event_queue->get_scheduled_events_count();
+        }
+
+        /// test: every chunk arrives at exactly the same time, with fewer events
+        EXPECT_EQ(arrival_times[LinkMode::LinkFreeEvent], arrival_times[LinkMode::BusyUntil]);
+        EXPECT_LT(events_counts[LinkMode::BusyUntil], events_counts[LinkMode::LinkFreeEvent]);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkModeBusyUntilWithoutContention) {
+    for (const auto link_mode : {LinkMode::LinkFreeEvent, LinkMode::BusyUntil}) {
+        /// setup
+        event_queue = std::make_shared<EventQueue>();
+        const auto network_parser = NetworkParser("../../input/Ring.yml");
+        const auto topology = construct_topology(network_parser);
+        topology->set_event_queue(event_queue);
+        topology->set_link_mode(link_mode);
+        const auto npus_count = topology->get_npus_count();
+
+        /// every NPU sends a chunk to its right neighbor
+        for (int i = 0; i < npus_count; i++) {
+            auto route = topology->route(i, (i + 1) % npus_count);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        /// test: no chunk waits, so BusyUntil schedules no link-free event
+        EXPECT_EQ(event_queue->get_current_time(), 20'031);
+        const auto events_per_chunk = (link_mode == LinkMode::BusyUntil) ? 1 : 2;
+        EXPECT_EQ(event_queue->get_scheduled_events_count(), npus_count * events_per_chunk);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, PacketTrains) {
+    for (const auto link_mode : {LinkMode::LinkFreeEvent, LinkMode::BusyUntil}) {
+        /// a packet train over 3 hops pays its serialization (19'531.25 ns) once,
+        /// plus a 4 KiB packet (76.29 ns) on each of the first 2 hops
+        event_queue = std::make_shared<EventQueue>();
+        auto topology = construct_topology(NetworkParser("../../input/Ring.yml"));
+        topology->set_event_queue(event_queue);
+        topology->set_link_mode(link_mode);
+        topology->set_mtu(4'096);
+        topology->send(topology->create_chunk(chunk_size, topology->shared_route(1, 4), callback, nullptr));
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        EXPECT_EQ(event_queue->get_current_time(), 21'183);
+
+        // the train takes as many events per hop as a whole chunk
+        const auto events_per_hop = (link_mode == LinkMode::BusyUntil) ? 1 : 2;
+        EXPECT_EQ(event_queue->get_scheduled_events_count(), 3 * events_per_hop);
+
+        /// chunks no larger than the MTU are stored and forwarded, as without an MTU
+        event_queue = std::make_shared<EventQueue>();
+        topology = construct_topology(NetworkParser("../../input/Ring.yml"));
+        topology->set_event_queue(event_queue);
+        topology->set_link_mode(link_mode);
+        topology->set_mtu(chunk_size);
+        topology->send(topology->create_chunk(chunk_size, topology->shared_route(1, 4), callback, nullptr));
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        EXPECT_EQ(event_queue->get_current_time(), 60'093);
+
+        /// 0 -> 3 waits for 1 -> 3 on the link 1 -> 2, then follows it to 3
+        event_queue = std::make_shared<EventQueue>();
+        topology = construct_topology(NetworkParser("../../input/Ring.yml"));
+        topology->set_event_queue(event_queue);
+        topology->set_link_mode(link_mode);
+        topology->set_mtu(4'096);
+        auto arrival_times = std::vector<EventTime>(2, 0);
+        const auto record_arrival = [](void* const arg) {
+            auto* const arrival = static_cast<std::pair<EventQueue*, EventTime*>*>(arg);
+            *arrival->second = arrival->first->get_current_time();
+        };
+        auto far_arrival = std::pair<EventQueue*, EventTime*>(event_queue.get(), &arrival_times[0]);
+        auto near_arrival = std::pair<EventQueue*, EventTime*>(event_queue.get(), &arrival_times[1]);
+        topology->send(topology->create_chunk(chunk_size, topology->shared_route(0, 3), record_arrival, &far_arrival));
+        topology->send(topology->create_chunk(chunk_size, topology->shared_route(1, 3), record_arrival, &near_arrival));
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        EXPECT_EQ(arrival_times[1], 576 + 20'031);
+        EXPECT_EQ(arrival_times[0], 19'531 + 576 + 20'031);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkBatch) {
+    /// record the arrival time of every item
+    struct Arrivals {
+        EventQueue* event_queue;
+        std::vector<EventTime> times;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrivals = static_cast<Arrivals*>(arg);
+        arrivals->times.push_back(arrivals->event_queue->get_current_time());
+    };
+
+    for (const auto link_mode : {LinkMode::LinkFreeEvent, LinkMode::BusyUntil}) {
+        /// send 8 chunks of the same route back-to-back, one by one and as a batch
+        const auto items_count = 8;
+        auto arrivals_per_run = std::vector<Arrivals>();
+        auto events_count_per_run = std::vector<uint64_t>();
+        for (const auto batched : {false, true}) {
+            event_queue = std::make_shared<EventQueue>();
+            const auto topology = construct_topology(NetworkParser("../../input/Ring.yml"));
+            topology->set_event_queue(event_queue);
+            topology->set_link_mode(link_mode);
+
+            auto& arrivals = arrivals_per_run.emplace_back(Arrivals{event_queue.get(), {}});
+            const auto route = topology->shared_route(1, 4);
+            if (batched) {
+                topology->send(topology->create_chunk_batch(chunk_size, items_count, route, record_arrival, &arrivals));
+            } else {
+                for (auto item = 0; item < items_count; item++) {
+                    topology->send(topology->create_chunk(chunk_size, route, record_arrival, &arrivals));
+                }
+            }
+            while (!event_queue->finished()) {
+                event_queue->proceed();
+            }
+            events_count_per_run.push_back(event_queue->get_scheduled_events_count());
+        }
+
+        /// every item arrives when it would have as a chunk of its own
+        ASSERT_EQ(arrivals_per_run[0].times.size(), items_count);
+        EXPECT_EQ(arrivals_per_run[0].times, arrivals_per_run[1].times);
+        EXPECT_EQ(arrivals_per_run[1].times.front(), 60'093);
+        EXPECT_EQ(arrivals_per_run[1].times.back(), 60'093 + (7 * 19'531));
+
+        // the batch takes the events of a single chunk per hop, plus an arrival event per item
+        const auto events_per_hop = (link_mode == LinkMode::BusyUntil) ? 1 : 2;
+        EXPECT_EQ(events_count_per_run[1], (3 * events_per_hop) + (items_count - 1));
+        EXPECT_LT(events_count_per_run[1], events_count_per_run[0]);
+    }
+
+    /// over a slow link then a fast one, the items stay spaced by the slow link
+    const auto items_count = 4;
+    auto arrivals_per_run = std::vector<Arrivals>();
+    for (const auto batched : {false, true}) {
+        event_queue = std::make_shared<EventQueue>();
+        const auto topology = std::make_shared<MultiDimTopology>(
+            std::vector<TopologyBuildingBlock>{TopologyBuildingBlock::FullyConnected,
+                                               TopologyBuildingBlock::FullyConnected},
+            std::vector<int>{2, 2}, std::vector<Bandwidth>{10.0, 100.0}, std::vector<Latency>{500.0, 500.0});
+        topology->set_event_queue(event_queue);
+
+        auto& arrivals = arrivals_per_run.emplace_back(Arrivals{event_queue.get(), {}});
+        const auto route = topology->shared_route(0, 3);
+        ASSERT_EQ(route->links.size(), 2);
+        if (batched) {
+            topology->send(topology->create_chunk_batch(chunk_size, items_count, route, record_arrival, &arrivals));
+        } else {
+            for (auto item = 0; item < items_count; item++) {
+                topology->send(topology->create_chunk(chunk_size, route, record_arrival, &arrivals));
+            }
+        }
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+    }
+    EXPECT_EQ(arrivals_per_run[0].times, (std::vector<EventTime>{108'421, 206'077, 303'733, 401'389}));
+    EXPECT_EQ(arrivals_per_run[1].times, arrivals_per_run[0].times);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SharedRoute) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// shared route is cached, and matches the constructed route
+    const auto shared_route = topology->shared_route(1, 4);
+    EXPECT_EQ(topology->shared_route(1, 4), shared_route);
+    const auto route = topology->route(1, 4);
+    EXPECT_TRUE(std::equal(route.begin(), route.end(), shared_route->devices.begin(), shared_route->devices.end()));
+
+    /// Run All-Gather over shared routes
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            auto chunk = std::make_unique<Chunk>(chunk_size, topology->shared_route(i, j), callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 704'116);
+
+    /// the cache evicts the least recently requested routes beyond its capacity
+    EXPECT_EQ(topology->get_cached_routes_count(), npus_count * (npus_count - 1));
+    topology->set_route_cache_capacity(2);
+    EXPECT_EQ(topology->get_cached_routes_count(), 2);
+    const auto route_0_1 = topology->shared_route(0, 1);
+    const auto route_0_2 = topology->shared_route(0, 2);
+    EXPECT_EQ(topology->shared_route(0, 1), route_0_1);
+    EXPECT_NE(topology->shared_route(0, 3), nullptr);
+    EXPECT_EQ(topology->get_cached_routes_count(), 2);
+    EXPECT_EQ(topology->shared_route(0, 1), route_0_1);
+    EXPECT_NE(topology->shared_route(0, 2), route_0_2);
+
+    /// an evicted route stays valid, and is constructed again identically
+    EXPECT_EQ(topology->shared_route(1, 4)->devices, shared_route->devices);
+    EXPECT_EQ(topology->shared_route(1, 4)->links, shared_route->links);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FullyConnectedLazyLinks) {
+    /// every NPU sends a chunk to every other NPU, with eager and lazy links
+    auto simulation_times = std::vector<EventTime>();
+    for (const auto lazy_links : {false, true}) {
+        event_queue = std::make_shared<EventQueue>();
+        const auto topology = std::make_shared<FullyConnected>(16, 50.0, 500.0, lazy_links);
+        topology->set_event_queue(event_queue);
+
+        /// lazy links are instantiated on their first use only
+        EXPECT_EQ(topology->get_links_count(), lazy_links ? 0 : 16 * 15);
+
+        for (int i = 0; i < 16; i++) {
+            for (int j = 0; j < 16; j++) {
+                if (i != j) {
+                    auto route = topology->route(i, j);
+                    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+                    topology->send(std::move(chunk));
+                }
+            }
+        }
+        EXPECT_EQ(topology->get_links_count(), 16 * 15);
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        simulation_times.push_back(event_queue->get_current_time());
+    }
+
+    /// test
+    EXPECT_EQ(simulation_times[0], simulation_times[1]);
+
+    /// construct_topology instantiates every link upfront unless lazy links are requested
+    const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
+    const auto npus_count = network_parser.get_npus_counts_per_dim()[0];
+    EXPECT_EQ(construct_topology(network_parser)->get_links_count(), npus_count * (npus_count - 1));
+    EXPECT_EQ(construct_topology(network_parser, true)->get_links_count(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FullyConnectedLazyLinksAtScale) {
+    /// setup: 4096 NPUs, i.e., about 16.7M potential links
+    const auto topology = std::make_shared<FullyConnected>(4'096, 50.0, 500.0, true);
+    topology->set_event_queue(event_queue);
+
+    /// send chunks over 2 links only
+    topology->send(std::make_unique<Chunk>(chunk_size, topology->shared_route(1, 4), callback, nullptr));
+    topology->send(std::make_unique<Chunk>(chunk_size, topology->shared_route(4'000, 7), callback, nullptr));
+    EXPECT_EQ(topology->get_links_count(), 2);
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 20'031);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkPoolRecyclesChunks) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather 4 times over pooled chunks
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i == j) {
+                    continue;
+                }
+
+                auto chunk = topology->create_chunk(chunk_size, topology->shared_route(i, j), callback, nullptr);
+                topology->send(std::move(chunk));
+            }
+        }
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+    }
+
+    /// test: chunks of every round are recycled
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 4 * 704'116);
+    EXPECT_EQ(topology->get_allocated_chunk_slots_count(), 1'024);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkPoolConcurrentRelease) {
+    /// setup: storages are acquired by a single thread, and released by others
+    auto chunk_pool = ChunkPool();
+    chunk_pool.set_concurrent_release(true);
+    constexpr auto threads_count = 4;
+    constexpr auto storages_per_thread = 1'024;
+
+    /// each round, the threads release the storages of the previous round while new ones are acquired
+    auto released_storages = std::vector<std::vector<void*>>(threads_count);
+    for (int round = 0; round < 64; round++) {
+        auto threads = std::vector<std::thread>();
+        for (auto& storages : released_storages) {
+            threads.emplace_back([&storages]() {
+                for (auto* const storage : storages) {
+                    ChunkPool::release(storage);
+                }
+            });
+        }
+
+        auto acquired_storages = std::vector<std::vector<void*>>(threads_count);
+        for (auto& storages : acquired_storages) {
+            for (int i = 0; i < storages_per_thread; i++) {
+                storages.push_back(chunk_pool.acquire());
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        released_storages = std::move(acquired_storages);
+    }
+    for (const auto& storages : released_storages) {
+        for (auto* const storage : storages) {
+            ChunkPool::release(storage);
+        }
+    }
+
+    /// test: at most two rounds of storages are ever live, so released storages are reused
+    EXPECT_LE(chunk_pool.get_chunks_allocated_count(), 2 * threads_count * storages_per_thread);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelSimulation) {
+    // records the arrival time of a chunk
+    struct ArrivalRecord {
+        EventQueue* event_queue;
+        EventTime arrival_time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const record = static_cast<ArrivalRecord*>(arg);
+        record->arrival_time = record->event_queue->get_current_time();
+    };
+
+    // runs All-to-All sequentially (partitions_count=0) or in parallel, and returns the arrival time of each chunk
+    const auto run_all_to_all = [&](const char* const network, const int partitions_count, const bool distinct_sizes) {
+        /// setup
+        event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(NetworkParser(network));
+        auto parallel_simulation = std::unique_ptr<ParallelSimulation>();
+        if (partitions_count == 0) {
+            topology->set_event_queue(event_queue);
+        } else {
+            parallel_simulation = std::make_unique<ParallelSimulation>(topology, partitions_count);
+        }
+        const auto npus_count = topology->get_npus_count();
+
+        /// send the chunks in a random order
+        auto pairs = std::vector<std::pair<int, int>>();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    pairs.emplace_back(i, j);
+                }
+            }
+        }
+        std::shuffle(pairs.begin(), pairs.end(), std::mt19937(0));
+
+        auto records = std::vector<ArrivalRecord>();
+        records.reserve(pairs.size());
+        for (const auto& [src, dest] : pairs) {
+            auto* const dest_event_queue =
+                (partitions_count == 0) ? event_queue.get() : parallel_simulation->get_event_queue(dest).get();
+            records.push_back(ArrivalRecord{dest_event_queue, 0});
+
+            const auto distinct_size = static_cast<ChunkSize>((src * npus_count + dest + 1) * 1'024);
+            const auto size = distinct_sizes ? distinct_size : chunk_size;
+            auto route = topology->shared_route(src, dest);
+            topology->send(topology->create_chunk(size, std::move(route), record_arrival, &records.back()));
+        }
+
+        /// Run simulation
+        if (partitions_count == 0) {
+            while (!event_queue->finished()) {
+                event_queue->proceed();
+            }
+        } else {
+            parallel_simulation->run();
+        }
+
+        auto arrival_times = std::vector<EventTime>();
+        for (const auto& record : records) {
+            arrival_times.push_back(record.arrival_time);
+        }
+        if (partitions_count > 0) {
+            EXPECT_EQ(parallel_simulation->get_current_time(),
+                      *std::max_element(arrival_times.begin(), arrival_times.end()));
+        }
+        return arrival_times;
+    };
+
+    for (const auto* const network : {"../../input/Ring.yml", "../../input/FullyConnected.yml",
+                                      "../../input/Switch.yml", "../../input/Ring_FullyConnected_Switch.yml"}) {
+        for (const auto distinct_sizes : {false, true}) {
+            const auto sequential_arrival_times = run_all_to_all(network, 0, distinct_sizes);
+
+            /// test: every chunk arrives at exactly the same time, however the devices are partitioned
+            for (const auto partitions_count : {1, 2, 3, 8}) {
+                EXPECT_EQ(run_all_to_all(network, partitions_count, distinct_sizes), sequential_arrival_times);
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CollectiveEngine) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto run_collective = [&](const CollectiveType collective_type, const CollectiveAlgorithm algorithm,
+                                    const ChunkSize collective_size, const int chunks_count,
+                                    const int pipeline_depth) {
+        const auto topology = construct_topology(network_parser);
+        topology->set_event_queue(std::make_shared<EventQueue>());
+        auto collective_engine = CollectiveEngine(topology);
+        return collective_engine.run(collective_type, algorithm, collective_size, chunks_count, pipeline_depth);
+    };
+
+    /// Direct All-Gather sends every chunk at once, same as AllGatherOnRing
+    EXPECT_EQ(run_collective(CollectiveType::AllGather, CollectiveAlgorithm::Direct, 16 * chunk_size, 1, 1), 704'116);
+
+    /// Ring All-Reduce: 2 * 15 steps of a 64 KiB shard to the next NPU
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto collective_engine = CollectiveEngine(topology);
+    EXPECT_EQ(collective_engine.run(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size), 51'600);
+    EXPECT_EQ(collective_engine.get_sent_messages_count(), 2 * 15 * 16);
+
+    /// the engine can be reused
+    EXPECT_EQ(collective_engine.run(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size), 51'600);
+
+    /// pipelining overlaps the chunks
+    EXPECT_EQ(run_collective(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size, 8, 1), 156'480);
+    EXPECT_EQ(run_collective(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size, 8, 4), 39'576);
+
+    /// other algorithms
+    EXPECT_EQ(run_collective(CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, chunk_size, 1, 1), 25'800);
+    EXPECT_EQ(run_collective(CollectiveType::AllToAll, CollectiveAlgorithm::Ring, chunk_size, 1, 1), 153'977);
+    EXPECT_EQ(run_collective(CollectiveType::AllReduce, CollectiveAlgorithm::HalvingDoubling, chunk_size, 1, 1),
+              222'500);
+    EXPECT_EQ(run_collective(CollectiveType::AllReduce, CollectiveAlgorithm::BinaryTree, chunk_size, 1, 1), 717'616);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CollectiveSchedule) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto npus_count = 16;
+    const auto steps_count = 2 * (npus_count - 1);
+
+    /// Ring All-Reduce: each step sends a 64 KiB shard to the next NPU, after the previous NPU's last send arrived
+    const auto write_ring_all_reduce = [&](const std::string& schedule_path, const ScheduleFormat format) {
+        auto writer = CollectiveScheduleWriter(schedule_path, format);
+        auto send = ScheduledSend();
+        for (auto step = 0; step < steps_count; step++) {
+            for (auto npu = 0; npu < npus_count; npu++) {
+                send.step = step;
+                send.src = npu;
+                send.dest = (npu + 1) % npus_count;
+                send.size = chunk_size / npus_count;
+                send.dependencies.clear();
+                if (step > 0) {
+                    send.dependencies.push_back(((step - 1) * npus_count) + ((npu + npus_count - 1) % npus_count));
+                }
+                writer.write(send);
+            }
+        }
+        writer.close();
+    };
+
+    for (const auto format : {ScheduleFormat::Text, ScheduleFormat::Binary}) {
+        const auto schedule_path = std::string("collective_schedule.bin");
+        write_ring_all_reduce(schedule_path, format);
+        EXPECT_EQ(CollectiveScheduleReader(schedule_path).get_format(), format);
+
+        /// same as the ring All-Reduce of CollectiveEngine
+        const auto topology = construct_topology(network_parser);
+        topology->set_event_queue(std::make_shared<EventQueue>());
+        auto runner = CollectiveScheduleRunner(topology, 2);
+        EXPECT_EQ(runner.run(schedule_path), 51'600);
+        EXPECT_EQ(runner.get_sent_count(), steps_count * npus_count);
+
+        /// only 2 steps are loaded at once
+        EXPECT_EQ(runner.get_peak_loaded_sends_count(), 2 * npus_count);
+    }
+
+    /// hand-written text schedule: two sends at once, then a send after both arrive
+    {
+        auto output = std::ofstream("collective_schedule.txt");
+        output << "# step src dest size [dependency ...]\n"
+               << "0 0 1 1048576\n"
+               << "0 2 1 1048576\n"
+               << "\n"
+               << "1 1 3 1048576 0 1  # after both\n";
+    }
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto runner = CollectiveScheduleRunner(topology, 1);
+    /// a 1 MB send takes 20'031 ns per hop: 1 -> 3 takes 2 hops after 0 -> 1 and 2 -> 1 arrive at once
+    EXPECT_EQ(runner.run("collective_schedule.txt"), 20'031 + (2 * 20'031));
+
+    std::remove("collective_schedule.bin");
+    std::remove("collective_schedule.txt");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TraceReplay) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto trace_path = std::string("trace.bin");
+
+    /// two sends at once, then a 2-hop send later: a 1 MB send takes 20'031 ns per hop
+    {
+        auto writer = TraceWriter(trace_path);
+        writer.write({0, 0, 1, chunk_size});
+        writer.write({0, 2, 1, chunk_size});
+        writer.write({100'000, 1, 3, chunk_size});
+        writer.close();
+    }
+    auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto trace_replay = TraceReplay(topology);
+    auto report = trace_replay.run(trace_path);
+    EXPECT_EQ(report.sends_count, 3);
+    EXPECT_EQ(report.finish_time, 100'000 + (2 * 20'031));
+    EXPECT_EQ(report.max_send_delay, 2 * 20'031);
+    EXPECT_DOUBLE_EQ(report.mean_send_delay, (4 * 20'031) / 3.0);
+    EXPECT_EQ(report.peak_in_flight_sends_count, 2);
+    EXPECT_GT(report.peak_resident_memory_KB, 0);
+
+    /// a longer trace, whose pages are released every 4 KiB
+    const auto records_count = 100'000;
+    {
+        auto writer = TraceWriter(trace_path);
+        for (auto i = 0; i < records_count; i++) {
+            writer.write({static_cast<EventTime>(i / 4) * 1'000, static_cast<uint32_t>(i % 16),
+                          static_cast<uint32_t>((i + 1) % 16), 1'024});
+        }
+        writer.close();
+    }
+    topology = construct_topology(network_parser);
+    topology->set_event_queue(std::make_shared<EventQueue>());
+    trace_replay = TraceReplay(topology, 4'096);
+    report = trace_replay.run(trace_path);
+    EXPECT_EQ(report.sends_count, records_count);
+    EXPECT_EQ(report.finish_time, ((records_count / 4) - 1) * 1'000 + report.max_send_delay);
+    EXPECT_EQ(report.peak_in_flight_sends_count, 4);
+
+    std::remove(trace_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TimelineEngine) {
+    const auto trace_path = std::string("timeline.bin");
+    const auto records_count = 20'000;
+
+    for (const auto* const network_path : {"../../input/Ring.yml", "../../input/Ring_FullyConnected_Switch.yml"}) {
+        const auto network_parser = NetworkParser(network_path);
+
+        /// random bursts, with many sends injected at the same time and contending for the same links
+        auto topology = construct_topology(network_parser);
+        const auto npus_count = static_cast<uint32_t>(topology->get_npus_count());
+        auto random_engine = std::mt19937(42);
+        auto npu_distribution = std::uniform_int_distribution<uint32_t>(0, npus_count - 1);
+        auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 65'536);
+        auto gap_distribution = std::uniform_int_distribution<EventTime>(0, 3);
+        {
+            auto writer = TraceWriter(trace_path);
+            auto time = EventTime(0);
+            for (auto i = 0; i < records_count; i++) {
+                time += gap_distribution(random_engine) * 100;
+                const auto src = npu_distribution(random_engine);
+                auto dest = npu_distribution(random_engine);
+                dest = (dest == src) ? ((dest + 1) % npus_count) : dest;
+                writer.write({time, src, dest, size_distribution(random_engine)});
+            }
+            writer.close();
+        }
+
+        /// timeline without any event queue
+        auto timeline_arrival_times = std::vector<EventTime>(records_count);
+        auto timeline_engine = TimelineEngine(topology);
+        const auto timeline_report = timeline_engine.run(trace_path, timeline_arrival_times.data());
+
+        /// every send arrives at the same time as with the event-driven engine, in either link mode
+        for (const auto link_mode : {LinkMode::LinkFreeEvent, LinkMode::BusyUntil}) {
+            topology = construct_topology(network_parser);
+            topology->set_event_queue(std::make_shared<EventQueue>());
+            topology->set_link_mode(link_mode);
+            auto replay_arrival_times = std::vector<EventTime>(records_count);
+            auto trace_replay = TraceReplay(topology);
+            const auto replay_report = trace_replay.run(trace_path, replay_arrival_times.data());
+
+            EXPECT_EQ(timeline_arrival_times, replay_arrival_times);
+            EXPECT_EQ(timeline_report.sends_count, replay_report.sends_count);
+            EXPECT_EQ(timeline_report.finish_time, replay_report.finish_time);
+            EXPECT_EQ(timeline_report.max_send_delay, replay_report.max_send_delay);
+            EXPECT_EQ(timeline_report.mean_send_delay, replay_report.mean_send_delay);
+            EXPECT_EQ(timeline_report.peak_in_flight_sends_count, replay_report.peak_in_flight_sends_count);
+        }
+
+        /// the engine can be run again
+        const auto rerun_report = timeline_engine.run(trace_path);
+        EXPECT_EQ(rerun_report.finish_time, timeline_report.finish_time);
+    }
+
+    std::remove(trace_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SweepRunner) {
+    // sweep Ring sizes on the congestion aware backend
+    const auto sweep_config = YAML::Load(R"(
+network: Ring.yml
+backends: [ congestion_aware ]
+sweep:
+  npus_count: [ 4, 8, 16 ]
+)");
+    const auto sweep_spec = SweepSpec(sweep_config, "../../input");
+
+    // run sweep
+    auto sweep_runner = SweepRunner(sweep_spec, 3);
+    sweep_runner.register_backend(
+        "congestion_aware",
+        [](const NetworkParser& network_parser, const ChunkSize chunk_size) -> std::optional<EventTime> {
+            return simulate_all_to_all(network_parser, chunk_size);
+        });
+    const auto results = sweep_runner.run();
+
+    // check All-to-All time of each Ring size
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0].comm_time, 59'593);
+    EXPECT_EQ(results[1].comm_time, 196'310);
+    EXPECT_EQ(results[2].comm_time, 704'116);
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_fluid/FlowNetwork.h"
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionFluid;
+
+class TestNetworkAnalyticalCongestionFluid : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        // create event queue
+        event_queue = std::make_shared<EventQueue>();
+
+        // set flow size
+        flow_size = 1'048'576;  // 1 MB
+    }
+
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// record the arrival time of a flow
+    struct Arrival {
+        std::shared_ptr<EventQueue> event_queue;
+        EventTime time = 0;
+    };
+
+    static void callback(void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+    }
+
+    void run() {
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+    }
+
+    ChunkSize flow_size;
+};
+
+TEST_F(TestNetworkAnalyticalCongestionFluid, SingleFlow) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = NetworkAnalyticalCongestionAware::construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto flow_network = FlowNetwork(topology);
+
+    // stream a flow over 3 hops: pipelined, so the size is paid once and the latency per hop
+    auto arrival = Arrival{event_queue};
+    flow_network.send(1, 4, flow_size, callback, &arrival);
+    run();
+
+    /// compare
+    EXPECT_EQ(arrival.time, 19'532 + (3 * 500));
+    EXPECT_EQ(flow_network.get_active_flows_count(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionFluid, MaxMinFairSharing) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = NetworkAnalyticalCongestionAware::construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto flow_network = FlowNetwork(topology);
+
+    // 0 -> 2 and 1 -> 2 share the link 1 -> 2, 0 -> 15 is alone
+    auto long_arrival = Arrival{event_queue};
+    auto short_arrival = Arrival{event_queue};
+    auto disjoint_arrival = Arrival{event_queue};
+    flow_network.send(0, 2, 2 * flow_size, callback, &long_arrival);
+    flow_network.send(1, 2, flow_size, callback, &short_arrival);
+    flow_network.send(0, 15, flow_size, callback, &disjoint_arrival);
+    run();
+
+    /// compare
+    // the shared link is split in half until the short flow finishes, then the long flow gets all of it
+    EXPECT_EQ(short_arrival.time, 39'063 + 500);
+    EXPECT_NEAR(static_cast<double>(long_arrival.time), 39'063 + 19'531 + (2 * 500), 1);
+    EXPECT_EQ(disjoint_arrival.time, 19'532 + 500);
+
+    // the flows started together, so the rates have been computed once for them, then once per finishing flow
+    EXPECT_EQ(flow_network.get_recomputations_count(), 4);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionFluid, FlowsStartingLater) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = NetworkAnalyticalCongestionAware::construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto flow_network = FlowNetwork(topology);
+
+    // a second flow joins the link halfway through the first one
+    auto first_arrival = Arrival{event_queue};
+    auto second_arrival = Arrival{event_queue};
+    flow_network.send(3, 4, flow_size, callback, &first_arrival);
+    auto late_send = std::pair<FlowNetwork*, Arrival*>(&flow_network, &second_arrival);
+    event_queue->schedule_event(
+        9'766,
+        [](void* const arg) {
+            auto* const late_send = static_cast<std::pair<FlowNetwork*, Arrival*>*>(arg);
+            late_send->first->send(3, 4, 1'048'576, callback, late_send->second);
+        },
+        &late_send);
+    run();
+
+    /// compare
+    // the first flow streams half of its bytes alone, then the rest at half the rate
+    EXPECT_NEAR(static_cast<double>(first_arrival.time), 9'766 + 19'531 + 500, 2);
+    EXPECT_NEAR(static_cast<double>(second_arrival.time), 9'766 + 19'531 + 9'766 + 500, 2);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionFluid, AllToAll) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = NetworkAnalyticalCongestionAware::construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    auto flow_network = FlowNetwork(topology);
+    const auto npus_count = topology->get_npus_count();
+
+    // every NPU streams a flow to every other NPU
+    auto arrivals = std::vector<Arrival>(npus_count * npus_count, Arrival{event_queue});
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                flow_network.send(src, dest, flow_size, callback, &arrivals[(src * npus_count) + dest]);
+            }
+        }
+    }
+    run();
+
+    /// compare
+    // by symmetry, the flows of the same distance arrive together, and the farthest last
+    for (auto src = 0; src < npus_count; src++) {
+        EXPECT_EQ(arrivals[(src * npus_count) + ((src + 1) % npus_count)].time, arrivals[1].time);
+        EXPECT_EQ(arrivals[(src * npus_count) + ((src + 8) % npus_count)].time, arrivals[8].time);
+    }
+    EXPECT_LT(arrivals[1].time, arrivals[8].time);
+    EXPECT_EQ(event_queue->get_current_time(), arrivals[8].time);
+
+    // rates are recomputed per distinct finish time, not per flow or hop
+    EXPECT_LE(flow_network.get_recomputations_count(), npus_count);
+}
@@ -3,10 +3,25 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/FastDivisor.h"
 #include "common/NetworkParser.h"
+#include "common/SweepRunner.h"
+#include "common/SweepSpec.h"
 #include "common/Type.h"
+#include "congestion_unaware/AllPairsMatrix.h"
+#include "congestion_unaware/CollectiveCostModel.h"
+#include "congestion_unaware/FullyConnected.h"
 #include "congestion_unaware/Helper.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include "congestion_unaware/PhaseContentionModel.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/StaticMultiDimTopology.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <limits>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
@@ -68,3 +83,336 @@ TEST_F(TestNetworkAnalyticalCongestionUnaware, Ring_FullyConnected_Switch) {
     const auto comm_delay_dim3 = topology->send(26, 42, chunk_size);
     EXPECT_EQ(comm_delay_dim3, 23'531);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SendBatch) {
+    // basic and multi-dimensional topologies, including a unidirectional ring
+    auto topologies = std::vector<std::shared_ptr<Topology>>();
+    for (const auto* const network : {"Ring", "FullyConnected", "Switch", "Ring_FullyConnected_Switch"}) {
+        const auto network_parser = NetworkParser(std::string("../../input/") + network + ".yml");
+        topologies.push_back(construct_topology(network_parser));
+    }
+    topologies.push_back(std::make_shared<Ring>(8, 50, 500, false));
+
+    for (const auto& topology : topologies) {
+        // every pair of distinct NPUs, with varying chunk sizes
+        const auto npus_count = topology->get_npus_count();
+        auto srcs = std::vector<DeviceId>();
+        auto dests = std::vector<DeviceId>();
+        auto chunk_sizes = std::vector<ChunkSize>();
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    srcs.push_back(src);
+                    dests.push_back(dest);
+                    chunk_sizes.push_back(chunk_size + (src * npus_count) + dest);
+                }
+            }
+        }
+
+        // batched sends should match individual sends
+        auto comm_delays = std::vector<EventTime>(srcs.size());
+        topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), comm_delays.data(), srcs.size());
+        for (auto i = static_cast<size_t>(0); i < srcs.size(); i++) {
+            EXPECT_EQ(comm_delays[i], topology->send(srcs[i], dests[i], chunk_sizes[i]));
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, FastDivisor) {
+    // small divisors, powers of 2 and their neighbors, and the largest ones
+    auto divisors = std::vector<int>();
+    for (auto divisor = 1; divisor <= 1'000; divisor++) {
+        divisors.push_back(divisor);
+    }
+    for (auto bit = 10; bit < 31; bit++) {
+        divisors.push_back((1 << bit) - 1);
+        divisors.push_back(1 << bit);
+        divisors.push_back((1 << bit) + 1);
+    }
+    divisors.push_back(std::numeric_limits<int>::max());
+
+    for (const auto divisor : divisors) {
+        const auto fast_divisor = FastDivisor(divisor);
+
+        // dividends around the multiples of the divisor, and the largest ones
+        auto dividends = std::vector<int>{std::numeric_limits<int>::max(), std::numeric_limits<int>::max() - 1};
+        for (auto multiple = 0; multiple <= 4; multiple++) {
+            const auto base = static_cast<int64_t>(divisor) * multiple;
+            for (auto offset = -1; offset <= 1; offset++) {
+                if (base + offset >= 0 && base + offset <= std::numeric_limits<int>::max()) {
+                    dividends.push_back(static_cast<int>(base + offset));
+                }
+            }
+        }
+
+        for (const auto dividend : dividends) {
+            EXPECT_EQ(fast_divisor.divide(dividend), dividend / divisor);
+            EXPECT_EQ(fast_divisor.remainder(dividend), dividend % divisor);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, MultiDimAddress) {
+    // create network: [2, 8, 4]
+    auto topology = MultiDimTopology();
+    topology.append_dimension(std::make_unique<Ring>(2, 50, 500));
+    topology.append_dimension(std::make_unique<Ring>(8, 50, 500));
+    topology.append_dimension(std::make_unique<Ring>(4, 50, 500));
+
+    // 47 = 1 + (7 * 2) + (2 * 16)
+    const auto address = topology.translate_address(47);
+    EXPECT_EQ(address[0], 1);
+    EXPECT_EQ(address[1], 7);
+    EXPECT_EQ(address[2], 2);
+
+    // every address translates back to its NPU
+    for (auto npu = 0; npu < topology.get_npus_count(); npu++) {
+        const auto npu_address = topology.translate_address(npu);
+        EXPECT_EQ(npu_address[0] + (2 * npu_address[1]) + (16 * npu_address[2]), npu);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, StaticMultiDimTopology) {
+    // explicitly instantiated, same as Ring_FullyConnected_Switch.yml
+    const auto static_topology =
+        StaticMultiDimTopology<Ring, FullyConnected, Switch>({2, 8, 4}, {200, 100, 50}, {50, 500, 2'000});
+    EXPECT_EQ(static_topology.get_npus_count(), 64);
+    EXPECT_EQ(static_topology.send(26, 42, chunk_size), 23'531);
+
+    for (const auto* const network : {"Ring", "FullyConnected", "Switch", "Ring_FullyConnected_Switch"}) {
+        const auto network_parser = NetworkParser(std::string("../../input/") + network + ".yml");
+        const auto topology = construct_topology(network_parser);
+
+        // the matching instantiation should send exactly like the dynamic topology
+        const auto visited = visit_static_topology(network_parser, [&](const auto& static_topology) {
+            const auto npus_count = static_topology.get_npus_count();
+            EXPECT_EQ(npus_count, topology->get_npus_count());
+
+            for (auto src = 0; src < npus_count; src++) {
+                for (auto dest = 0; dest < npus_count; dest++) {
+                    if (src != dest) {
+                        const auto size = chunk_size + (src * npus_count) + dest;
+                        EXPECT_EQ(static_topology.send(src, dest, size), topology->send(src, dest, size));
+                    }
+                }
+            }
+        });
+        EXPECT_TRUE(visited);
+        EXPECT_NE(construct_static_topology(network_parser), nullptr);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, AllPairsMatrix) {
+    const auto output_path = std::string("all_pairs_matrix.bin");
+
+    for (const auto* const network : {"Ring", "Switch", "Ring_FullyConnected_Switch"}) {
+        const auto network_parser = NetworkParser(std::string("../../input/") + network + ".yml");
+        const auto topology = construct_topology(network_parser);
+        const auto npus_count = topology->get_npus_count();
+
+        // write the matrices
+        write_all_pairs_matrix(*topology, chunk_size, output_path, 2);
+
+        // read them back
+        auto input = std::ifstream(output_path, std::ios::binary);
+        ASSERT_TRUE(input.is_open());
+        auto header = AllPairsMatrixHeader();
+        input.read(reinterpret_cast<char*>(&header), sizeof(header));
+        EXPECT_EQ(std::memcmp(header.magic, all_pairs_matrix_magic, sizeof(header.magic)), 0);
+        EXPECT_EQ(header.version, all_pairs_matrix_version);
+        EXPECT_EQ(header.npus_count, npus_count);
+        EXPECT_EQ(header.chunk_size, chunk_size);
+        EXPECT_EQ(header.comm_delays_offset % 64, 0);
+
+        auto hops_counts = std::vector<uint32_t>(npus_count * npus_count);
+        auto comm_delays = std::vector<EventTime>(npus_count * npus_count);
+        input.seekg(static_cast<std::streamoff>(header.hops_counts_offset));
+        input.read(reinterpret_cast<char*>(hops_counts.data()), hops_counts.size() * sizeof(uint32_t));
+        input.seekg(static_cast<std::streamoff>(header.comm_delays_offset));
+        input.read(reinterpret_cast<char*>(comm_delays.data()), comm_delays.size() * sizeof(EventTime));
+        ASSERT_TRUE(input.good());
+
+        // every entry should match the individual sends
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                const auto entry = (src * npus_count) + dest;
+                if (src == dest) {
+                    EXPECT_EQ(hops_counts[entry], 0);
+                    EXPECT_EQ(comm_delays[entry], 0);
+                } else {
+                    EXPECT_EQ(hops_counts[entry], topology->get_hops_count(src, dest));
+                    EXPECT_EQ(comm_delays[entry], topology->send(src, dest, chunk_size));
+                }
+            }
+        }
+    }
+    std::remove(output_path.c_str());
+
+    // hops count of the Ring: 1 -> 2 -> 3 -> 4
+    const auto ring = construct_topology(NetworkParser("../../input/Ring.yml"));
+    EXPECT_EQ(ring->get_hops_count(1, 4), 3);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, CollectiveCostModel) {
+    // Ring(16), 50 GB/s, 500 ns: a 64 KiB shard takes 1'220.703125 ns to serialize
+    const auto ring = CollectiveCostModel(NetworkParser("../../input/Ring.yml"));
+
+    // Ring: 2 * 15 steps of (500 + 1'220.703125)
+    EXPECT_EQ(ring.get_collective_time(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size), 51'621);
+    EXPECT_EQ(ring.get_collective_time(CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, chunk_size), 25'810);
+
+    // Ring All-to-All: 15 * 500 + (15 * 16 / 2) shards
+    EXPECT_EQ(ring.get_collective_time(CollectiveType::AllToAll, CollectiveAlgorithm::Ring, chunk_size), 153'984);
+
+    // Direct: a single step to the farthest NPU, 8 hops away
+    EXPECT_EQ(ring.get_collective_time(CollectiveType::AllGather, CollectiveAlgorithm::Direct, chunk_size), 5'220);
+
+    // HalvingDoubling: (1 + 2 + 4 + 8) hops, and 15 shards, same as Ring on a ring
+    EXPECT_EQ(ring.get_collective_time(CollectiveType::AllReduce, CollectiveAlgorithm::HalvingDoubling, chunk_size),
+              51'621);
+
+    // Ring_FullyConnected_Switch: All-Reduce of 1 MB, 512 KB, and 64 KB on each dimension
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto multi_dim = CollectiveCostModel(network_parser);
+    EXPECT_EQ(multi_dim.get_dims_count(), 3);
+    EXPECT_EQ(multi_dim.get_dim_collective_time(0, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size),
+              4'982);
+    EXPECT_EQ(multi_dim.get_collective_time(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size), 46'358);
+
+    // the model of a topology is the same as the model of its config
+    const auto topology = std::static_pointer_cast<MultiDimTopology>(construct_topology(network_parser));
+    const auto algorithm_per_dim = std::vector<CollectiveAlgorithm>{
+        CollectiveAlgorithm::Ring, CollectiveAlgorithm::Direct, CollectiveAlgorithm::HalvingDoubling};
+    EXPECT_EQ(CollectiveCostModel(*topology).get_collective_time(CollectiveType::AllGather, algorithm_per_dim,
+                                                                 chunk_size),
+              multi_dim.get_collective_time(CollectiveType::AllGather, algorithm_per_dim, chunk_size));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, PhaseContentionModel) {
+    // Ring(16), 50 GB/s, 500 ns: a 1 MB transfer takes 19'531.25 ns to serialize
+    auto ring = PhaseContentionModel(NetworkParser("../../input/Ring.yml"));
+    auto comm_delays = std::vector<EventTime>(240);
+
+    // a transfer alone takes as long as Topology::send
+    const auto single_src = std::vector<DeviceId>{1};
+    const auto single_dest = std::vector<DeviceId>{4};
+    const auto single_size = std::vector<ChunkSize>{chunk_size};
+    EXPECT_EQ(ring.estimate_phase(single_src.data(), single_dest.data(), single_size.data(), comm_delays.data(), 1),
+              21'031);
+
+    // 0 -> 2 and 1 -> 2 share the link 1 -> 2, where the small transfer gets its fair share
+    const auto srcs = std::vector<DeviceId>{0, 1};
+    const auto dests = std::vector<DeviceId>{2, 2};
+    const auto sizes = std::vector<ChunkSize>{chunk_size, chunk_size / 4};
+    EXPECT_EQ(ring.estimate_phase(srcs.data(), dests.data(), sizes.data(), comm_delays.data(), 2), 25'414);
+    EXPECT_EQ(comm_delays[0], 1'000 + 24'414);
+    EXPECT_EQ(comm_delays[1], 500 + 9'765);
+
+    // All-to-All: each clockwise link carries 1 + 2 + ... + 8 transfers (ties go clockwise),
+    // the same as the max-min fair flows of congestion_fluid
+    auto all_srcs = std::vector<DeviceId>();
+    auto all_dests = std::vector<DeviceId>();
+    for (auto src = 0; src < 16; src++) {
+        for (auto dest = 0; dest < 16; dest++) {
+            if (src != dest) {
+                all_srcs.push_back(src);
+                all_dests.push_back(dest);
+            }
+        }
+    }
+    const auto all_sizes = std::vector<ChunkSize>(all_srcs.size(), chunk_size);
+    EXPECT_EQ(ring.estimate_phase(all_srcs.data(), all_dests.data(), all_sizes.data(), comm_delays.data(), 240),
+              (8 * 500) + 703'125);
+
+    // the load of a phase doesn't leak into the next one
+    EXPECT_EQ(ring.estimate_phase(single_src.data(), single_dest.data(), single_size.data(), comm_delays.data(), 1),
+              21'031);
+
+    // FullyConnected: every pair has a dedicated link, so All-to-All has no contention
+    auto fully_connected = PhaseContentionModel(NetworkParser("../../input/FullyConnected.yml"));
+    EXPECT_EQ(fully_connected.estimate_phase(all_srcs.data(), all_dests.data(), all_sizes.data(), comm_delays.data(),
+                                             240),
+              20'031);
+    EXPECT_EQ(fully_connected.get_links_count(), 0);
+
+    // FullyConnected links are only held while a phase loads them, however many NPUs there are:
+    // 8'191 -> 0 carries 2 transfers, 1 -> 0 a single one
+    auto large_fully_connected = PhaseContentionModel(FullyConnected(8'192, 50.0, 500.0));
+    const auto shared_link_srcs = std::vector<DeviceId>{1, 8'191, 8'191};
+    const auto shared_link_dests = std::vector<DeviceId>{0, 0, 0};
+    const auto shared_link_sizes = std::vector<ChunkSize>(3, chunk_size);
+    EXPECT_EQ(large_fully_connected.estimate_phase(shared_link_srcs.data(), shared_link_dests.data(),
+                                                   shared_link_sizes.data(), comm_delays.data(), 3),
+              500 + 39'062);
+    EXPECT_EQ(comm_delays[0], 500 + 19'531);
+    EXPECT_EQ(large_fully_connected.get_links_count(), 0);
+
+    // Switch: an incast of 3 transfers shares the downlink port of the dest
+    auto switch_model = PhaseContentionModel(NetworkParser("../../input/Switch.yml"));
+    const auto incast_srcs = std::vector<DeviceId>{1, 2, 3};
+    const auto incast_dests = std::vector<DeviceId>{0, 0, 0};
+    const auto incast_sizes = std::vector<ChunkSize>(3, chunk_size);
+    EXPECT_EQ(switch_model.estimate_phase(incast_srcs.data(), incast_dests.data(), incast_sizes.data(),
+                                          comm_delays.data(), 3),
+              1'000 + 58'593);
+
+    // multi-dimensional: without contention, the same as Topology::send
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    auto multi_dim = PhaseContentionModel(network_parser);
+    for (auto src = 0; src < topology->get_npus_count(); src += 5) {
+        for (auto dest = 0; dest < topology->get_npus_count(); dest += 3) {
+            if (src != dest) {
+                EXPECT_EQ(multi_dim.estimate_phase(&src, &dest, &chunk_size, comm_delays.data(), 1),
+                          topology->send(src, dest, chunk_size));
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SweepSpecExpansion) {
+    // sweep 3 NPU counts and 2 bandwidths over Ring
+    const auto sweep_config = YAML::Load(R"(
+network: Ring.yml
+sweep:
+  npus_count: [ 4, 8, 16 ]
+  bandwidth[0]: [ 25.0, 50.0 ]
+)");
+    const auto sweep_spec = SweepSpec(sweep_config, "../../input");
+    EXPECT_EQ(sweep_spec.get_points_count(), 6);
+
+    // last axis varies fastest, and unswept keys keep the base value
+    const auto network_config = sweep_spec.get_point_config(3);
+    EXPECT_EQ(network_config.at("npus_count"), std::vector<std::string>({"8"}));
+    EXPECT_EQ(network_config.at("bandwidth"), std::vector<std::string>({"50.0"}));
+    EXPECT_EQ(network_config.at("topology"), std::vector<std::string>({"Ring"}));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SweepRunner) {
+    // sweep Ring sizes on the congestion unaware backend
+    const auto sweep_config = YAML::Load(R"(
+network: Ring.yml
+backends: [ congestion_unaware ]
+sweep:
+  npus_count: [ 4, 8, 16, 32 ]
+)");
+    const auto sweep_spec = SweepSpec(sweep_config, "../../input");
+
+    // run sweep
+    auto sweep_runner = SweepRunner(sweep_spec, 4);
+    sweep_runner.register_backend(
+        "congestion_unaware",
+        [](const NetworkParser& network_parser, const ChunkSize chunk_size) -> std::optional<EventTime> {
+            return simulate_all_to_all(network_parser, chunk_size);
+        });
+    const auto results = sweep_runner.run();
+
+    // every point should match the sequential evaluation
+    ASSERT_EQ(results.size(), 4);
+    for (const auto& result : results) {
+        const auto network_parser = NetworkParser(SweepSpec::to_yaml(result.network_config));
+        const auto comm_time = simulate_all_to_all(network_parser, chunk_size);
+        ASSERT_TRUE(result.comm_time.has_value());
+        EXPECT_EQ(result.comm_time.value(), comm_time);
+    }
+}
@@ -23,6 +23,11 @@ printf "\tFormatting congestion_aware:\n"
 find "$TARGET_DIR/congestion_aware" \( -name "*.cpp" -o -name "*.h" \) -exec \
     clang-format -style=file -i {} \;
 
+# run clang-format for `congestion_fluid`
+printf "\tFormatting congestion_fluid:\n"
+find "$TARGET_DIR/congestion_fluid" \( -name "*.cpp" -o -name "*.h" \) -exec \
+    clang-format -style=file -i {} \;
+
 # run clang-format for `congestion_unaware`
 printf "\tFormatting congestion_unaware:\n"
 find "$TARGET_DIR/congestion_unaware" \( -name "*.cpp" -o -name "*.h" \) -exec \